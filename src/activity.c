@@ -10,6 +10,7 @@
 
 #include "config.h"
 #include "activity.h"
+#include "app-info-registry.h"
 #include "shell.h"
 #include "thumbnail.h"
 #include "util.h"
@@ -85,9 +86,7 @@ phosh_activity_set_property (GObject *object,
 
   switch (property_id) {
     case PROP_APP_ID:
-      g_free (priv->app_id);
-      priv->app_id = g_value_dup_string (value);
-      g_object_notify_by_pspec (G_OBJECT (self), props[PROP_APP_ID]);
+      phosh_activity_set_app_id (self, g_value_get_string (value));
       break;
     case PROP_TITLE:
       phosh_activity_set_title (self, g_value_get_string (value));
@@ -212,26 +211,22 @@ draw_cb (PhoshActivity *self, cairo_t *cairo, GtkDrawingArea *area)
 
 
 static void
-phosh_activity_constructed (GObject *object)
+update_app_info (PhoshActivity *self)
 {
-  PhoshActivity *self = PHOSH_ACTIVITY (object);
   PhoshActivityPrivate *priv = phosh_activity_get_instance_private (self);
-  g_autofree char *desktop_id = NULL;
-
-  desktop_id = g_strdup_printf ("%s.desktop", priv->app_id);
-  g_return_if_fail (desktop_id);
-  priv->info = g_desktop_app_info_new (desktop_id);
-
-  if (!priv->info) {
-    g_autofree char *name = phosh_fix_app_id (priv->app_id);
-    g_return_if_fail (name);
-    g_free (desktop_id);
-    desktop_id = g_strdup_printf ("%s.desktop", name);
-    g_return_if_fail (desktop_id);
-    g_debug ("%s has broken app_id, should be %s", priv->app_id, desktop_id);
-    priv->info = g_desktop_app_info_new (desktop_id);
+
+  g_clear_object (&priv->info);
+
+  if (priv->app_id == NULL) {
+    gtk_image_set_from_icon_name (GTK_IMAGE (priv->icon),
+                                  PHOSH_APP_UNKNOWN_ICON,
+                                  ACTIVITY_ICON_SIZE);
+    return;
   }
 
+  priv->info = phosh_app_info_registry_lookup_app_id (phosh_app_info_registry_get_default (),
+                                                      priv->app_id);
+
   if (priv->info) {
     gtk_image_set_from_gicon (GTK_IMAGE (priv->icon),
                               g_app_info_get_icon (G_APP_INFO (priv->info)),
@@ -241,6 +236,14 @@ phosh_activity_constructed (GObject *object)
                                   PHOSH_APP_UNKNOWN_ICON,
                                   ACTIVITY_ICON_SIZE);
   }
+}
+
+
+static void
+phosh_activity_constructed (GObject *object)
+{
+  PhoshActivity *self = PHOSH_ACTIVITY (object);
+  PhoshActivityPrivate *priv = phosh_activity_get_instance_private (self);
 
   gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (self)), "phosh-activity-empty");
 
@@ -382,7 +385,7 @@ phosh_activity_class_init (PhoshActivityClass *klass)
       "app-id",
       "The application id",
       "",
-      G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE |
+      G_PARAM_READWRITE |
       G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
 
   props[PROP_TITLE] =
@@ -463,6 +466,32 @@ phosh_activity_new (const char *app_id,
 }
 
 
+/**
+ * phosh_activity_set_app_id:
+ * @self: The #PhoshActivity
+ * @app_id: The application id
+ *
+ * Sets the app id and looks up the app's icon. This allows to reuse
+ * an activity for a different toplevel.
+ */
+void
+phosh_activity_set_app_id (PhoshActivity *self, const char *app_id)
+{
+  PhoshActivityPrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_ACTIVITY (self));
+  priv = phosh_activity_get_instance_private (self);
+
+  if (priv->app_id && !g_strcmp0 (priv->app_id, app_id))
+    return;
+
+  g_free (priv->app_id);
+  priv->app_id = g_strdup (app_id);
+  update_app_info (self);
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_APP_ID]);
+}
+
+
 const char *
 phosh_activity_get_app_id (PhoshActivity *self)
 {
@@ -518,6 +547,12 @@ phosh_activity_set_thumbnail (PhoshActivity *self, PhoshThumbnail *thumbnail)
   g_clear_pointer (&priv->surface, cairo_surface_destroy);
   g_clear_object (&priv->thumbnail);
 
+  if (thumbnail == NULL) {
+    gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (self)), "phosh-activity-empty");
+    gtk_widget_queue_draw (GTK_WIDGET (self));
+    return;
+  }
+
   data = phosh_thumbnail_get_image (thumbnail);
   phosh_thumbnail_get_size (thumbnail, &width, &height, &stride);
 
@@ -14,6 +14,8 @@ G_DECLARE_FINAL_TYPE (PhoshActivity, phosh_activity, PHOSH, ACTIVITY, GtkButton)
 
 GtkWidget  *phosh_activity_new        (const char *app_id,
                                        const char *title);
+void        phosh_activity_set_app_id (PhoshActivity   *self,
+                                       const char      *app_id);
 const char *phosh_activity_get_app_id (PhoshActivity   *self);
 const char *phosh_activity_get_title  (PhoshActivity   *self);
 void        phosh_activity_set_title  (PhoshActivity   *self,
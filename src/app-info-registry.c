@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-app-info-registry"
+
+#include "config.h"
+
+#include "app-info-registry.h"
+#include "util.h"
+
+#define MAX_CACHED_MISSES 64
+
+/**
+ * SECTION:app-info-registry
+ * @short_description: Shell wide cache of desktop file lookups
+ * @Title: PhoshAppInfoRegistry
+ *
+ * Looking up a #GDesktopAppInfo by its desktop id searches the data
+ * dirs and parses the desktop file on every call. Activities,
+ * notifications and favorites all need the same handful of apps
+ * over and over. #PhoshAppInfoRegistry caches the results by
+ * desktop id. Failed lookups are cached as well so e.g. notifications
+ * from apps without a desktop file don't hit the file system each
+ * time. The number of cached misses is bounded as notifications can
+ * carry arbitrary desktop entry hints.
+ *
+ * The #PhoshAppListModel feeds all installed apps into the registry
+ * when it refreshes its list. The cache is dropped whenever
+ * #GAppInfoMonitor reports a change.
+ */
+
+struct _PhoshAppInfoRegistry {
+  GObject          parent;
+
+  /* desktop id -> GDesktopAppInfo or NULL if there's none */
+  GHashTable      *infos;
+  guint            n_misses;
+  GAppInfoMonitor *monitor;
+};
+G_DEFINE_TYPE (PhoshAppInfoRegistry, phosh_app_info_registry, G_TYPE_OBJECT)
+
+
+static void
+info_free (GDesktopAppInfo *info)
+{
+  /* Cached misses are NULL */
+  if (info)
+    g_object_unref (info);
+}
+
+
+static void
+on_app_info_changed (PhoshAppInfoRegistry *self)
+{
+  g_debug ("Apps changed, dropping %u cached entries", g_hash_table_size (self->infos));
+  g_hash_table_remove_all (self->infos);
+  self->n_misses = 0;
+}
+
+
+static gboolean
+is_miss (gpointer key, gpointer value, gpointer user_data)
+{
+  return value == NULL;
+}
+
+
+static void
+add_miss (PhoshAppInfoRegistry *self, const char *desktop_id)
+{
+  if (self->n_misses >= MAX_CACHED_MISSES) {
+    g_debug ("Dropping %u cached misses", self->n_misses);
+    g_hash_table_foreach_remove (self->infos, is_miss, NULL);
+    self->n_misses = 0;
+  }
+
+  g_hash_table_insert (self->infos, g_strdup (desktop_id), NULL);
+  self->n_misses++;
+}
+
+
+static void
+phosh_app_info_registry_dispose (GObject *object)
+{
+  PhoshAppInfoRegistry *self = PHOSH_APP_INFO_REGISTRY (object);
+
+  if (self->monitor)
+    g_signal_handlers_disconnect_by_data (self->monitor, self);
+  g_clear_object (&self->monitor);
+  g_clear_pointer (&self->infos, g_hash_table_destroy);
+
+  G_OBJECT_CLASS (phosh_app_info_registry_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_app_info_registry_class_init (PhoshAppInfoRegistryClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = phosh_app_info_registry_dispose;
+}
+
+
+static void
+phosh_app_info_registry_init (PhoshAppInfoRegistry *self)
+{
+  self->infos = g_hash_table_new_full (g_str_hash,
+                                       g_str_equal,
+                                       g_free,
+                                       (GDestroyNotify) info_free);
+  self->monitor = g_app_info_monitor_get ();
+  g_signal_connect_swapped (self->monitor, "changed", G_CALLBACK (on_app_info_changed), self);
+}
+
+/**
+ * phosh_app_info_registry_get_default:
+ *
+ * Returns: (transfer none): The app info registry singleton
+ */
+PhoshAppInfoRegistry *
+phosh_app_info_registry_get_default (void)
+{
+  static PhoshAppInfoRegistry *instance;
+
+  if (instance == NULL) {
+    instance = g_object_new (PHOSH_TYPE_APP_INFO_REGISTRY, NULL);
+    g_object_add_weak_pointer (G_OBJECT (instance), (gpointer *) &instance);
+  }
+
+  return instance;
+}
+
+/**
+ * phosh_app_info_registry_lookup:
+ * @self: The #PhoshAppInfoRegistry
+ * @desktop_id: The desktop id (including the .desktop suffix)
+ *
+ * Looks up the app info for @desktop_id like g_desktop_app_info_new()
+ * but only hits the file system on the first lookup.
+ *
+ * Returns: (transfer full) (nullable): The app info or %NULL if
+ * there's no such app
+ */
+GDesktopAppInfo *
+phosh_app_info_registry_lookup (PhoshAppInfoRegistry *self, const char *desktop_id)
+{
+  GDesktopAppInfo *info;
+
+  g_return_val_if_fail (PHOSH_IS_APP_INFO_REGISTRY (self), NULL);
+  g_return_val_if_fail (desktop_id, NULL);
+
+  if (g_hash_table_lookup_extended (self->infos, desktop_id, NULL, (gpointer *) &info))
+    return info ? g_object_ref (info) : NULL;
+
+  info = g_desktop_app_info_new (desktop_id);
+  g_debug ("Looked up %s: %s", desktop_id, info ? "found" : "missing");
+  if (info)
+    g_hash_table_insert (self->infos, g_strdup (desktop_id), g_object_ref (info));
+  else
+    add_miss (self, desktop_id);
+
+  return info;
+}
+
+/**
+ * phosh_app_info_registry_lookup_app_id:
+ * @self: The #PhoshAppInfoRegistry
+ * @app_id: A Wayland app id
+ *
+ * Looks up the app info for a window's app id. If there's no desktop
+ * file matching the app id the fixed up id from phosh_fix_app_id()
+ * is tried as well.
+ *
+ * Returns: (transfer full) (nullable): The app info or %NULL if
+ * there's no such app
+ */
+GDesktopAppInfo *
+phosh_app_info_registry_lookup_app_id (PhoshAppInfoRegistry *self, const char *app_id)
+{
+  g_autofree char *desktop_id = NULL;
+  g_autofree char *fixed_id = NULL;
+  GDesktopAppInfo *info;
+
+  g_return_val_if_fail (PHOSH_IS_APP_INFO_REGISTRY (self), NULL);
+  g_return_val_if_fail (app_id, NULL);
+
+  desktop_id = g_strdup_printf ("%s.desktop", app_id);
+  info = phosh_app_info_registry_lookup (self, desktop_id);
+  if (info)
+    return info;
+
+  fixed_id = phosh_fix_app_id (app_id);
+  if (g_strcmp0 (fixed_id, app_id) == 0)
+    return NULL;
+
+  g_free (desktop_id);
+  desktop_id = g_strdup_printf ("%s.desktop", fixed_id);
+  g_debug ("%s has broken app_id, should be %s", app_id, desktop_id);
+
+  return phosh_app_info_registry_lookup (self, desktop_id);
+}
+
+/**
+ * phosh_app_info_registry_populate:
+ * @self: The #PhoshAppInfoRegistry
+ * @infos: (element-type GAppInfo): A list of app infos as returned by
+ *   g_app_info_get_all()
+ *
+ * Adds the given app infos so later lookups don't need to hit the
+ * file system.
+ */
+void
+phosh_app_info_registry_populate (PhoshAppInfoRegistry *self, GList *infos)
+{
+  g_return_if_fail (PHOSH_IS_APP_INFO_REGISTRY (self));
+
+  for (GList *l = infos; l; l = l->next) {
+    const char *id;
+    gpointer value;
+
+    if (!G_IS_DESKTOP_APP_INFO (l->data))
+      continue;
+
+    id = g_app_info_get_id (G_APP_INFO (l->data));
+    if (id == NULL)
+      continue;
+
+    if (g_hash_table_lookup_extended (self->infos, id, NULL, &value) && value == NULL)
+      self->n_misses--;
+
+    g_hash_table_insert (self->infos, g_strdup (id), g_object_ref (l->data));
+  }
+}
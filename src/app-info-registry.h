@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <gio/gdesktopappinfo.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_APP_INFO_REGISTRY (phosh_app_info_registry_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshAppInfoRegistry, phosh_app_info_registry, PHOSH, APP_INFO_REGISTRY, GObject)
+
+PhoshAppInfoRegistry *phosh_app_info_registry_get_default   (void);
+GDesktopAppInfo      *phosh_app_info_registry_lookup        (PhoshAppInfoRegistry *self,
+                                                             const char           *desktop_id);
+GDesktopAppInfo      *phosh_app_info_registry_lookup_app_id (PhoshAppInfoRegistry *self,
+                                                             const char           *app_id);
+void                  phosh_app_info_registry_populate      (PhoshAppInfoRegistry *self,
+                                                             GList                *infos);
+
+G_END_DECLS
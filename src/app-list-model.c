@@ -11,6 +11,7 @@
  * Author: Zander Brown <zbrown@gnome.org>
  */
 
+#include "app-info-registry.h"
 #include "app-list-model.h"
 
 #include <gio/gio.h>
@@ -133,6 +134,9 @@ items_changed (gpointer data)
 
   g_return_val_if_fail (new_apps != NULL, G_SOURCE_REMOVE);
 
+  /* We parsed all desktop files anyway so let others benefit */
+  phosh_app_info_registry_populate (phosh_app_info_registry_get_default (), new_apps);
+
   removed = g_sequence_get_length (priv->items);
 
   g_sequence_remove_range (g_sequence_get_begin_iter (priv->items),
@@ -10,18 +10,38 @@
 
 #include "config.h"
 #include "auth.h"
+#include "trace.h"
 
 #include <security/pam_appl.h>
+#include <string.h>
 
 /**
  * SECTION:auth
  * @short_description: PAM authentication handling
  * @Title: PhoshAuth
+ *
+ * Authentication requests are handled by a worker thread owned by the
+ * #PhoshAuth object. The worker keeps a started PAM handle around so
+ * PAM's setup costs aren't paid when the user submits the PIN. Use
+ * phosh_auth_prepare() to set things up ahead of time. The worker
+ * goes away when the object is finalized.
  */
 
+typedef enum {
+  AUTH_REQUEST_PREPARE,
+  AUTH_REQUEST_AUTHENTICATE,
+  AUTH_REQUEST_QUIT,
+} AuthRequestType;
+
+typedef struct {
+  AuthRequestType type;
+  GTask *task;
+  char *pin;
+} AuthRequest;
+
 typedef struct
 {
-  pam_handle_t *pamh;
+  GAsyncQueue *queue;
 } PhoshAuthPrivate;
 
 
@@ -34,15 +54,44 @@ typedef struct _PhoshAuth
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshAuth, phosh_auth, G_TYPE_OBJECT)
 
 
+static AuthRequest *
+auth_request_new (AuthRequestType type, GTask *task, const char *pin)
+{
+  AuthRequest *request = g_new0 (AuthRequest, 1);
+
+  request->type = type;
+  request->task = task;
+  request->pin = g_strdup (pin);
+
+  return request;
+}
+
+
+static void
+auth_request_free (AuthRequest *request)
+{
+  if (request->pin) {
+    /* Don't leave the PIN lying around */
+    memset (request->pin, 0, strlen (request->pin));
+    g_free (request->pin);
+  }
+  g_clear_object (&request->task);
+  g_free (request);
+}
+
+
 static int
 pam_conversation_cb(int num_msg, const struct pam_message **msg,
                     struct pam_response **resp, void *data)
 {
-  const char *pin = data;
+  const char **pin = data;
   int ret = PAM_CONV_ERR;
-  struct pam_response *pam_resp = calloc(num_msg,
-                                         sizeof(struct pam_response));
+  struct pam_response *pam_resp;
 
+  if (*pin == NULL)
+    return PAM_CONV_ERR;
+
+  pam_resp = calloc(num_msg, sizeof(struct pam_response));
   if (pam_resp == NULL)
     return PAM_BUF_ERR;
 
@@ -50,7 +99,7 @@ pam_conversation_cb(int num_msg, const struct pam_message **msg,
     switch (msg[i]->msg_style) {
     case PAM_PROMPT_ECHO_OFF:
     case PAM_PROMPT_ECHO_ON:
-      pam_resp[i].resp = g_strdup(pin);
+      pam_resp[i].resp = g_strdup(*pin);
       ret = PAM_SUCCESS;
       break;
     case PAM_ERROR_MSG: /* TBD */
@@ -68,64 +117,119 @@ pam_conversation_cb(int num_msg, const struct pam_message **msg,
 }
 
 
+static void
+end_pam (pam_handle_t **pamh, int status)
+{
+  int ret;
+
+  if (*pamh == NULL)
+    return;
+
+  ret = pam_end (*pamh, status);
+  if (ret != PAM_SUCCESS)
+    g_warning ("pam_end error %d", ret);
+  *pamh = NULL;
+}
+
+
 /* return TRUE if pin is correct, FALSE otherwise */
 static gboolean
-authenticate (PhoshAuth *self, const char *number)
+authenticate (pam_handle_t **pamh)
 {
-  PhoshAuthPrivate *priv = phosh_auth_get_instance_private (self);
   int ret;
-  gboolean authenticated = FALSE;
-  const char *username;
+
+  ret = pam_authenticate(*pamh, 0);
+  if (ret == PAM_SUCCESS)
+    return TRUE;
+
+  /* Keep the handle for the next attempt on a wrong PIN */
+  if (ret != PAM_AUTH_ERR) {
+    g_warning("pam_authenticate error %s", pam_strerror (*pamh, ret));
+    end_pam (pamh, ret);
+  }
+
+  return FALSE;
+}
+
+
+static gpointer
+auth_worker_thread (gpointer data)
+{
+  g_autoptr (GAsyncQueue) queue = data;
+  pam_handle_t *pamh = NULL;
+  const char *pin = NULL;
   const struct pam_conv conv = {
     .conv = pam_conversation_cb,
-    .appdata_ptr = (void*)number,
+    .appdata_ptr = (void*)&pin,
   };
 
-  if (priv->pamh == NULL) {
-    username = g_get_user_name ();
-    ret = pam_start("phosh", username, &conv, &priv->pamh);
-    if (ret != PAM_SUCCESS) {
-      g_warning ("PAM start error %s", pam_strerror (priv->pamh, ret));
-      goto out;
+  while (TRUE) {
+    AuthRequest *request = g_async_queue_pop (queue);
+    gboolean authenticated;
+    gint64 begin;
+    int ret;
+
+    if (request->type == AUTH_REQUEST_QUIT) {
+      auth_request_free (request);
+      break;
     }
-  }
 
-  ret = pam_authenticate(priv->pamh, 0);
-  if (ret == PAM_SUCCESS) {
-    authenticated = TRUE;
-  } else {
-    if (ret != PAM_AUTH_ERR)
-      g_warning("pam_authenticate error %s", pam_strerror (priv->pamh, ret));
-    goto out;
-  }
+    if (request->task && g_task_return_error_if_cancelled (request->task)) {
+      auth_request_free (request);
+      continue;
+    }
 
-  ret = pam_end(priv->pamh, ret);
-  if (ret != PAM_SUCCESS)
-    g_warning("pam_end error %d", ret);
-  priv->pamh = NULL;
+    if (pamh == NULL) {
+      begin = phosh_trace_now ();
+      ret = pam_start("phosh", g_get_user_name (), &conv, &pamh);
+      if (ret != PAM_SUCCESS) {
+        g_warning ("PAM start error %s", pam_strerror (pamh, ret));
+        pamh = NULL;
+      }
+      phosh_trace_mark ("pam-start", begin, NULL);
+    }
 
- out:
-  return authenticated;
+    if (request->type == AUTH_REQUEST_PREPARE) {
+      auth_request_free (request);
+      continue;
+    }
+
+    authenticated = FALSE;
+    if (pamh && request->pin) {
+      begin = phosh_trace_now ();
+      pin = request->pin;
+      authenticated = authenticate (&pamh);
+      pin = NULL;
+      phosh_trace_mark ("pam-authenticate", begin, "%s", authenticated ? "success" : "failure");
+    }
+
+    /* A session is authenticated only once */
+    if (authenticated)
+      end_pam (&pamh, PAM_SUCCESS);
+
+    g_task_return_boolean (request->task, authenticated);
+    auth_request_free (request);
+  }
+
+  end_pam (&pamh, PAM_AUTH_ERR);
+  return NULL;
 }
 
 
 static void
-authenticate_thread (GTask *task,
-                    gpointer source_object,
-                    gpointer task_data,
-                    GCancellable *cancellable)
+push_request (PhoshAuth *self, AuthRequest *request)
 {
-  PhoshAuth *self = PHOSH_AUTH (source_object);
-  const char *number = task_data;
-  gboolean ret;
+  PhoshAuthPrivate *priv = phosh_auth_get_instance_private (self);
+  GThread *thread;
 
-  if (task_data == NULL) {
-    g_task_return_boolean (task, FALSE);
-    return;
+  if (priv->queue == NULL) {
+    priv->queue = g_async_queue_new_full ((GDestroyNotify) auth_request_free);
+    /* The worker holds its own ref and quits on AUTH_REQUEST_QUIT */
+    thread = g_thread_new ("phosh-auth", auth_worker_thread, g_async_queue_ref (priv->queue));
+    g_thread_unref (thread);
   }
 
-  ret = authenticate (self, number);
-  g_task_return_boolean (task, ret);
+  g_async_queue_push (priv->queue, request);
 }
 
 
@@ -134,13 +238,12 @@ phosh_auth_finalize (GObject *object)
 {
   PhoshAuthPrivate *priv = phosh_auth_get_instance_private (PHOSH_AUTH(object));
   GObjectClass *parent_class = G_OBJECT_CLASS (phosh_auth_parent_class);
-  int ret;
 
-  if (priv->pamh) {
-    ret = pam_end(priv->pamh, PAM_AUTH_ERR);
-    if (ret != PAM_SUCCESS)
-      g_warning("pam_end error %s", pam_strerror (priv->pamh, ret));
-    priv->pamh = NULL;
+  /* Pending requests hold a ref on us so the queue is empty. Let the
+     worker tear down PAM in the background. */
+  if (priv->queue) {
+    g_async_queue_push (priv->queue, auth_request_new (AUTH_REQUEST_QUIT, NULL, NULL));
+    g_clear_pointer (&priv->queue, g_async_queue_unref);
   }
 
   parent_class->finalize (object);
@@ -169,6 +272,22 @@ phosh_auth_new (void)
 }
 
 
+/**
+ * phosh_auth_prepare:
+ * @self: The auth object
+ *
+ * Starts the worker thread and sets up PAM so a later
+ * authentication request can be handled quickly.
+ */
+void
+phosh_auth_prepare (PhoshAuth *self)
+{
+  g_return_if_fail (PHOSH_IS_AUTH (self));
+
+  push_request (self, auth_request_new (AUTH_REQUEST_PREPARE, NULL, NULL));
+}
+
+
 void
 phosh_auth_authenticate_async_start (PhoshAuth           *self,
                                      const char          *number,
@@ -178,10 +297,19 @@ phosh_auth_authenticate_async_start (PhoshAuth           *self,
 {
   GTask *task;
 
+  g_return_if_fail (PHOSH_IS_AUTH (self));
+
   task = g_task_new (self, cancellable, callback, callback_data);
-  g_task_set_task_data (task, (gpointer) number, NULL);
-  g_task_run_in_thread (task, authenticate_thread);
-  g_object_unref (task);
+  g_task_set_source_tag (task, phosh_auth_authenticate_async_start);
+
+  if (number == NULL) {
+    g_task_return_boolean (task, FALSE);
+    g_object_unref (task);
+    return;
+  }
+
+  /* The request takes over the task */
+  push_request (self, auth_request_new (AUTH_REQUEST_AUTHENTICATE, task, number));
 }
 
 
@@ -77,6 +77,20 @@ phosh_bt_manager_get_property (GObject    *object,
 }
 
 
+static void
+phosh_bt_manager_dispose (GObject *object)
+{
+  PhoshBtManager *self = PHOSH_BT_MANAGER (object);
+
+  /* The proxy is shared so drop our handlers */
+  if (self->proxy)
+    g_signal_handlers_disconnect_by_data (self->proxy, self);
+  g_clear_object (&self->proxy);
+
+  G_OBJECT_CLASS (phosh_bt_manager_parent_class)->dispose (object);
+}
+
+
 static void
 on_bt_airplane_mode_changed (PhoshBtManager        *self,
                              GParamSpec            *pspec,
@@ -139,6 +153,7 @@ phosh_bt_manager_class_init (PhoshBtManagerClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->get_property = phosh_bt_manager_get_property;
+  object_class->dispose = phosh_bt_manager_dispose;
 
   props[PROP_ICON_NAME] =
     g_param_spec_string ("icon-name",
@@ -170,15 +185,15 @@ phosh_bt_manager_class_init (PhoshBtManagerClass *klass)
 
 
 static void
-on_proxy_new_for_bus_finish (GObject        *source_object,
-                             GAsyncResult   *res,
-                             PhoshBtManager *self)
+on_proxy_new_for_bus_finish (PhoshProxyRegistry *registry,
+                             GAsyncResult       *res,
+                             PhoshBtManager     *self)
 {
   g_autoptr (GError) err = NULL;
 
   g_return_if_fail (PHOSH_IS_BT_MANAGER (self));
 
-  self->proxy = phosh_rfkill_dbus_rfkill_proxy_new_for_bus_finish (res, &err);
+  self->proxy = PHOSH_RFKILL_DBUS_RFKILL (phosh_proxy_registry_get_proxy_finish (registry, res, &err));
 
   if (!self->proxy) {
     g_warning ("Failed to get gsd rfkill proxy: %s", err->message);
@@ -205,13 +220,17 @@ out:
 static gboolean
 on_idle (PhoshBtManager *self)
 {
-  phosh_rfkill_dbus_rfkill_proxy_new_for_bus (G_BUS_TYPE_SESSION,
-                                              G_DBUS_PROXY_FLAGS_NONE,
-                                              BUS_NAME,
-                                              OBJECT_PATH,
-                                              NULL,
-                                              (GAsyncReadyCallback) on_proxy_new_for_bus_finish,
-                                              g_object_ref (self));
+  PhoshProxyRegistry *registry = phosh_shell_get_proxy_registry (phosh_shell_get_default ());
+
+  phosh_proxy_registry_get_proxy (registry,
+                                  PHOSH_RFKILL_DBUS_TYPE_RFKILL_PROXY,
+                                  G_DBUS_PROXY_FLAGS_NONE,
+                                  BUS_NAME,
+                                  OBJECT_PATH,
+                                  BUS_NAME,
+                                  NULL,
+                                  (GAsyncReadyCallback) on_proxy_new_for_bus_finish,
+                                  g_object_ref (self));
   return G_SOURCE_REMOVE;
 }
 
@@ -11,6 +11,7 @@
 #include "config.h"
 
 #include "connectivity-info.h"
+#include "nm-service.h"
 
 #include <NetworkManager.h>
 
@@ -38,6 +39,7 @@ struct _PhoshConnectivityInfo {
 
   gboolean        connectivity;
   NMClient       *nmclient;
+  GCancellable   *cancel;
 };
 G_DEFINE_TYPE (PhoshConnectivityInfo, phosh_connectivity_info, PHOSH_TYPE_STATUS_ICON);
 
@@ -109,22 +111,26 @@ on_idle (PhoshConnectivityInfo *self)
 
 
 static void
-on_nm_client_ready (GObject *obj, GAsyncResult *res, PhoshConnectivityInfo *self)
+on_nm_client_ready (GObject *obj, GAsyncResult *res, gpointer data)
 {
   g_autoptr (GError) err = NULL;
+  PhoshConnectivityInfo *self;
+  NMClient *nmclient;
 
-  g_return_if_fail (PHOSH_IS_CONNECTIVITY_INFO (self));
-
-  self->nmclient = nm_client_new_finish (res, &err);
-  if (err) {
-    g_warning ("Failed to init NM: %s", err->message);
+  nmclient = phosh_nm_service_get_client_finish (PHOSH_NM_SERVICE (obj), res, &err);
+  if (!nmclient) {
+    if (!g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      g_warning ("Failed to get NM client: %s", err->message);
     return;
   }
 
-  g_return_if_fail (NM_IS_CLIENT (self->nmclient));
+  g_return_if_fail (PHOSH_IS_CONNECTIVITY_INFO (data));
+  self = PHOSH_CONNECTIVITY_INFO (data);
+  self->nmclient = nmclient;
 
-  g_signal_connect_swapped (self->nmclient, "notify::connectivity",
-                            G_CALLBACK (on_connectivity_changed), self);
+  g_signal_connect_object (self->nmclient, "notify::connectivity",
+                           G_CALLBACK (on_connectivity_changed), self,
+                           G_CONNECT_SWAPPED);
 
   g_idle_add ((GSourceFunc) on_idle, self);
 }
@@ -137,7 +143,11 @@ phosh_connectivity_info_constructed (GObject *object)
 
   G_OBJECT_CLASS (phosh_connectivity_info_parent_class)->constructed (object);
 
-  nm_client_new_async (NULL, (GAsyncReadyCallback)on_nm_client_ready, self);
+  self->cancel = g_cancellable_new ();
+  phosh_nm_service_get_client_async (phosh_nm_service_get_default (),
+                                     self->cancel,
+                                     on_nm_client_ready,
+                                     self);
 }
 
 
@@ -146,7 +156,13 @@ phosh_connectivity_info_dispose (GObject *object)
 {
   PhoshConnectivityInfo *self = PHOSH_CONNECTIVITY_INFO (object);
 
-  g_clear_object (&self->nmclient);
+  g_cancellable_cancel (self->cancel);
+  g_clear_object (&self->cancel);
+  /* The client is shared so make sure we don't get notified anymore */
+  if (self->nmclient) {
+    g_signal_handlers_disconnect_by_data (self->nmclient, self);
+    g_clear_object (&self->nmclient);
+  }
 
   G_OBJECT_CLASS (phosh_connectivity_info_parent_class)->dispose (object);
 }
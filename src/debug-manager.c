@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-debug-manager"
+
+#include "config.h"
+
+#include "debug-manager.h"
+
+/**
+ * SECTION:debug-manager
+ * @short_description: Provides the sm.puri.Phosh.Debug DBus interface
+ * @Title: PhoshDebugManager
+ *
+ * Exposes the main loop stalls recorded by a #PhoshStallWatchdog so
+ * they can be fetched from a running session, e.g. via
+ *
+ * |[
+ * gdbus call --session --dest sm.puri.Phosh.Debug \
+ *   --object-path /sm/puri/Phosh/Debug --method sm.puri.Phosh.Debug.GetStalls
+ * ]|
+ */
+
+#define DEBUG_DBUS_NAME "sm.puri.Phosh.Debug"
+#define DEBUG_DBUS_PATH "/sm/puri/Phosh/Debug"
+
+enum {
+  PROP_0,
+  PROP_STALL_WATCHDOG,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+static void phosh_debug_manager_debug_iface_init (PhoshDebugDbusDebugIface *iface);
+
+typedef struct _PhoshDebugManager
+{
+  PhoshDebugDbusDebugSkeleton parent;
+
+  guint                       dbus_name_id;
+  PhoshStallWatchdog         *stall_watchdog;
+} PhoshDebugManager;
+
+G_DEFINE_TYPE_WITH_CODE (PhoshDebugManager,
+                         phosh_debug_manager,
+                         PHOSH_DEBUG_DBUS_TYPE_DEBUG_SKELETON,
+                         G_IMPLEMENT_INTERFACE (
+                           PHOSH_DEBUG_DBUS_TYPE_DEBUG,
+                           phosh_debug_manager_debug_iface_init));
+
+
+static void
+phosh_debug_manager_set_property (GObject      *object,
+                                  guint         property_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  PhoshDebugManager *self = PHOSH_DEBUG_MANAGER (object);
+
+  switch (property_id) {
+  case PROP_STALL_WATCHDOG:
+    self->stall_watchdog = g_value_dup_object (value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_debug_manager_get_property (GObject    *object,
+                                  guint       property_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  PhoshDebugManager *self = PHOSH_DEBUG_MANAGER (object);
+
+  switch (property_id) {
+  case PROP_STALL_WATCHDOG:
+    g_value_set_object (value, self->stall_watchdog);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+add_stall (const PhoshStallRecord *record, gpointer user_data)
+{
+  GVariantBuilder *builder = user_data;
+
+  g_variant_builder_add (builder, "(xxss)",
+                         record->begin,
+                         record->duration,
+                         record->source ?: "",
+                         record->backtrace ?: "");
+}
+
+
+static gboolean
+handle_get_stalls (PhoshDebugDbusDebug   *skeleton,
+                   GDBusMethodInvocation *invocation)
+{
+  PhoshDebugManager *self = PHOSH_DEBUG_MANAGER (skeleton);
+  GVariantBuilder builder;
+
+  g_return_val_if_fail (PHOSH_IS_STALL_WATCHDOG (self->stall_watchdog), FALSE);
+
+  g_debug ("DBus call GetStalls");
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(xxss)"));
+  phosh_stall_watchdog_foreach (self->stall_watchdog, add_stall, &builder);
+
+  phosh_debug_dbus_debug_complete_get_stalls (skeleton, invocation,
+                                              g_variant_builder_end (&builder));
+
+  return TRUE;
+}
+
+
+static gboolean
+handle_clear_stalls (PhoshDebugDbusDebug   *skeleton,
+                     GDBusMethodInvocation *invocation)
+{
+  PhoshDebugManager *self = PHOSH_DEBUG_MANAGER (skeleton);
+
+  g_return_val_if_fail (PHOSH_IS_STALL_WATCHDOG (self->stall_watchdog), FALSE);
+
+  g_debug ("DBus call ClearStalls");
+  phosh_stall_watchdog_clear (self->stall_watchdog);
+  phosh_debug_dbus_debug_complete_clear_stalls (skeleton, invocation);
+
+  return TRUE;
+}
+
+
+static void
+phosh_debug_manager_debug_iface_init (PhoshDebugDbusDebugIface *iface)
+{
+  iface->handle_get_stalls = handle_get_stalls;
+  iface->handle_clear_stalls = handle_clear_stalls;
+}
+
+
+static void
+on_name_acquired (GDBusConnection *connection,
+                  const char      *name,
+                  gpointer         user_data)
+{
+  g_debug ("Acquired name %s", name);
+}
+
+
+static void
+on_name_lost (GDBusConnection *connection,
+              const char      *name,
+              gpointer         user_data)
+{
+  g_debug ("Lost or failed to acquire name %s", name);
+}
+
+
+static void
+on_bus_acquired (GDBusConnection *connection,
+                 const char      *name,
+                 gpointer         user_data)
+{
+  PhoshDebugManager *self = user_data;
+  g_autoptr (GError) err = NULL;
+
+  if (!g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (self),
+                                         connection,
+                                         DEBUG_DBUS_PATH,
+                                         &err)) {
+    g_warning ("Failed to export debug interface: %s", err->message);
+  }
+}
+
+
+static void
+phosh_debug_manager_constructed (GObject *object)
+{
+  PhoshDebugManager *self = PHOSH_DEBUG_MANAGER (object);
+
+  G_OBJECT_CLASS (phosh_debug_manager_parent_class)->constructed (object);
+
+  g_return_if_fail (PHOSH_IS_STALL_WATCHDOG (self->stall_watchdog));
+  phosh_debug_dbus_debug_set_stall_threshold (PHOSH_DEBUG_DBUS_DEBUG (self),
+                                              phosh_stall_watchdog_get_threshold (self->stall_watchdog));
+
+  self->dbus_name_id = g_bus_own_name (G_BUS_TYPE_SESSION,
+                                       DEBUG_DBUS_NAME,
+                                       G_BUS_NAME_OWNER_FLAGS_ALLOW_REPLACEMENT |
+                                       G_BUS_NAME_OWNER_FLAGS_REPLACE,
+                                       on_bus_acquired,
+                                       on_name_acquired,
+                                       on_name_lost,
+                                       self,
+                                       NULL);
+}
+
+
+static void
+phosh_debug_manager_dispose (GObject *object)
+{
+  PhoshDebugManager *self = PHOSH_DEBUG_MANAGER (object);
+
+  g_clear_handle_id (&self->dbus_name_id, g_bus_unown_name);
+  if (g_dbus_interface_skeleton_get_object_path (G_DBUS_INTERFACE_SKELETON (self)))
+    g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (self));
+
+  g_clear_object (&self->stall_watchdog);
+
+  G_OBJECT_CLASS (phosh_debug_manager_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_debug_manager_class_init (PhoshDebugManagerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->constructed = phosh_debug_manager_constructed;
+  object_class->dispose = phosh_debug_manager_dispose;
+  object_class->set_property = phosh_debug_manager_set_property;
+  object_class->get_property = phosh_debug_manager_get_property;
+
+  props[PROP_STALL_WATCHDOG] =
+    g_param_spec_object ("stall-watchdog",
+                         "Stall watchdog",
+                         "The watchdog recording main loop stalls",
+                         PHOSH_TYPE_STALL_WATCHDOG,
+                         G_PARAM_READWRITE |
+                         G_PARAM_CONSTRUCT_ONLY |
+                         G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+}
+
+
+static void
+phosh_debug_manager_init (PhoshDebugManager *self)
+{
+}
+
+
+PhoshDebugManager *
+phosh_debug_manager_new (PhoshStallWatchdog *stall_watchdog)
+{
+  return g_object_new (PHOSH_TYPE_DEBUG_MANAGER, "stall-watchdog", stall_watchdog, NULL);
+}
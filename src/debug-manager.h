@@ -0,0 +1,17 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "stall-watchdog.h"
+#include "dbus/phosh-debug-dbus.h"
+#include <glib-object.h>
+
+#define PHOSH_TYPE_DEBUG_MANAGER (phosh_debug_manager_get_type ())
+G_DECLARE_FINAL_TYPE (PhoshDebugManager, phosh_debug_manager, PHOSH, DEBUG_MANAGER,
+                      PhoshDebugDbusDebugSkeleton)
+
+PhoshDebugManager *phosh_debug_manager_new (PhoshStallWatchdog *stall_watchdog);
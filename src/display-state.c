@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-display-state"
+
+#include "config.h"
+
+#include "display-state.h"
+#include "trace.h"
+
+/**
+ * SECTION:display-state
+ * @short_description: Tracks whether the built-in display is off
+ * @Title: PhoshDisplayState
+ *
+ * While the built-in display is powered off nothing the shell draws
+ * is visible. Widgets with periodic updates (like clocks) or
+ * frequently changing state (like status icons) listen to
+ * #PhoshDisplayState:display-off to pause their timers and defer
+ * updates. Once the display is powered on again they do a single
+ * catch-up refresh.
+ *
+ * Consumers report the wakeups they avoided via
+ * phosh_display_state_add_avoided_wakeups(). The number is recorded
+ * as a trace mark for each display off period so the power win can
+ * be measured.
+ */
+
+enum {
+  PROP_0,
+  PROP_DISPLAY_OFF,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+struct _PhoshDisplayState {
+  GObject  parent;
+
+  gboolean display_off;
+  gint64   off_since;
+  /* Wakeups avoided in the current display off period */
+  guint    period_wakeups;
+  /* Wakeups avoided in total */
+  guint    total_wakeups;
+};
+G_DEFINE_TYPE (PhoshDisplayState, phosh_display_state, G_TYPE_OBJECT)
+
+
+static void
+phosh_display_state_set_property (GObject      *object,
+                                  guint         property_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  PhoshDisplayState *self = PHOSH_DISPLAY_STATE (object);
+
+  switch (property_id) {
+  case PROP_DISPLAY_OFF:
+    phosh_display_state_set_display_off (self, g_value_get_boolean (value));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_display_state_get_property (GObject    *object,
+                                  guint       property_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  PhoshDisplayState *self = PHOSH_DISPLAY_STATE (object);
+
+  switch (property_id) {
+  case PROP_DISPLAY_OFF:
+    g_value_set_boolean (value, self->display_off);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_display_state_class_init (PhoshDisplayStateClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->set_property = phosh_display_state_set_property;
+  object_class->get_property = phosh_display_state_get_property;
+
+  /**
+   * PhoshDisplayState:display-off:
+   *
+   * Whether the built-in display is powered off
+   */
+  props[PROP_DISPLAY_OFF] =
+    g_param_spec_boolean ("display-off",
+                          "Display off",
+                          "Whether the built-in display is powered off",
+                          FALSE,
+                          G_PARAM_READWRITE |
+                          G_PARAM_STATIC_STRINGS |
+                          G_PARAM_EXPLICIT_NOTIFY);
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+}
+
+
+static void
+phosh_display_state_init (PhoshDisplayState *self)
+{
+}
+
+/**
+ * phosh_display_state_get_default:
+ *
+ * Get the display state singleton
+ *
+ * Returns:(transfer none): The display state singleton
+ */
+PhoshDisplayState *
+phosh_display_state_get_default (void)
+{
+  static PhoshDisplayState *instance;
+
+  if (instance == NULL) {
+    instance = g_object_new (PHOSH_TYPE_DISPLAY_STATE, NULL);
+    g_object_add_weak_pointer (G_OBJECT (instance), (gpointer *)&instance);
+  }
+
+  return instance;
+}
+
+
+gboolean
+phosh_display_state_get_display_off (PhoshDisplayState *self)
+{
+  g_return_val_if_fail (PHOSH_IS_DISPLAY_STATE (self), FALSE);
+
+  return self->display_off;
+}
+
+/**
+ * phosh_display_state_set_display_off:
+ * @self: The #PhoshDisplayState
+ * @off: Whether the display is off
+ *
+ * Set whether the built-in display is powered off. When the display
+ * is powered on again the wakeups avoided while it was off are
+ * recorded as the "display-off" trace mark.
+ */
+void
+phosh_display_state_set_display_off (PhoshDisplayState *self, gboolean off)
+{
+  g_return_if_fail (PHOSH_IS_DISPLAY_STATE (self));
+
+  off = !!off;
+  if (self->display_off == off)
+    return;
+
+  self->display_off = off;
+  if (off) {
+    self->off_since = phosh_trace_now ();
+    self->period_wakeups = 0;
+  }
+
+  /* Let consumers catch up before reporting */
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_DISPLAY_OFF]);
+
+  if (!off) {
+    g_debug ("Display was off for %" G_GINT64_FORMAT "s, avoided %u wakeups",
+             (phosh_trace_now () - self->off_since) / G_USEC_PER_SEC,
+             self->period_wakeups);
+    phosh_trace_mark ("display-off", self->off_since, "%u wakeups avoided",
+                      self->period_wakeups);
+  }
+}
+
+/**
+ * phosh_display_state_add_avoided_wakeups:
+ * @self: The #PhoshDisplayState
+ * @n: The number of wakeups
+ *
+ * Account for @n timer wakeups or widget updates a consumer skipped
+ * because the display was off.
+ */
+void
+phosh_display_state_add_avoided_wakeups (PhoshDisplayState *self, guint n)
+{
+  g_return_if_fail (PHOSH_IS_DISPLAY_STATE (self));
+
+  self->period_wakeups += n;
+  self->total_wakeups += n;
+}
+
+/**
+ * phosh_display_state_get_avoided_wakeups:
+ * @self: The #PhoshDisplayState
+ *
+ * Returns: The number of wakeups avoided since startup
+ */
+guint
+phosh_display_state_get_avoided_wakeups (PhoshDisplayState *self)
+{
+  g_return_val_if_fail (PHOSH_IS_DISPLAY_STATE (self), 0);
+
+  return self->total_wakeups;
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_DISPLAY_STATE (phosh_display_state_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshDisplayState, phosh_display_state, PHOSH, DISPLAY_STATE, GObject)
+
+PhoshDisplayState *phosh_display_state_get_default          (void);
+gboolean           phosh_display_state_get_display_off      (PhoshDisplayState *self);
+void               phosh_display_state_set_display_off      (PhoshDisplayState *self,
+                                                             gboolean           off);
+void               phosh_display_state_add_avoided_wakeups  (PhoshDisplayState *self,
+                                                             guint              n);
+guint              phosh_display_state_get_avoided_wakeups  (PhoshDisplayState *self);
+
+G_END_DECLS
@@ -8,6 +8,7 @@
 
 #define FAVORITES_KEY "favorites"
 
+#include "app-info-registry.h"
 #include "favorite-list-model.h"
 
 #include <gio/gio.h>
@@ -74,7 +75,8 @@ list_get_item (GListModel *list, guint position)
     return NULL;
   }
 
-  return g_desktop_app_info_new (priv->items[position]);
+  return phosh_app_info_registry_lookup (phosh_app_info_registry_get_default (),
+                                         priv->items[position]);
 }
 
 
@@ -124,7 +126,8 @@ favorites_changed (GSettings              *settings,
     g_autoptr (GDesktopAppInfo) info = NULL;
 
     /* We don't actually care about this value, just that it isn't NULL */
-    info = g_desktop_app_info_new (priv->items_inc_missing[i]);
+    info = phosh_app_info_registry_lookup (phosh_app_info_registry_get_default (),
+                                           priv->items_inc_missing[i]);
 
     if (G_LIKELY (info != NULL)) {
       priv->items[added] = g_strdup (priv->items_inc_missing[i]);
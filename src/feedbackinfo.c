@@ -17,6 +17,9 @@
  * SECTION:feedbackinfo
  * @short_description: A widget to toggle feedback modes
  * @Title: PhoshFeedbackInfo
+ *
+ * The #PhoshFeedbackManager is only looked up (and hence created)
+ * once the widget gets mapped so it stays off the startup path.
  */
 
 typedef struct _PhoshFeedbackInfo {
@@ -56,22 +59,25 @@ on_profile_changed (PhoshFeedbackInfo *self, GParamSpec *psepc, gpointer unused)
 
 
 static void
-phosh_feedback_info_constructed (GObject *object)
+phosh_feedback_info_map (GtkWidget *widget)
 {
-  PhoshFeedbackInfo *self = PHOSH_FEEDBACK_INFO(object);
-  PhoshShell *shell = phosh_shell_get_default ();
-
-  self->manager = g_object_ref(phosh_shell_get_feedback_manager (shell));
-
-  g_signal_connect_swapped (self->manager,
-                            "notify::profile",
-                            G_CALLBACK(on_profile_changed),
-                            self);
-  on_profile_changed (self, NULL, NULL);
-  g_object_bind_property (self->manager, "icon-name", self, "icon-name",
-                          G_BINDING_SYNC_CREATE);
+  PhoshFeedbackInfo *self = PHOSH_FEEDBACK_INFO (widget);
+  PhoshShell *shell;
+
+  if (self->manager == NULL) {
+    shell = phosh_shell_get_default ();
+    self->manager = g_object_ref (phosh_shell_get_feedback_manager (shell));
+
+    g_signal_connect_swapped (self->manager,
+                              "notify::profile",
+                              G_CALLBACK (on_profile_changed),
+                              self);
+    on_profile_changed (self, NULL, NULL);
+    g_object_bind_property (self->manager, "icon-name", self, "icon-name",
+                            G_BINDING_SYNC_CREATE);
+  }
 
-  G_OBJECT_CLASS (phosh_feedback_info_parent_class)->constructed (object);
+  GTK_WIDGET_CLASS (phosh_feedback_info_parent_class)->map (widget);
 }
 
 
@@ -93,9 +99,10 @@ static void
 phosh_feedback_info_class_init (PhoshFeedbackInfoClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
-  object_class->constructed = phosh_feedback_info_constructed;
   object_class->dispose = phosh_feedback_info_dispose;
+  widget_class->map = phosh_feedback_info_map;
 }
 
 
@@ -105,7 +105,7 @@ phosh_home_get_property (GObject *object,
 static void
 phosh_home_resize (PhoshHome *self)
 {
-  int margin;
+  int margin, offset;
   int height;
   double progress = hdy_ease_out_cubic (self->animation.progress);
 
@@ -115,16 +115,26 @@ phosh_home_resize (PhoshHome *self)
   phosh_arrow_set_progress (PHOSH_ARROW (self->arrow_home), 1 - progress);
 
   g_object_get (self, "configured-height", &height, NULL);
-  margin = (-height + PHOSH_HOME_BUTTON_HEIGHT) * progress;
+  offset = (height - PHOSH_HOME_BUTTON_HEIGHT) * progress;
 
+  /* While animating keep the surface unfolded and only move its
+     content so we don't trigger a configure on every frame. */
+  if (self->animation.progress < 1.0) {
+    margin = 0;
+  } else {
+    margin = -offset;
+    offset = 0;
+  }
+
+  phosh_layer_surface_begin (PHOSH_LAYER_SURFACE (self));
   phosh_layer_surface_set_margins (PHOSH_LAYER_SURFACE (self), 0, 0, margin, 0);
   /* Adjust the exclusive zone since exclusive zone includes margins.
      We don't want to change the effective exclusive zone at all to
      prevent all clients from being resized. */
   phosh_layer_surface_set_exclusive_zone (PHOSH_LAYER_SURFACE (self),
                                           -margin + PHOSH_HOME_BUTTON_HEIGHT);
-
-  phosh_layer_surface_wl_surface_commit (PHOSH_LAYER_SURFACE (self));
+  phosh_layer_surface_set_content_offset (PHOSH_LAYER_SURFACE (self), 0, offset);
+  phosh_layer_surface_commit (PHOSH_LAYER_SURFACE (self));
 }
 
 
@@ -352,6 +362,8 @@ phosh_home_set_state (PhoshHome *self, PhoshHomeState state)
     gtk_widget_hide (self->btn_osk);
     kbd_interactivity = TRUE;
     phosh_overview_reset (PHOSH_OVERVIEW (self->overview));
+    /* Get the thumbnail frames going while we animate */
+    phosh_overview_prefetch (PHOSH_OVERVIEW (self->overview));
   } else {
     gtk_widget_show (self->btn_osk);
     kbd_interactivity = FALSE;
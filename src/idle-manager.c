@@ -24,16 +24,40 @@
  * implement mutter's org.gnome.Mutter.IdleMonitor DBus
  * interface. Since we don't have per monitor information we only care
  * about core.
+ *
+ * Watches with the same interval share a single compositor timer and
+ * all watches of a DBus client share a single name watcher.
  */
 
+/* Interval of the timer that is always around to track the idle time */
+#define IDLE_TRACKER_INTERVAL 1000
+
+/* A compositor timer shared by all watches with the same interval */
+typedef struct {
+  PhoshIdleManager *manager;
+  struct org_kde_kwin_idle_timeout *idle_timer;
+  guint32 interval;
+  GPtrArray *watches;
+  gint64 idle_since;
+  gboolean pinned;
+} IdleTimer;
+
+/* A DBus client owning watches */
+typedef struct {
+  PhoshIdleManager *manager;
+  char *dbus_name;
+  guint name_watcher_id;
+  guint n_watches;
+} WatchClient;
+
 /* A DBus watch corresponding to either an idle or active timer */
 typedef struct {
   PhoshIdleDbusIdleMonitor *dbus_monitor;
-  struct org_kde_kwin_idle_timeout *idle_timer;
   PhoshMonitor *monitor;
-  char *dbus_name;
+  IdleTimer *timer;
+  WatchClient *client;
   guint watch_id;
-  guint name_watcher_id;
+  gboolean active;
 } DBusWatch;
 
 
@@ -43,6 +67,9 @@ typedef struct _PhoshIdleManager
   GObject parent;
 
   GHashTable *watches;
+  GHashTable *timers;
+  GHashTable *clients;
+  IdleTimer *tracker;
   GDBusObjectManagerServer *manager;
   int dbus_name_id;
 } PhoshIdleManager;
@@ -60,58 +87,75 @@ get_next_dbus_watch_serial (void)
 }
 
 
-/* cleanup a single watch */
 static void
-watch_dispose (DBusWatch *watch)
+watch_fire (DBusWatch *watch)
 {
-  org_kde_kwin_idle_timeout_release (watch->idle_timer);
-  g_bus_unwatch_name (watch->name_watcher_id);
-  g_object_unref (watch->monitor);
-  g_object_unref (watch->dbus_monitor);
-  g_free (watch->dbus_name);
-  g_free (watch);
+  GDBusInterfaceSkeleton *skeleton = G_DBUS_INTERFACE_SKELETON (watch->dbus_monitor);
+
+  g_dbus_connection_emit_signal (g_dbus_interface_skeleton_get_connection (skeleton),
+                                 watch->client->dbus_name,
+                                 g_dbus_interface_skeleton_get_object_path (skeleton),
+                                 "org.gnome.Mutter.IdleMonitor",
+                                 "WatchFired",
+                                 g_variant_new ("(u)", watch->watch_id),
+                                 NULL);
 }
 
 
-/* remove a watch from the list of known watches */
 static void
-watch_remove (DBusWatch *watch)
+idle_timer_idle_cb (void *data, struct org_kde_kwin_idle_timeout *idle_timer)
 {
-  PhoshIdleManager *self = phosh_idle_manager_get_default ();
+  IdleTimer *timer = data;
 
-  g_debug ("Removing watch %d", watch->watch_id);
-  g_hash_table_remove (self->watches, &watch->watch_id);
-}
+  g_debug ("Idle timer for %u msec fired", timer->interval);
+  timer->idle_since = g_get_monotonic_time ();
 
+  /* Idle watches only care about idle */
+  for (guint i = 0; i < timer->watches->len; i++) {
+    DBusWatch *watch = g_ptr_array_index (timer->watches, i);
 
-static void
-idle_timer_idle_cb (void *data, struct org_kde_kwin_idle_timeout *timer)
-{
-  DBusWatch *watch = data;
-  GDBusInterfaceSkeleton *skeleton = G_DBUS_INTERFACE_SKELETON (watch->dbus_monitor);
+    if (watch->active)
+      continue;
 
-  g_debug ("Idle Timer %d fired on %s", watch->watch_id, watch->dbus_name);
-  g_dbus_connection_emit_signal (g_dbus_interface_skeleton_get_connection (skeleton),
-                                 watch->dbus_name,
-                                 g_dbus_interface_skeleton_get_object_path (skeleton),
-                                 "org.gnome.Mutter.IdleMonitor",
-                                 "WatchFired",
-                                 g_variant_new ("(u)", watch->watch_id),
-                                 NULL);
+    g_debug ("Idle watch %d fired on %s", watch->watch_id, watch->client->dbus_name);
+    watch_fire (watch);
+  }
 }
 
 
 static void
-idle_timer_resume_cb (void* data, struct org_kde_kwin_idle_timeout *timer)
+idle_timer_resume_cb (void* data, struct org_kde_kwin_idle_timeout *idle_timer)
 {
-  DBusWatch *watch = data;
+  IdleTimer *timer = data;
+  PhoshIdleManager *self = timer->manager;
+  g_autoptr (GArray) fired = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  g_debug ("Idle timer for %u msec resumed", timer->interval);
+  timer->idle_since = 0;
+
+  /* Active watches care about resume only and are one shot. Removing
+     the last watch might free the timer so collect them upfront. */
+  for (guint i = 0; i < timer->watches->len; i++) {
+    DBusWatch *watch = g_ptr_array_index (timer->watches, i);
+
+    if (watch->active)
+      g_array_append_val (fired, watch->watch_id);
+  }
+
+  for (guint i = 0; i < fired->len; i++) {
+    guint watch_id = g_array_index (fired, guint, i);
+    DBusWatch *watch = g_hash_table_lookup (self->watches, &watch_id);
 
-  /* Nothing todo here */
-  g_debug ("Idle Timer %d resumed", watch->watch_id);
+    if (!watch)
+      continue;
+
+    g_debug ("Active watch %d fired", watch->watch_id);
+    watch_fire (watch);
+    g_hash_table_remove (self->watches, &watch_id);
+  }
 }
 
 
-/* An DBus idle watch uses an idle_timeout but doesn't care about resume */
 static const struct org_kde_kwin_idle_timeout_listener idle_timer_listener = {
   .idle = idle_timer_idle_cb,
   .resumed = idle_timer_resume_cb,
@@ -119,36 +163,72 @@ static const struct org_kde_kwin_idle_timeout_listener idle_timer_listener = {
 
 
 static void
-active_timer_idle_cb (void *data, struct org_kde_kwin_idle_timeout *timer)
+idle_timer_free (IdleTimer *timer)
+{
+  g_debug ("Releasing idle timer for %u msec", timer->interval);
+  org_kde_kwin_idle_timeout_release (timer->idle_timer);
+  g_ptr_array_free (timer->watches, TRUE);
+  g_free (timer);
+}
+
+
+/* Get the shared timer for the given interval creating it if needed */
+static IdleTimer *
+idle_timer_get (PhoshIdleManager *self, guint32 interval)
 {
-  /* Nothing todo */
+  IdleTimer *timer;
+  PhoshWayland *wl = phosh_wayland_get_default ();
+  struct org_kde_kwin_idle_timeout *idle_timer;
+  struct org_kde_kwin_idle *idle_manager = phosh_wayland_get_org_kde_kwin_idle (wl);
+
+  timer = g_hash_table_lookup (self->timers, GUINT_TO_POINTER (interval));
+  if (timer)
+    return timer;
+
+  idle_timer = org_kde_kwin_idle_get_idle_timeout (idle_manager,
+                                                   phosh_wayland_get_wl_seat (wl),
+                                                   interval);
+  g_return_val_if_fail (idle_timer, NULL);
+
+  timer = g_new0 (IdleTimer, 1);
+  timer->manager = self;
+  timer->idle_timer = idle_timer;
+  timer->interval = interval;
+  timer->watches = g_ptr_array_new ();
+  org_kde_kwin_idle_timeout_add_listener (idle_timer, &idle_timer_listener, timer);
+
+  g_debug ("Created idle timer for %u msec", interval);
+  g_hash_table_insert (self->timers, GUINT_TO_POINTER (interval), timer);
+  return timer;
 }
 
 
 static void
-active_timer_resume_cb(void* data, struct org_kde_kwin_idle_timeout *timer)
+idle_timer_remove_watch (IdleTimer *timer, DBusWatch *watch)
 {
-  DBusWatch *watch = data;
-  GDBusInterfaceSkeleton *skeleton = G_DBUS_INTERFACE_SKELETON (watch->dbus_monitor);
+  g_ptr_array_remove (timer->watches, watch);
 
-  g_debug ("Active Timer %d fired", watch->watch_id);
+  if (timer->watches->len == 0 && !timer->pinned)
+    g_hash_table_remove (timer->manager->timers, GUINT_TO_POINTER (timer->interval));
+}
 
-  g_dbus_connection_emit_signal (g_dbus_interface_skeleton_get_connection (skeleton),
-                                 watch->dbus_name,
-                                 g_dbus_interface_skeleton_get_object_path (skeleton),
-                                 "org.gnome.Mutter.IdleMonitor",
-                                 "WatchFired",
-                                 g_variant_new ("(u)", watch->watch_id),
-                                 NULL);
-  watch_remove (watch);
+
+static void
+watch_client_free (WatchClient *client)
+{
+  g_bus_unwatch_name (client->name_watcher_id);
+  g_free (client->dbus_name);
+  g_free (client);
 }
 
 
-/* An DBus active watch cares about resume only */
-static const struct org_kde_kwin_idle_timeout_listener active_timer_listener = {
-  .idle = active_timer_idle_cb,
-  .resumed = active_timer_resume_cb,
-};
+static gboolean
+is_client_watch (gpointer key, gpointer value, gpointer user_data)
+{
+  DBusWatch *watch = value;
+
+  return watch->client == user_data;
+}
 
 
 static void
@@ -156,78 +236,118 @@ name_vanished_callback (GDBusConnection *connection,
                         const char      *name,
                         gpointer         user_data)
 {
-  watch_remove ((DBusWatch*)user_data);
+  WatchClient *client = user_data;
+  PhoshIdleManager *self = client->manager;
+
+  g_debug ("%s vanished, removing its watches", name);
+  /* Removing the last watch frees the client */
+  g_hash_table_foreach_remove (self->watches, is_client_watch, client);
+}
+
+
+/* Get the client for the sender of the given invocation */
+static WatchClient *
+watch_client_get (PhoshIdleManager *self, GDBusMethodInvocation *invocation)
+{
+  WatchClient *client;
+  const char *sender = g_dbus_method_invocation_get_sender (invocation);
+
+  client = g_hash_table_lookup (self->clients, sender);
+  if (client)
+    return client;
+
+  client = g_new0 (WatchClient, 1);
+  client->manager = self;
+  client->dbus_name = g_strdup (sender);
+  client->name_watcher_id = g_bus_watch_name_on_connection (
+    g_dbus_method_invocation_get_connection (invocation),
+    client->dbus_name,
+    G_BUS_NAME_WATCHER_FLAGS_NONE,
+    NULL, /* appeared */
+    name_vanished_callback,
+    client, NULL);
+
+  g_hash_table_insert (self->clients, client->dbus_name, client);
+  return client;
+}
+
+
+static void
+watch_client_drop_watch (WatchClient *client)
+{
+  g_return_if_fail (client->n_watches > 0);
+
+  client->n_watches--;
+  if (client->n_watches == 0)
+    g_hash_table_remove (client->manager->clients, client->dbus_name);
+}
+
+
+/* cleanup a single watch */
+static void
+watch_dispose (DBusWatch *watch)
+{
+  idle_timer_remove_watch (watch->timer, watch);
+  watch_client_drop_watch (watch->client);
+  g_object_unref (watch->monitor);
+  g_object_unref (watch->dbus_monitor);
+  g_free (watch);
 }
 
 
 static DBusWatch *
-watch_new (PhoshIdleDbusIdleMonitor *skeleton,
+watch_new (PhoshIdleManager         *self,
+           PhoshIdleDbusIdleMonitor *skeleton,
            GDBusMethodInvocation    *invocation,
            PhoshMonitor             *monitor,
-           guint32                  interval)
+           guint32                  interval,
+           gboolean                 active)
 {
   DBusWatch *watch;
   guint32 watch_id;
-  PhoshWayland *wl = phosh_wayland_get_default ();
-  struct org_kde_kwin_idle_timeout *idle_timer;
-  struct org_kde_kwin_idle *idle_manager = phosh_wayland_get_org_kde_kwin_idle (wl);
+  IdleTimer *timer;
 
   watch_id = get_next_dbus_watch_serial ();
   g_return_val_if_fail (watch_id != 0, NULL); /* protect against wrap around */
-  idle_timer = org_kde_kwin_idle_get_idle_timeout(idle_manager,
-                                                  phosh_wayland_get_wl_seat (wl),
-                                                  interval);
-  g_return_val_if_fail (idle_timer, NULL);
+  timer = idle_timer_get (self, interval);
+  g_return_val_if_fail (timer, NULL);
 
   watch = g_new0 (DBusWatch, 1);
   watch->watch_id = watch_id;
-  watch->idle_timer = idle_timer;
+  watch->active = active;
   watch->dbus_monitor = g_object_ref (skeleton);
   watch->monitor = g_object_ref (monitor);
-  watch->dbus_name = g_strdup (g_dbus_method_invocation_get_sender (invocation));
-  watch->name_watcher_id = g_bus_watch_name_on_connection (
-    g_dbus_method_invocation_get_connection (invocation),
-    watch->dbus_name,
-    G_BUS_NAME_WATCHER_FLAGS_NONE,
-    NULL, /* appeared */
-    name_vanished_callback,
-    watch, NULL);
+  watch->timer = timer;
+  g_ptr_array_add (timer->watches, watch);
+  watch->client = watch_client_get (self, invocation);
+  watch->client->n_watches++;
 
+  g_hash_table_insert (self->watches, &watch->watch_id, watch);
   return watch;
 }
 
 
+/* An DBus idle watch uses an idle_timeout but doesn't care about resume */
 static DBusWatch *
-idle_watch_new (PhoshIdleDbusIdleMonitor *skeleton,
+idle_watch_new (PhoshIdleManager         *self,
+                PhoshIdleDbusIdleMonitor *skeleton,
                 GDBusMethodInvocation    *invocation,
                 PhoshMonitor             *monitor,
                 guint32                  interval)
 {
-  DBusWatch *watch;
-
-  watch = watch_new (skeleton, invocation, monitor, interval);
-  g_return_val_if_fail (watch, NULL);
-  org_kde_kwin_idle_timeout_add_listener(watch->idle_timer,
-                                         &idle_timer_listener,
-                                         watch);
-  return watch;
+  return watch_new (self, skeleton, invocation, monitor, interval, FALSE);
 }
 
 
+/* An DBus active watch cares about resume only */
 static DBusWatch *
-active_watch_new (PhoshIdleDbusIdleMonitor *skeleton,
+active_watch_new (PhoshIdleManager         *self,
+                  PhoshIdleDbusIdleMonitor *skeleton,
                   GDBusMethodInvocation    *invocation,
                   PhoshMonitor             *monitor)
 {
-  DBusWatch *watch;
-
   /* Use a idle timer of 0 since we're only interested in the active timer */
-  watch = watch_new (skeleton, invocation, monitor, 0);
-  g_return_val_if_fail (watch, NULL);
-  org_kde_kwin_idle_timeout_add_listener(watch->idle_timer,
-                                         &active_timer_listener,
-                                         watch);
-  return watch;
+  return watch_new (self, skeleton, invocation, monitor, 0, TRUE);
 }
 
 
@@ -249,7 +369,7 @@ handle_add_idle_watch (PhoshIdleDbusIdleMonitor *skeleton,
                                            arg_interval, G_MAXUINT32);
     return TRUE;
   }
-  watch = idle_watch_new (skeleton, invocation, monitor, arg_interval);
+  watch = idle_watch_new (self, skeleton, invocation, monitor, arg_interval);
   if (!watch) {
     g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
                                            G_DBUS_ERROR_LIMITS_EXCEEDED,
@@ -257,10 +377,17 @@ handle_add_idle_watch (PhoshIdleDbusIdleMonitor *skeleton,
     return TRUE;
   }
 
-  g_debug ("Created idle-timer %d for %" G_GUINT64_FORMAT " msec", watch->watch_id, arg_interval);
-  g_hash_table_insert (self->watches, &watch->watch_id, watch);
+  g_debug ("Created idle watch %d for %" G_GUINT64_FORMAT " msec", watch->watch_id, arg_interval);
   phosh_idle_dbus_idle_monitor_complete_add_idle_watch (
     skeleton, invocation, watch->watch_id);
+
+  /* A shared timer that is idle already won't fire again until the
+     next resume. Fire right away (after the reply) like a fresh
+     timer would have for a user that is idle long enough. */
+  if (watch->timer->idle_since) {
+    g_debug ("Idle watch %d fired on %s", watch->watch_id, watch->client->dbus_name);
+    watch_fire (watch);
+  }
   return TRUE;
 }
 
@@ -273,15 +400,14 @@ static gboolean handle_add_user_active_watch (PhoshIdleDbusIdleMonitor *skeleton
   PhoshIdleManager *self = phosh_idle_manager_get_default ();
 
   g_return_val_if_fail (PHOSH_IS_MONITOR (monitor), FALSE);
-  watch = active_watch_new (skeleton, invocation, monitor);
+  watch = active_watch_new (self, skeleton, invocation, monitor);
   if (!watch) {
     g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
                                            G_DBUS_ERROR_LIMITS_EXCEEDED,
                                            "Failed to create watch");
     return TRUE;
   }
-  g_debug ("Creating active timer %d", watch->watch_id);
-  g_hash_table_insert (self->watches, &watch->watch_id, watch);
+  g_debug ("Created active watch %d", watch->watch_id);
   phosh_idle_dbus_idle_monitor_complete_add_user_active_watch (
     skeleton, invocation, watch->watch_id);
   return TRUE;
@@ -293,10 +419,23 @@ handle_get_idle_time (PhoshIdleDbusIdleMonitor *skeleton,
                       GDBusMethodInvocation    *invocation,
                       PhoshMonitor             *monitor)
 {
-  g_debug ("Unimplemented DBus call %s", __func__);
-  g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                         G_DBUS_ERROR_NOT_SUPPORTED,
-                                         "Not supported");
+  PhoshIdleManager *self = phosh_idle_manager_get_default ();
+  GHashTableIter iter;
+  IdleTimer *timer;
+  gint64 now = g_get_monotonic_time ();
+  guint64 idle_time = 0;
+
+  /* The longest timer that went idle gives the best estimate. The
+     tracker makes sure there's always one. */
+  g_hash_table_iter_init (&iter, self->timers);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&timer)) {
+    if (timer->idle_since == 0)
+      continue;
+
+    idle_time = MAX (idle_time, timer->interval + (now - timer->idle_since) / 1000);
+  }
+
+  phosh_idle_dbus_idle_monitor_complete_get_idletime (skeleton, invocation, idle_time);
   return TRUE;
 }
 
@@ -389,8 +528,12 @@ phosh_idle_manager_dispose (GObject *object)
 {
   PhoshIdleManager *self = PHOSH_IDLE_MANAGER (object);
 
-  g_hash_table_destroy (self->watches);
-  g_object_unref (self->manager);
+  /* Watches reference timers and clients so drop them first */
+  g_clear_pointer (&self->watches, g_hash_table_destroy);
+  g_clear_pointer (&self->clients, g_hash_table_destroy);
+  self->tracker = NULL;
+  g_clear_pointer (&self->timers, g_hash_table_destroy);
+  g_clear_object (&self->manager);
   G_OBJECT_CLASS (phosh_idle_manager_parent_class)->dispose (object);
 }
 
@@ -415,6 +558,19 @@ phosh_idle_manager_constructed (GObject *object)
                                          g_int_equal,
                                          NULL,
                                          (GDestroyNotify) watch_dispose);
+  self->timers = g_hash_table_new_full (g_direct_hash,
+                                        g_direct_equal,
+                                        NULL,
+                                        (GDestroyNotify) idle_timer_free);
+  self->clients = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         NULL,
+                                         (GDestroyNotify) watch_client_free);
+
+  /* Keep a timer around so we can answer GetIdletime */
+  self->tracker = idle_timer_get (self, IDLE_TRACKER_INTERVAL);
+  if (self->tracker)
+    self->tracker->pinned = TRUE;
 }
 
 
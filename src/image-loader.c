@@ -0,0 +1,548 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-image-loader"
+
+#include "image-loader.h"
+
+#include <string.h>
+
+/**
+ * SECTION:image-loader
+ * @short_description: Loads and decodes images off the main thread
+ * @Title: PhoshImageLoader
+ *
+ * Loading a #GFileIcon via a #GtkImage makes GTK read and decode the
+ * full sized file synchronously on the main thread. #PhoshImageLoader
+ * instead reads and decodes the image in a worker thread at the size
+ * it will be displayed at and keeps a small cache of the results
+ * keyed by URI and size. Cache entries are validated against the
+ * file's modification time so changed files get reloaded.
+ *
+ * Besides anything GIO can read, `data:` URIs as e.g. used by browsers
+ * for MPRIS album art are supported too.
+ */
+
+#define IMAGE_LOADER_CACHE_SIZE       32
+#define IMAGE_LOADER_DEFAULT_SIZE     48
+#define IMAGE_LOADER_PLACEHOLDER      "image-loading-symbolic"
+#define IMAGE_LOADER_MISSING          "image-missing"
+#define IMAGE_LOADER_CANCELLABLE_KEY  "phosh-image-loader-cancellable"
+
+typedef struct {
+  char      *key;
+  guint64    mtime;
+  GdkPixbuf *pixbuf;
+  GList     *link;
+} CacheEntry;
+
+typedef struct {
+  char *uri;
+  char *key;
+  int   size;
+} LoadData;
+
+struct _PhoshImageLoader {
+  GObject     parent;
+
+  /* The cache is used from the worker threads too */
+  GMutex      lock;
+  GHashTable *cache;
+  GQueue      lru;
+};
+
+G_DEFINE_TYPE (PhoshImageLoader, phosh_image_loader, G_TYPE_OBJECT)
+
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+  g_free (entry->key);
+  g_clear_object (&entry->pixbuf);
+  g_free (entry);
+}
+
+
+static void
+load_data_free (LoadData *data)
+{
+  g_free (data->uri);
+  g_free (data->key);
+  g_free (data);
+}
+
+
+static gboolean
+is_data_uri (const char *uri)
+{
+  return g_str_has_prefix (uri, "data:");
+}
+
+
+static char *
+cache_key (const char *uri, int size)
+{
+  g_autofree char *checksum = NULL;
+
+  /* data: URIs can be huge, no need to keep them around */
+  if (is_data_uri (uri)) {
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, uri, -1);
+    return g_strdup_printf ("%d:data:%s", size, checksum);
+  }
+
+  return g_strdup_printf ("%d:%s", size, uri);
+}
+
+
+/* Decode data:[<mediatype>][;base64],<data> */
+static GBytes *
+decode_data_uri (const char *uri, GError **err)
+{
+  const char *comma = strchr (uri, ',');
+  g_autofree char *header = NULL;
+  guchar *decoded;
+  gsize len;
+
+  if (comma == NULL) {
+    g_set_error (err, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Malformed data URI");
+    return NULL;
+  }
+
+  header = g_strndup (uri + strlen ("data:"), comma - uri - strlen ("data:"));
+  if (g_str_has_suffix (header, ";base64")) {
+    decoded = g_base64_decode (comma + 1, &len);
+  } else {
+    decoded = (guchar *) g_uri_unescape_string (comma + 1, NULL);
+    len = decoded ? strlen ((char *) decoded) : 0;
+  }
+
+  if (decoded == NULL || len == 0) {
+    g_free (decoded);
+    g_set_error (err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid data URI payload");
+    return NULL;
+  }
+
+  return g_bytes_new_take (decoded, len);
+}
+
+
+static GdkPixbuf *
+decode_stream (GInputStream *stream, int size, GCancellable *cancellable, GError **err)
+{
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+
+  /* Lets the decoder downscale while decoding (e.g. for JPEG) */
+  pixbuf = gdk_pixbuf_new_from_stream_at_scale (stream,
+                                                size,
+                                                size,
+                                                TRUE,
+                                                cancellable,
+                                                err);
+  if (pixbuf == NULL)
+    return NULL;
+
+  return gdk_pixbuf_apply_embedded_orientation (pixbuf);
+}
+
+
+static void
+load_data_uri (PhoshImageLoader *self,
+               GTask            *task,
+               LoadData         *data,
+               GCancellable     *cancellable)
+{
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GInputStream) stream = NULL;
+  GdkPixbuf *pixbuf;
+  GError *err = NULL;
+
+  /* Contents can't change so no need for any validation */
+  pixbuf = cache_lookup (self, data->key, FALSE, 0);
+  if (pixbuf) {
+    g_task_return_pointer (task, pixbuf, g_object_unref);
+    return;
+  }
+
+  bytes = decode_data_uri (data->uri, &err);
+  if (bytes == NULL) {
+    g_task_return_error (task, err);
+    return;
+  }
+
+  stream = g_memory_input_stream_new_from_bytes (bytes);
+  pixbuf = decode_stream (stream, data->size, cancellable, &err);
+  if (pixbuf == NULL) {
+    g_task_return_error (task, err);
+    return;
+  }
+
+  cache_insert (self, data->key, 0, pixbuf);
+  g_task_return_pointer (task, pixbuf, g_object_unref);
+}
+
+
+/* Must be called with the lock held */
+static void
+cache_touch (PhoshImageLoader *self, CacheEntry *entry)
+{
+  g_queue_unlink (&self->lru, entry->link);
+  g_queue_push_head_link (&self->lru, entry->link);
+}
+
+
+static GdkPixbuf *
+cache_lookup (PhoshImageLoader *self, const char *key, gboolean check_mtime, guint64 mtime)
+{
+  GdkPixbuf *pixbuf = NULL;
+  CacheEntry *entry;
+
+  g_mutex_lock (&self->lock);
+  entry = g_hash_table_lookup (self->cache, key);
+  if (entry && (!check_mtime || entry->mtime == mtime)) {
+    cache_touch (self, entry);
+    pixbuf = g_object_ref (entry->pixbuf);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return pixbuf;
+}
+
+
+static void
+cache_insert (PhoshImageLoader *self, const char *key, guint64 mtime, GdkPixbuf *pixbuf)
+{
+  CacheEntry *entry;
+
+  g_mutex_lock (&self->lock);
+  entry = g_hash_table_lookup (self->cache, key);
+  if (entry) {
+    g_set_object (&entry->pixbuf, pixbuf);
+    entry->mtime = mtime;
+    cache_touch (self, entry);
+  } else {
+    entry = g_new0 (CacheEntry, 1);
+    entry->key = g_strdup (key);
+    entry->mtime = mtime;
+    entry->pixbuf = g_object_ref (pixbuf);
+    g_queue_push_head (&self->lru, entry);
+    entry->link = self->lru.head;
+    g_hash_table_insert (self->cache, entry->key, entry);
+  }
+
+  while (g_queue_get_length (&self->lru) > IMAGE_LOADER_CACHE_SIZE) {
+    CacheEntry *old = g_queue_pop_tail (&self->lru);
+
+    g_hash_table_remove (self->cache, old->key);
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+
+static void
+load_thread (GTask        *task,
+             gpointer      source_object,
+             gpointer      task_data,
+             GCancellable *cancellable)
+{
+  PhoshImageLoader *self = PHOSH_IMAGE_LOADER (source_object);
+  LoadData *data = task_data;
+  g_autoptr (GFile) file = NULL;
+  g_autoptr (GFileInfo) info = NULL;
+  g_autoptr (GFileInputStream) stream = NULL;
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+  GdkPixbuf *oriented;
+  GError *err = NULL;
+  guint64 mtime;
+
+  if (is_data_uri (data->uri)) {
+    load_data_uri (self, task, data, cancellable);
+    return;
+  }
+
+  file = g_file_new_for_uri (data->uri);
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                            G_FILE_QUERY_INFO_NONE,
+                            cancellable,
+                            &err);
+  if (info == NULL) {
+    g_task_return_error (task, err);
+    return;
+  }
+  mtime = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+    g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+
+  pixbuf = cache_lookup (self, data->key, TRUE, mtime);
+  if (pixbuf) {
+    g_task_return_pointer (task, g_steal_pointer (&pixbuf), g_object_unref);
+    return;
+  }
+
+  stream = g_file_read (file, cancellable, &err);
+  if (stream == NULL) {
+    g_task_return_error (task, err);
+    return;
+  }
+
+  oriented = decode_stream (G_INPUT_STREAM (stream), data->size, cancellable, &err);
+  if (oriented == NULL) {
+    g_task_return_error (task, err);
+    return;
+  }
+
+  cache_insert (self, data->key, mtime, oriented);
+  g_task_return_pointer (task, oriented, g_object_unref);
+}
+
+
+static void
+cancel_and_unref (gpointer data)
+{
+  g_cancellable_cancel (G_CANCELLABLE (data));
+  g_object_unref (data);
+}
+
+
+static void
+on_image_loaded (GObject      *source_object,
+                 GAsyncResult *res,
+                 gpointer      user_data)
+{
+  g_autoptr (GtkImage) image = GTK_IMAGE (user_data);
+  g_autoptr (GdkPixbuf) pixbuf = NULL;
+  g_autoptr (GError) err = NULL;
+  GIcon *current = NULL;
+
+  pixbuf = phosh_image_loader_load_finish (PHOSH_IMAGE_LOADER (source_object), res, &err);
+  if (pixbuf == NULL) {
+    g_autoptr (GIcon) missing = NULL;
+
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      return;
+
+    g_debug ("Failed to load image: %s", err->message);
+    missing = g_themed_icon_new (IMAGE_LOADER_MISSING);
+    g_object_set (image, "gicon", missing, NULL);
+    return;
+  }
+
+  if (gtk_image_get_storage_type (image) == GTK_IMAGE_GICON)
+    gtk_image_get_gicon (image, &current, NULL);
+
+  /* Already showing the cached image */
+  if (current == G_ICON (pixbuf))
+    return;
+
+  g_object_set (image, "gicon", pixbuf, NULL);
+}
+
+
+static void
+phosh_image_loader_finalize (GObject *object)
+{
+  PhoshImageLoader *self = PHOSH_IMAGE_LOADER (object);
+
+  g_queue_clear (&self->lru);
+  g_clear_pointer (&self->cache, g_hash_table_destroy);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (phosh_image_loader_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_image_loader_class_init (PhoshImageLoaderClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = phosh_image_loader_finalize;
+}
+
+
+static void
+phosh_image_loader_init (PhoshImageLoader *self)
+{
+  g_mutex_init (&self->lock);
+  g_queue_init (&self->lru);
+  self->cache = g_hash_table_new_full (g_str_hash,
+                                       g_str_equal,
+                                       NULL,
+                                       (GDestroyNotify) cache_entry_free);
+}
+
+
+/**
+ * phosh_image_loader_get_default:
+ *
+ * Get the image loader singleton
+ *
+ * Returns:(transfer none): The image loader singleton
+ */
+PhoshImageLoader *
+phosh_image_loader_get_default (void)
+{
+  static PhoshImageLoader *instance;
+
+  if (instance == NULL) {
+    instance = g_object_new (PHOSH_TYPE_IMAGE_LOADER, NULL);
+    g_object_add_weak_pointer (G_OBJECT (instance), (gpointer *)&instance);
+  }
+
+  return instance;
+}
+
+
+/**
+ * phosh_image_loader_load_async:
+ * @self: The #PhoshImageLoader
+ * @uri: The URI of the image to load
+ * @size: The size in pixels the image should fit into
+ * @cancellable: (nullable): A #GCancellable
+ * @callback: The callback to invoke when done
+ * @user_data: Data passed to @callback
+ *
+ * Load the image at @uri in a worker thread scaling it to fit into
+ * @size x @size pixels while keeping the aspect ratio.
+ */
+void
+phosh_image_loader_load_async (PhoshImageLoader    *self,
+                               const char          *uri,
+                               int                  size,
+                               GCancellable        *cancellable,
+                               GAsyncReadyCallback  callback,
+                               gpointer             user_data)
+{
+  g_autoptr (GTask) task = NULL;
+  LoadData *data;
+
+  g_return_if_fail (PHOSH_IS_IMAGE_LOADER (self));
+  g_return_if_fail (uri);
+  g_return_if_fail (size > 0);
+
+  data = g_new0 (LoadData, 1);
+  data->uri = g_strdup (uri);
+  data->key = cache_key (uri, size);
+  data->size = size;
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (task, phosh_image_loader_load_async);
+  g_task_set_task_data (task, data, (GDestroyNotify) load_data_free);
+  g_task_run_in_thread (task, load_thread);
+}
+
+
+/**
+ * phosh_image_loader_load_finish:
+ * @self: The #PhoshImageLoader
+ * @result: The #GAsyncResult
+ * @error: Return location for a #GError
+ *
+ * Finish an image load started with phosh_image_loader_load_async().
+ *
+ * Returns: (transfer full): The decoded image or %NULL on error.
+ */
+GdkPixbuf *
+phosh_image_loader_load_finish (PhoshImageLoader  *self,
+                                GAsyncResult      *result,
+                                GError           **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+
+/**
+ * phosh_image_loader_lookup:
+ * @self: The #PhoshImageLoader
+ * @uri: The URI of the image
+ * @size: The size in pixels the image was loaded at
+ *
+ * Looks up a previously loaded image without doing any I/O. The
+ * returned image might be outdated if the file changed on disk since.
+ *
+ * Returns: (transfer full) (nullable): The cached image or %NULL
+ */
+GdkPixbuf *
+phosh_image_loader_lookup (PhoshImageLoader *self, const char *uri, int size)
+{
+  g_autofree char *key = NULL;
+
+  g_return_val_if_fail (PHOSH_IS_IMAGE_LOADER (self), NULL);
+  g_return_val_if_fail (uri, NULL);
+
+  key = cache_key (uri, size);
+  return cache_lookup (self, key, FALSE, 0);
+}
+
+
+/**
+ * phosh_image_loader_get_icon:
+ * @self: The #PhoshImageLoader
+ * @icon: (nullable): The icon that should be shown in @image
+ * @image: The #GtkImage to display @icon in
+ *
+ * Returns the icon to display in @image right away. This is meant to
+ * be used as a binding's transform function for #GtkImage:gicon. If
+ * @icon is file backed a cached copy or a placeholder is returned and
+ * the image is loaded in a worker thread at @image's pixel size. Once
+ * loaded @image is updated. Any previous load for @image is cancelled.
+ *
+ * Returns: (transfer full) (nullable): The icon to show in @image now
+ */
+GIcon *
+phosh_image_loader_get_icon (PhoshImageLoader *self, GIcon *icon, GtkImage *image)
+{
+  g_autoptr (GCancellable) cancel = NULL;
+  g_autofree char *uri = NULL;
+  GdkPixbuf *cached;
+  int size;
+
+  g_return_val_if_fail (PHOSH_IS_IMAGE_LOADER (self), NULL);
+  g_return_val_if_fail (GTK_IS_IMAGE (image), NULL);
+
+  phosh_image_loader_cancel (image);
+
+  if (!G_IS_FILE_ICON (icon))
+    return icon ? g_object_ref (icon) : NULL;
+
+  uri = g_file_get_uri (g_file_icon_get_file (G_FILE_ICON (icon)));
+  size = gtk_image_get_pixel_size (image);
+  if (size <= 0)
+    size = IMAGE_LOADER_DEFAULT_SIZE;
+  size *= gtk_widget_get_scale_factor (GTK_WIDGET (image));
+
+  cancel = g_cancellable_new ();
+  g_object_set_data_full (G_OBJECT (image),
+                          IMAGE_LOADER_CANCELLABLE_KEY,
+                          g_object_ref (cancel),
+                          cancel_and_unref);
+  phosh_image_loader_load_async (self, uri, size, cancel, on_image_loaded, g_object_ref (image));
+
+  cached = phosh_image_loader_lookup (self, uri, size);
+  if (cached)
+    return G_ICON (cached);
+
+  return g_themed_icon_new (IMAGE_LOADER_PLACEHOLDER);
+}
+
+
+/**
+ * phosh_image_loader_cancel:
+ * @image: A #GtkImage
+ *
+ * Cancels the load started by phosh_image_loader_get_icon() for
+ * @image (if any). Use this when showing something else in @image so
+ * the loaded image doesn't replace it later on.
+ */
+void
+phosh_image_loader_cancel (GtkImage *image)
+{
+  g_return_if_fail (GTK_IS_IMAGE (image));
+
+  g_object_set_data (G_OBJECT (image), IMAGE_LOADER_CANCELLABLE_KEY, NULL);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_IMAGE_LOADER (phosh_image_loader_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshImageLoader, phosh_image_loader, PHOSH, IMAGE_LOADER, GObject)
+
+PhoshImageLoader *phosh_image_loader_get_default (void);
+void              phosh_image_loader_load_async  (PhoshImageLoader    *self,
+                                                  const char          *uri,
+                                                  int                  size,
+                                                  GCancellable        *cancellable,
+                                                  GAsyncReadyCallback  callback,
+                                                  gpointer             user_data);
+GdkPixbuf        *phosh_image_loader_load_finish (PhoshImageLoader    *self,
+                                                  GAsyncResult        *result,
+                                                  GError             **error);
+GdkPixbuf        *phosh_image_loader_lookup      (PhoshImageLoader    *self,
+                                                  const char          *uri,
+                                                  int                  size);
+GIcon            *phosh_image_loader_get_icon    (PhoshImageLoader    *self,
+                                                  GIcon               *icon,
+                                                  GtkImage            *image);
+void              phosh_image_loader_cancel      (GtkImage            *image);
+
+G_END_DECLS
@@ -66,11 +66,29 @@ typedef struct {
   char                         *namespace;
   struct zwlr_layer_shell_v1   *layer_shell;
   struct wl_output             *wl_output;
+
+  /* Transactions */
+  guint                         transaction_depth;
+  gboolean                      commit_pending;
+  gboolean                      redraw_pending;
+
+  /* Content translation used for animations */
+  int                           offset_x, offset_y;
 } PhoshLayerSurfacePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshLayerSurface, phosh_layer_surface, GTK_TYPE_WINDOW)
 
 
+/* A surface state change was sent, it needs a commit to become effective */
+static void
+queue_commit (PhoshLayerSurface *self)
+{
+  PhoshLayerSurfacePrivate *priv = phosh_layer_surface_get_instance_private (self);
+
+  priv->commit_pending = TRUE;
+}
+
+
 static void
 layer_surface_configure (void                         *data,
                          struct zwlr_layer_surface_v1 *surface,
@@ -80,10 +98,15 @@ layer_surface_configure (void                         *data,
 {
   PhoshLayerSurface *self = data;
   PhoshLayerSurfacePrivate *priv;
+  int current_width, current_height;
 
   g_return_if_fail (PHOSH_IS_LAYER_SURFACE (self));
   priv = phosh_layer_surface_get_instance_private (self);
-  gtk_window_resize (GTK_WINDOW (self), width, height);
+
+  /* Avoid a needless size allocation cycle when e.g. only margins changed */
+  gtk_window_get_size (GTK_WINDOW (self), &current_width, &current_height);
+  if (current_width != width || current_height != height)
+    gtk_window_resize (GTK_WINDOW (self), width, height);
   zwlr_layer_surface_v1_ack_configure (surface, serial);
 
   if (priv->configured_height != height) {
@@ -326,7 +349,8 @@ on_phosh_layer_surface_unmapped (PhoshLayerSurface *self, gpointer unused)
   g_return_if_fail (PHOSH_IS_LAYER_SURFACE (self));
   priv = phosh_layer_surface_get_instance_private (self);
 
-  priv = phosh_layer_surface_get_instance_private (self);
+  /* No frame will be drawn that would pick up pending state */
+  priv->redraw_pending = FALSE;
   if (priv->layer_surface) {
     zwlr_layer_surface_v1_destroy (priv->layer_surface);
     priv->layer_surface = NULL;
@@ -354,6 +378,35 @@ phosh_layer_surface_constructed (GObject *object)
 }
 
 
+static gboolean
+phosh_layer_surface_draw (GtkWidget *widget, cairo_t *cr)
+{
+  PhoshLayerSurface *self = PHOSH_LAYER_SURFACE (widget);
+  PhoshLayerSurfacePrivate *priv = phosh_layer_surface_get_instance_private (self);
+  gboolean ret;
+
+  /* The new frame's commit picks up any pending layer surface state */
+  priv->redraw_pending = FALSE;
+  priv->commit_pending = FALSE;
+
+  if (priv->offset_x == 0 && priv->offset_y == 0)
+    return GTK_WIDGET_CLASS (phosh_layer_surface_parent_class)->draw (widget, cr);
+
+  cairo_save (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.0);
+  cairo_paint (cr);
+  cairo_restore (cr);
+
+  cairo_save (cr);
+  cairo_translate (cr, priv->offset_x, priv->offset_y);
+  ret = GTK_WIDGET_CLASS (phosh_layer_surface_parent_class)->draw (widget, cr);
+  cairo_restore (cr);
+
+  return ret;
+}
+
+
 static void
 phosh_layer_surface_dispose (GObject *object)
 {
@@ -374,10 +427,13 @@ static void
 phosh_layer_surface_class_init (PhoshLayerSurfaceClass *klass)
 {
   GObjectClass *object_class = (GObjectClass *)klass;
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
   object_class->constructed = phosh_layer_surface_constructed;
   object_class->dispose = phosh_layer_surface_dispose;
 
+  widget_class->draw = phosh_layer_surface_draw;
+
   object_class->set_property = phosh_layer_surface_set_property;
   object_class->get_property = phosh_layer_surface_get_property;
 
@@ -620,6 +676,7 @@ phosh_layer_surface_set_size (PhoshLayerSurface *self, int width, int height)
 
   if (gtk_widget_get_mapped (GTK_WIDGET (self))) {
     zwlr_layer_surface_v1_set_size (priv->layer_surface, priv->width, priv->height);
+    queue_commit (self);
   }
 
   if (priv->height != old_height)
@@ -657,8 +714,10 @@ phosh_layer_surface_set_margins (PhoshLayerSurface *self, int top, int right, in
   priv->margin_right = right;
   priv->margin_bottom = bottom;
 
-  if (priv->layer_surface)
+  if (priv->layer_surface) {
     zwlr_layer_surface_v1_set_margin (priv->layer_surface, top, right, bottom, left);
+    queue_commit (self);
+  }
 
   if (old_top != top)
     g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_LAYER_SURFACE_PROP_MARGIN_TOP]);
@@ -692,8 +751,10 @@ phosh_layer_surface_set_exclusive_zone (PhoshLayerSurface *self, int zone)
 
   priv->exclusive_zone = zone;
 
-  if (priv->layer_surface)
+  if (priv->layer_surface) {
     zwlr_layer_surface_v1_set_exclusive_zone (priv->layer_surface, zone);
+    queue_commit (self);
+  }
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_LAYER_SURFACE_PROP_EXCLUSIVE_ZONE]);
 }
@@ -717,8 +778,10 @@ phosh_layer_surface_set_kbd_interactivity (PhoshLayerSurface *self, gboolean int
 
   priv->kbd_interactivity = interactivity;
 
-  if (priv->layer_surface)
+  if (priv->layer_surface) {
     zwlr_layer_surface_v1_set_keyboard_interactivity (priv->layer_surface, interactivity);
+    queue_commit (self);
+  }
 
   g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_LAYER_SURFACE_PROP_KBD_INTERACTIVITY]);
 }
@@ -739,4 +802,120 @@ phosh_layer_surface_wl_surface_commit (PhoshLayerSurface *self)
 
   if (priv->wl_surface)
     wl_surface_commit (priv->wl_surface);
+  priv->commit_pending = FALSE;
+}
+
+
+/**
+ * phosh_layer_surface_begin:
+ * @self: The layer surface
+ *
+ * Starts a transaction. Changes to the layer surface's state like
+ * margins or exclusive zone made until the matching
+ * phosh_layer_surface_commit() are applied by the compositor
+ * atomically with a single surface commit. Transactions can be nested.
+ */
+void
+phosh_layer_surface_begin (PhoshLayerSurface *self)
+{
+  PhoshLayerSurfacePrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_LAYER_SURFACE (self));
+  priv = phosh_layer_surface_get_instance_private (self);
+
+  priv->transaction_depth++;
+}
+
+
+/**
+ * phosh_layer_surface_commit:
+ * @self: The layer surface
+ *
+ * Ends a transaction started with phosh_layer_surface_begin(). When
+ * the outermost transaction ends and the layer surface's state changed
+ * the surface is committed. If nothing changed no commit is sent. If
+ * a redraw is pending (e.g. since the content offset changed) the
+ * state is committed together with the next frame instead so both
+ * become visible at once.
+ */
+void
+phosh_layer_surface_commit (PhoshLayerSurface *self)
+{
+  PhoshLayerSurfacePrivate *priv;
+
+  g_return_if_fail (PHOSH_IS_LAYER_SURFACE (self));
+  priv = phosh_layer_surface_get_instance_private (self);
+  g_return_if_fail (priv->transaction_depth > 0);
+
+  priv->transaction_depth--;
+  if (priv->transaction_depth)
+    return;
+
+  if (!priv->commit_pending)
+    return;
+
+  /* Hidden surfaces don't draw so don't wait for a frame */
+  if (!priv->redraw_pending || !gtk_widget_is_drawable (GTK_WIDGET (self))) {
+    priv->redraw_pending = FALSE;
+    phosh_layer_surface_wl_surface_commit (self);
+  }
+}
+
+
+/**
+ * phosh_layer_surface_set_content_offset:
+ * @self: The layer surface
+ * @x: The horizontal offset in pixels
+ * @y: The vertical offset in pixels
+ *
+ * Draws the surface's content translated by @x and @y. Areas not
+ * covered by content are transparent. Since neither the surface's size
+ * nor its position change this allows to animate e.g. sliding in
+ * content without any configure round trips or size allocations.
+ *
+ * Input is limited to the area covered by content but not translated
+ * so this is only meant to be used while animating.
+ */
+void
+phosh_layer_surface_set_content_offset (PhoshLayerSurface *self, int x, int y)
+{
+  PhoshLayerSurfacePrivate *priv;
+  GdkWindow *window;
+
+  g_return_if_fail (PHOSH_IS_LAYER_SURFACE (self));
+  priv = phosh_layer_surface_get_instance_private (self);
+
+  if (priv->offset_x == x && priv->offset_y == y)
+    return;
+
+  priv->offset_x = x;
+  priv->offset_y = y;
+
+  /* Parts of the surface become transparent. The opaque region is
+     restored by GTK on the next size allocation. */
+  window = gtk_widget_get_window (GTK_WIDGET (self));
+  if (window && (x || y)) {
+    cairo_rectangle_int_t bounds = {
+      0, 0,
+      gtk_widget_get_allocated_width (GTK_WIDGET (self)),
+      gtk_widget_get_allocated_height (GTK_WIDGET (self)),
+    };
+    cairo_rectangle_int_t content = { x, y, bounds.width, bounds.height };
+    cairo_region_t *region;
+
+    gdk_window_set_opaque_region (window, NULL);
+    /* Don't take input on the transparent parts */
+    region = cairo_region_create_rectangle (&content);
+    cairo_region_intersect_rectangle (region, &bounds);
+    gdk_window_input_shape_combine_region (window, region, 0, 0);
+    cairo_region_destroy (region);
+  } else if (window) {
+    gdk_window_input_shape_combine_region (window, NULL, 0, 0);
+  }
+
+  if (!gtk_widget_is_drawable (GTK_WIDGET (self)))
+    return;
+
+  priv->redraw_pending = TRUE;
+  gtk_widget_queue_draw (GTK_WIDGET (self));
 }
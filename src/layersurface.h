@@ -44,3 +44,8 @@ void                              phosh_layer_surface_set_exclusive_zone(PhoshLa
 void                              phosh_layer_surface_set_kbd_interactivity(PhoshLayerSurface *self,
                                                                             gboolean interactivity);
 void                              phosh_layer_surface_wl_surface_commit (PhoshLayerSurface *self);
+void                              phosh_layer_surface_begin (PhoshLayerSurface *self);
+void                              phosh_layer_surface_commit (PhoshLayerSurface *self);
+void                              phosh_layer_surface_set_content_offset (PhoshLayerSurface *self,
+                                                                          int                x,
+                                                                          int                y);
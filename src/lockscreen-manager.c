@@ -15,6 +15,7 @@
 #include "monitor/monitor.h"
 #include "phosh-wayland.h"
 #include "shell.h"
+#include "trace.h"
 #include "util.h"
 #include "session-presence.h"
 #include <gdk/gdkwayland.h>
@@ -23,6 +24,11 @@
  * SECTION:lockscreen-manager
  * @short_description: The singleton that manages screen locking
  * @Title: PhoshLockscreenManager
+ *
+ * To lock the screen without delay the lock screen and the shields for
+ * the other outputs are built ahead of time when idle and only mapped
+ * when locking. They're rebuilt when the monitor configuration
+ * changes.
  */
 
 /* See https://people.gnome.org/~mccann/gnome-session/docs/gnome-session.html#org.gnome.SessionManager.Presence:status */
@@ -56,6 +62,13 @@ typedef struct {
   gboolean locked;
   gint64 active_time;              /* when lock was activated (in us) */
   int rotation;                    /* the shell rotation before locking */
+
+  PhoshMonitor *primary;           /* the monitor the lock screen was built for */
+  guint prewarm_id;
+  gboolean stale;                  /* monitors changed while locked */
+  gboolean monitors_connected;
+  gint64 lock_begin;               /* when locking was requested (in us) */
+  gboolean lock_prewarmed;
 } PhoshLockscreenManagerPrivate;
 
 
@@ -67,30 +80,8 @@ typedef struct _PhoshLockscreenManager {
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshLockscreenManager, phosh_lockscreen_manager, G_TYPE_OBJECT)
 
 
-static void
-lockscreen_unlock_cb (PhoshLockscreenManager *self, PhoshLockscreen *lockscreen)
-{
-  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
-  PhoshShell *shell = phosh_shell_get_default ();
-  PhoshMonitorManager *monitor_manager = phosh_shell_get_monitor_manager (shell);
-
-  phosh_shell_rotate_display (shell, priv->rotation);
-  priv->rotation = 0;
-
-  g_return_if_fail (PHOSH_IS_LOCKSCREEN (lockscreen));
-  g_return_if_fail (lockscreen == PHOSH_LOCKSCREEN (priv->lockscreen));
-
-  g_signal_handlers_disconnect_by_data (lockscreen, self);
-  g_signal_handlers_disconnect_by_data (monitor_manager, self);
-  g_clear_pointer (&priv->lockscreen, phosh_cp_widget_destroy);
-
-  /* Unlock all other outputs */
-  g_clear_pointer (&priv->shields, g_ptr_array_unref);
-
-  priv->locked = FALSE;
-  priv->active_time = 0;
-  g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_LOCKSCREEN_MANAGER_PROP_LOCKED]);
-}
+static void lockscreen_unlock_cb (PhoshLockscreenManager *self, PhoshLockscreen *lockscreen);
+static void schedule_prewarm (PhoshLockscreenManager *self);
 
 
 static void
@@ -104,10 +95,26 @@ lockscreen_wakeup_output_cb (PhoshLockscreenManager *self, PhoshLockscreen *lock
 }
 
 
-/* Lock a particular monitor bringing up a shield */
 static void
-lock_monitor (PhoshLockscreenManager *self,
-              PhoshMonitor           *monitor)
+lockscreen_configured_cb (PhoshLockscreenManager *self, PhoshLockscreen *lockscreen)
+{
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+
+  if (!priv->lock_begin)
+    return;
+
+  g_debug ("Lock screen mapped after %" G_GINT64_FORMAT "us (%s)",
+           phosh_trace_now () - priv->lock_begin,
+           priv->lock_prewarmed ? "prewarmed" : "cold");
+  phosh_trace_mark ("lock", priv->lock_begin, "%s", priv->lock_prewarmed ? "prewarmed" : "cold");
+  priv->lock_begin = 0;
+}
+
+
+/* Build a shield for a particular monitor */
+static GtkWidget *
+add_shield (PhoshLockscreenManager *self,
+            PhoshMonitor           *monitor)
 {
   PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
   PhoshWayland *wl = phosh_wayland_get_default ();
@@ -118,21 +125,57 @@ lock_monitor (PhoshLockscreenManager *self,
     monitor->wl_output);
 
   g_ptr_array_add (priv->shields, shield);
-  gtk_widget_show (shield);
+  return shield;
 }
 
 
 static void
-on_monitor_removed (PhoshLockscreenManager *self,
-                    PhoshMonitor           *monitor,
-                    PhoshMonitorManager    *monitormanager)
+drop_prewarmed (PhoshLockscreenManager *self)
 {
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+
+  g_return_if_fail (!priv->locked);
+
+  g_clear_pointer (&priv->shields, g_ptr_array_unref);
+  if (priv->lockscreen) {
+    g_signal_handlers_disconnect_by_data (priv->lockscreen, self);
+    g_clear_pointer (&priv->lockscreen, phosh_cp_widget_destroy);
+  }
+  g_clear_object (&priv->primary);
+  priv->stale = FALSE;
+}
+
+
+static void
+on_monitors_changed (PhoshLockscreenManager *self,
+                     PhoshMonitor           *monitor,
+                     PhoshMonitorManager    *monitormanager)
+{
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+
   g_return_if_fail (PHOSH_IS_MONITOR (monitor));
   g_return_if_fail (PHOSH_IS_LOCKSCREEN_MANAGER (self));
 
+  if (priv->locked) {
+    /* Rebuild once unlocked */
+    priv->stale = TRUE;
+    return;
+  }
+
+  drop_prewarmed (self);
+  schedule_prewarm (self);
+}
+
+
+static void
+on_monitor_removed (PhoshLockscreenManager *self,
+                    PhoshMonitor           *monitor,
+                    PhoshMonitorManager    *monitormanager)
+{
   g_debug ("Monitor removed");
-  /* TODO: We just leave the widget dangling, it will be destroyed on
-   * unlock */
+  /* TODO: When locked we just leave the widget dangling, it will be
+   * destroyed on unlock */
+  on_monitors_changed (self, monitor, monitormanager);
 }
 
 
@@ -141,50 +184,53 @@ on_monitor_added (PhoshLockscreenManager *self,
                   PhoshMonitor           *monitor,
                   PhoshMonitorManager    *monitormanager)
 {
-  g_return_if_fail (PHOSH_IS_MONITOR (monitor));
-  g_return_if_fail (PHOSH_IS_LOCKSCREEN_MANAGER (self));
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
 
-  g_warning ("Monitor added");
-  lock_monitor (self, monitor);
+  g_debug ("Monitor added");
+  if (priv->locked)
+    gtk_widget_show (add_shield (self, monitor));
+
+  on_monitors_changed (self, monitor, monitormanager);
 }
 
 
+/* Build the lock screen and shields without mapping them */
 static void
-lockscreen_lock (PhoshLockscreenManager *self)
+prewarm (PhoshLockscreenManager *self)
 {
   PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
-  PhoshMonitor *primary_monitor;
-  PhoshWayland *wl = phosh_wayland_get_default ();
   PhoshShell *shell = phosh_shell_get_default ();
   PhoshMonitorManager *monitor_manager = phosh_shell_get_monitor_manager (shell);
+  PhoshWayland *wl = phosh_wayland_get_default ();
+  PhoshMonitor *primary_monitor;
+  gint64 begin = phosh_trace_now ();
 
-  g_return_if_fail (!priv->locked);
+  g_return_if_fail (priv->lockscreen == NULL);
 
   primary_monitor = phosh_shell_get_primary_monitor (shell);
   g_return_if_fail (primary_monitor);
 
-  /* Undo any rotation so the keypad becomes usable */
-  priv->rotation = phosh_shell_get_rotation (shell);
-  phosh_shell_rotate_display (shell, 0);
-
   /* Listen for monitor changes */
-  g_signal_connect_object (monitor_manager, "monitor-added",
-                           G_CALLBACK (on_monitor_added),
-                           self,
-                           G_CONNECT_SWAPPED);
-
-  g_signal_connect_object (monitor_manager, "monitor-removed",
-                           G_CALLBACK (on_monitor_removed),
-                           self,
-                           G_CONNECT_SWAPPED);
+  if (!priv->monitors_connected) {
+    g_signal_connect_object (monitor_manager, "monitor-added",
+                             G_CALLBACK (on_monitor_added),
+                             self,
+                             G_CONNECT_SWAPPED);
+
+    g_signal_connect_object (monitor_manager, "monitor-removed",
+                             G_CALLBACK (on_monitor_removed),
+                             self,
+                             G_CONNECT_SWAPPED);
+    priv->monitors_connected = TRUE;
+  }
 
   /* The primary output gets the clock, keypad, ... */
   priv->lockscreen = PHOSH_LOCKSCREEN (phosh_lockscreen_new (
                                          phosh_wayland_get_zwlr_layer_shell_v1(wl),
                                          primary_monitor->wl_output));
-  gtk_widget_show (GTK_WIDGET (priv->lockscreen));
+  g_set_object (&priv->primary, primary_monitor);
 
-  /* Lock all other outputs */
+  /* Shields for all other outputs */
   priv->shields = g_ptr_array_new_with_free_func ((GDestroyNotify) (gtk_widget_destroy));
 
   for (int i = 0; i < phosh_monitor_manager_get_num_monitors (monitor_manager); i++) {
@@ -192,15 +238,112 @@ lockscreen_lock (PhoshLockscreenManager *self)
 
     if (monitor == NULL || monitor == primary_monitor)
       continue;
-    lock_monitor (self, monitor);
+    add_shield (self, monitor);
   }
 
   g_object_connect (
     priv->lockscreen,
     "swapped-object-signal::lockscreen-unlock", G_CALLBACK(lockscreen_unlock_cb), self,
     "swapped-object-signal::wakeup-output", G_CALLBACK(lockscreen_wakeup_output_cb), self,
+    "swapped-object-signal::configured", G_CALLBACK(lockscreen_configured_cb), self,
     NULL);
 
+  phosh_trace_mark ("lockscreen-prewarm", begin, "%u shields", priv->shields->len);
+}
+
+
+static gboolean
+on_prewarm_idle (PhoshLockscreenManager *self)
+{
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+
+  priv->prewarm_id = 0;
+  if (!priv->locked && priv->lockscreen == NULL)
+    prewarm (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+schedule_prewarm (PhoshLockscreenManager *self)
+{
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+
+  if (priv->prewarm_id)
+    return;
+
+  priv->prewarm_id = g_idle_add_full (G_PRIORITY_LOW,
+                                      (GSourceFunc) on_prewarm_idle,
+                                      self,
+                                      NULL);
+  g_source_set_name_by_id (priv->prewarm_id, "[phosh] prewarm lockscreen");
+}
+
+
+static void
+lockscreen_unlock_cb (PhoshLockscreenManager *self, PhoshLockscreen *lockscreen)
+{
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+  PhoshShell *shell = phosh_shell_get_default ();
+
+  phosh_shell_rotate_display (shell, priv->rotation);
+  priv->rotation = 0;
+
+  g_return_if_fail (PHOSH_IS_LOCKSCREEN (lockscreen));
+  g_return_if_fail (lockscreen == PHOSH_LOCKSCREEN (priv->lockscreen));
+
+  /* Keep the widgets around for the next lock */
+  gtk_widget_hide (GTK_WIDGET (priv->lockscreen));
+  for (guint i = 0; i < priv->shields->len; i++)
+    gtk_widget_hide (g_ptr_array_index (priv->shields, i));
+
+  priv->locked = FALSE;
+  priv->active_time = 0;
+  priv->lock_begin = 0;
+
+  if (priv->stale) {
+    drop_prewarmed (self);
+    schedule_prewarm (self);
+  }
+
+  g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_LOCKSCREEN_MANAGER_PROP_LOCKED]);
+}
+
+
+static void
+lockscreen_lock (PhoshLockscreenManager *self)
+{
+  PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
+  PhoshMonitor *primary_monitor;
+  PhoshShell *shell = phosh_shell_get_default ();
+  gint64 begin = phosh_trace_now ();
+
+  g_return_if_fail (!priv->locked);
+
+  primary_monitor = phosh_shell_get_primary_monitor (shell);
+  g_return_if_fail (primary_monitor);
+
+  /* Primary monitor changed since we built the lock screen */
+  if (priv->lockscreen && priv->primary != primary_monitor)
+    drop_prewarmed (self);
+
+  g_clear_handle_id (&priv->prewarm_id, g_source_remove);
+  priv->lock_prewarmed = !!priv->lockscreen;
+  if (!priv->lockscreen)
+    prewarm (self);
+
+  /* Undo any rotation so the keypad becomes usable */
+  priv->rotation = phosh_shell_get_rotation (shell);
+  phosh_shell_rotate_display (shell, 0);
+
+  priv->lock_begin = begin;
+  gtk_widget_show (GTK_WIDGET (priv->lockscreen));
+
+  /* Lock all other outputs */
+  for (guint i = 0; i < priv->shields->len; i++)
+    gtk_widget_show (g_ptr_array_index (priv->shields, i));
+
   priv->locked = TRUE;
   priv->active_time = g_get_monotonic_time ();
   g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_LOCKSCREEN_MANAGER_PROP_LOCKED]);
@@ -269,11 +412,13 @@ phosh_lockscreen_manager_dispose (GObject *object)
   PhoshLockscreenManager *self = PHOSH_LOCKSCREEN_MANAGER (object);
   PhoshLockscreenManagerPrivate *priv = phosh_lockscreen_manager_get_instance_private (self);
 
+  g_clear_handle_id (&priv->prewarm_id, g_source_remove);
   g_clear_pointer (&priv->shields, g_ptr_array_unref);
   if (priv->lockscreen) {
     g_signal_handlers_disconnect_by_data (priv->lockscreen, self);
     g_clear_pointer (&priv->lockscreen, phosh_cp_widget_destroy);
   }
+  g_clear_object (&priv->primary);
   g_clear_object (&priv->settings);
 
   G_OBJECT_CLASS (phosh_lockscreen_manager_parent_class)->dispose (object);
@@ -298,6 +443,8 @@ phosh_lockscreen_manager_constructed (GObject *object)
                               (GCallback) presence_status_changed_cb,
                               self);
   }
+
+  schedule_prewarm (self);
 }
 
 
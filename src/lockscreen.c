@@ -12,8 +12,10 @@
 
 #include "auth.h"
 #include "bt-info.h"
+#include "display-state.h"
 #include "lockscreen.h"
 #include "media-player.h"
+#include "trace.h"
 
 #include <locale.h>
 #include <string.h>
@@ -71,8 +73,11 @@ typedef struct {
   guint      idle_timer;
   gint64     last_input;
   PhoshAuth *auth;
+  GCancellable *auth_cancel;
+  gint64     submit_time;
 
   GnomeWallClock *wall_clock;
+  gint64     clock_paused;
 } PhoshLockscreenPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshLockscreen, phosh_lockscreen, PHOSH_TYPE_LAYER_SURFACE)
@@ -176,15 +181,19 @@ auth_async_cb (PhoshAuth *auth, GAsyncResult *result, PhoshLockscreen *self)
   GError *error = NULL;
   gboolean authenticated;
 
-  priv = phosh_lockscreen_get_instance_private (self);
   authenticated = phosh_auth_authenticate_async_finish (auth, result, &error);
   if (error != NULL) {
-    g_warning ("Auth failed unexpected: %s", error->message);
+    /* Lock screen went away */
+    if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      g_warning ("Auth failed unexpected: %s", error->message);
+    g_error_free (error);
     return;
   }
 
+  priv = phosh_lockscreen_get_instance_private (self);
   g_object_ref (self);
   if (authenticated) {
+    phosh_trace_mark ("unlock", priv->submit_time, NULL);
     g_signal_emit(self, signals[LOCKSCREEN_UNLOCK], 0);
     g_clear_object (&priv->auth);
   } else {
@@ -265,11 +274,12 @@ submit_cb (PhoshLockscreen *self)
   gtk_label_set_label (GTK_LABEL (priv->lbl_unlock_status), _("Checking…"));
   gtk_widget_set_sensitive (GTK_WIDGET (self), FALSE);
 
+  priv->submit_time = phosh_trace_now ();
   if (priv->auth == NULL)
     priv->auth = PHOSH_AUTH (phosh_auth_new ());
   phosh_auth_authenticate_async_start (priv->auth,
                                        input,
-                                       NULL,
+                                       priv->auth_cancel,
                                        (GAsyncReadyCallback)auth_async_cb,
                                        self);
 }
@@ -397,6 +407,43 @@ wall_clock_notify_cb (PhoshLockscreen *self,
 }
 
 
+static void
+wall_clock_start (PhoshLockscreen *self)
+{
+  PhoshLockscreenPrivate *priv = phosh_lockscreen_get_instance_private (self);
+
+  priv->wall_clock = g_object_new (GNOME_TYPE_WALL_CLOCK,
+                                   "time-only", TRUE,
+                                   NULL);
+  g_signal_connect_object (priv->wall_clock,
+                           "notify::clock",
+                           G_CALLBACK (wall_clock_notify_cb),
+                           self,
+                           G_CONNECT_SWAPPED);
+  wall_clock_notify_cb (self, NULL, priv->wall_clock);
+}
+
+
+/* The wall clock wakes up every minute so drop it while the display is off */
+static void
+on_display_off_changed (PhoshLockscreen   *self,
+                        GParamSpec        *pspec,
+                        PhoshDisplayState *state)
+{
+  PhoshLockscreenPrivate *priv = phosh_lockscreen_get_instance_private (self);
+
+  if (phosh_display_state_get_display_off (state)) {
+    g_clear_object (&priv->wall_clock);
+    priv->clock_paused = g_get_monotonic_time ();
+  } else if (priv->wall_clock == NULL) {
+    gint64 paused = g_get_monotonic_time () - priv->clock_paused;
+
+    phosh_display_state_add_avoided_wakeups (state, paused / (60 * G_USEC_PER_SEC));
+    wall_clock_start (self);
+  }
+}
+
+
 static void
 carousel_position_notified_cb (PhoshLockscreen *self,
                                GParamSpec      *pspec,
@@ -434,7 +481,6 @@ static void
 phosh_lockscreen_constructed (GObject *object)
 {
   PhoshLockscreen *self = PHOSH_LOCKSCREEN (object);
-  PhoshLockscreenPrivate *priv = phosh_lockscreen_get_instance_private (self);
 
   G_OBJECT_CLASS (phosh_lockscreen_parent_class)->constructed (object);
 
@@ -453,14 +499,48 @@ phosh_lockscreen_constructed (GObject *object)
                     G_CALLBACK (key_press_event_cb),
                     NULL);
 
-  priv->wall_clock = g_object_new (GNOME_TYPE_WALL_CLOCK,
-                                   "time-only", TRUE,
-                                   NULL);
-  g_signal_connect_swapped (priv->wall_clock,
-                            "notify::clock",
-                            G_CALLBACK (wall_clock_notify_cb),
-                            self);
-  wall_clock_notify_cb (self, NULL, priv->wall_clock);
+  wall_clock_start (self);
+  g_signal_connect_object (phosh_display_state_get_default (),
+                           "notify::display-off",
+                           G_CALLBACK (on_display_off_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
+  on_display_off_changed (self, NULL, phosh_display_state_get_default ());
+}
+
+
+static void
+phosh_lockscreen_map (GtkWidget *widget)
+{
+  PhoshLockscreen *self = PHOSH_LOCKSCREEN (widget);
+  PhoshLockscreenPrivate *priv = phosh_lockscreen_get_instance_private (self);
+
+  GTK_WIDGET_CLASS (phosh_lockscreen_parent_class)->map (widget);
+
+  /* Get PAM ready while the user looks at the clock */
+  priv->auth_cancel = g_cancellable_new ();
+  if (priv->auth == NULL)
+    priv->auth = PHOSH_AUTH (phosh_auth_new ());
+  phosh_auth_prepare (priv->auth);
+}
+
+
+/* The lock screen is reused, so reset it when it goes away */
+static void
+phosh_lockscreen_unmap (GtkWidget *widget)
+{
+  PhoshLockscreen *self = PHOSH_LOCKSCREEN (widget);
+  PhoshLockscreenPrivate *priv = phosh_lockscreen_get_instance_private (self);
+
+  g_cancellable_cancel (priv->auth_cancel);
+  g_clear_object (&priv->auth_cancel);
+  g_clear_object (&priv->auth);
+  g_clear_handle_id (&priv->idle_timer, g_source_remove);
+  gtk_widget_set_sensitive (GTK_WIDGET (self), TRUE);
+  clear_input (self, TRUE);
+  hdy_carousel_scroll_to_full (HDY_CAROUSEL (priv->carousel), priv->box_info, 0);
+
+  GTK_WIDGET_CLASS (phosh_lockscreen_parent_class)->unmap (widget);
 }
 
 
@@ -470,6 +550,9 @@ phosh_lockscreen_dispose (GObject *object)
   PhoshLockscreen *self = PHOSH_LOCKSCREEN (object);
   PhoshLockscreenPrivate *priv = phosh_lockscreen_get_instance_private (self);
 
+  g_cancellable_cancel (priv->auth_cancel);
+  g_clear_object (&priv->auth_cancel);
+  g_clear_object (&priv->auth);
   g_clear_object (&priv->wall_clock);
   if (priv->idle_timer) {
     g_source_remove (priv->idle_timer);
@@ -492,6 +575,9 @@ phosh_lockscreen_class_init (PhoshLockscreenClass *klass)
   object_class->constructed = phosh_lockscreen_constructed;
   object_class->dispose = phosh_lockscreen_dispose;
 
+  widget_class->map = phosh_lockscreen_map;
+  widget_class->unmap = phosh_lockscreen_unmap;
+
   signals[LOCKSCREEN_UNLOCK] = g_signal_new ("lockscreen-unlock",
       G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST, 0, NULL, NULL,
       NULL, G_TYPE_NONE, 0);
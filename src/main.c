@@ -10,8 +10,11 @@
 
 #include "config.h"
 
+#include "debug-manager.h"
 #include "shell.h"
+#include "stall-watchdog.h"
 #include "phosh-wayland.h"
+#include "trace.h"
 
 #include <handy.h>
 
@@ -39,6 +42,21 @@ on_shutdown_signal (gpointer unused)
 }
 
 
+static void
+on_startup_finished (PhoshShell *shell, GParamSpec *pspec, gpointer unused)
+{
+  g_autofree char *report = NULL;
+
+  if (!phosh_shell_is_startup_finished (shell))
+    return;
+
+  g_signal_handlers_disconnect_by_func (shell, on_startup_finished, unused);
+
+  report = phosh_trace_format_report ();
+  g_print ("Startup report:\n%s", report);
+}
+
+
 static void
 print_version (void)
 {
@@ -52,9 +70,13 @@ int main(int argc, char *argv[])
   g_autoptr(GSource) sigterm = NULL;
   g_autoptr(GOptionContext) opt_context = NULL;
   GError *err = NULL;
-  gboolean unlocked = FALSE, locked = FALSE, version = FALSE;
+  gboolean unlocked = FALSE, locked = FALSE, version = FALSE, startup_report = FALSE;
+  int stall_threshold = 0;
+  gint64 begin;
   g_autoptr(PhoshWayland) wl = NULL;
   g_autoptr(PhoshShell) shell = NULL;
+  g_autoptr(PhoshStallWatchdog) stall_watchdog = NULL;
+  g_autoptr(PhoshDebugManager) debug_manager = NULL;
 
   const GOptionEntry options [] = {
     {"unlocked", 'U', 0, G_OPTION_ARG_NONE, &unlocked,
@@ -63,9 +85,15 @@ int main(int argc, char *argv[])
      "Start with screen locked, no matter what", NULL},
     {"version", 0, 0, G_OPTION_ARG_NONE, &version,
      "Show version information", NULL},
+    {"startup-report", 0, 0, G_OPTION_ARG_NONE, &startup_report,
+     "Print where startup time was spent once startup finished", NULL},
+    {"stall-watchdog", 0, 0, G_OPTION_ARG_INT, &stall_threshold,
+     "Record main loop stalls longer than MS milliseconds", "MS"},
     { NULL, 0, 0, G_OPTION_ARG_NONE, NULL, NULL, NULL }
   };
 
+  phosh_trace_init ();
+
   opt_context = g_option_context_new ("- A phone graphical shell");
   g_option_context_add_main_entries (opt_context, options, NULL);
   g_option_context_add_group (opt_context, gtk_get_option_group (TRUE));
@@ -82,14 +110,25 @@ int main(int argc, char *argv[])
   textdomain (GETTEXT_PACKAGE);
   bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
   bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
+  begin = phosh_trace_now ();
   gtk_init (&argc, &argv);
   hdy_init ();
+  phosh_trace_mark ("toolkit-init", begin, NULL);
+
+  if (stall_threshold > 0) {
+    stall_watchdog = phosh_stall_watchdog_new (stall_threshold);
+    debug_manager = phosh_debug_manager_new (stall_watchdog);
+  }
 
   g_unix_signal_add (SIGTERM, on_shutdown_signal, NULL);
   g_unix_signal_add (SIGINT, on_shutdown_signal, NULL);
 
   wl = phosh_wayland_get_default ();
   shell = phosh_shell_get_default ();
+  if (startup_report) {
+    g_signal_connect (shell, "notify::startup-finished",
+                      G_CALLBACK (on_startup_finished), NULL);
+  }
   if (!(unlocked || phosh_shell_started_by_display_manager(shell)) || locked)
     phosh_shell_lock (shell);
 
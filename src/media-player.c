@@ -10,6 +10,7 @@
 
 #include "config.h"
 
+#include "image-loader.h"
 #include "mpris-dbus.h"
 #include "media-player.h"
 
@@ -40,6 +41,15 @@
  * ]|
  */
 
+/* Player properties that changed since the last UI update */
+typedef enum {
+  PENDING_METADATA        = 1 << 0,
+  PENDING_PLAYBACK_STATUS = 1 << 1,
+  PENDING_CAN_GO_NEXT     = 1 << 2,
+  PENDING_CAN_GO_PREVIOUS = 1 << 3,
+  PENDING_CAN_PLAY        = 1 << 4,
+} PendingUpdate;
+
 typedef enum {
   PHOSH_MEDIA_PLAYER_STATUS_STOPPED,
   PHOSH_MEDIA_PLAYER_STATUS_PAUSED,
@@ -80,6 +90,14 @@ typedef struct _PhoshMediaPlayer {
   PhoshMediaPlayerStatus            status;
   gboolean                          attached;
   gboolean                          playable;
+  char                             *art_url;
+
+  /* Coalesced property updates */
+  PendingUpdate                     pending;
+  guint                             update_id;
+  GVariant                         *metadata;
+  char                             *title;
+  char                             *artist;
 } PhoshMediaPlayer;
 
 G_DEFINE_TYPE (PhoshMediaPlayer, phosh_media_player, GTK_TYPE_GRID);
@@ -251,49 +269,74 @@ btn_details_clicked_cb (PhoshMediaPlayer *self, GtkButton *button)
 }
 
 
+/* Update a label unless its text is unchanged */
 static void
-on_metadata_changed (PhoshMediaPlayer *self, GParamSpec *psepc, PhoshMprisDBusMediaPlayer2Player *player)
+update_label (GtkWidget *label, char **current, const char *text)
+{
+  if (g_strcmp0 (*current, text) == 0)
+    return;
+
+  g_free (*current);
+  *current = g_strdup (text);
+  gtk_label_set_label (GTK_LABEL (label), text);
+}
+
+
+static void
+update_metadata (PhoshMediaPlayer *self, PhoshMprisDBusMediaPlayer2Player *player)
 {
   GVariant *metadata;
-  char *title = NULL;
-  char *url = NULL;
+  const char *title = NULL;
+  const char *url = NULL;
+  g_autofree char *artists = NULL;
 
   g_auto (GStrv) artist = NULL;
   g_auto (GVariantDict) dict = G_VARIANT_DICT_INIT (NULL);
 
-  g_return_if_fail (PHOSH_IS_MEDIA_PLAYER (self));
-  g_debug ("Updating metadata");
-
   metadata = phosh_mpris_dbus_media_player2_player_get_metadata (player);
   if (!metadata)
     return;
+
+  /* Players resend unchanged metadata e.g. along with position updates */
+  if (self->metadata && g_variant_equal (metadata, self->metadata))
+    return;
+
+  g_debug ("Updating metadata");
+  g_clear_pointer (&self->metadata, g_variant_unref);
+  self->metadata = g_variant_ref (metadata);
   g_variant_dict_init (&dict, metadata);
 
   g_variant_dict_lookup (&dict, "xesam:title", "&s", &title);
-  if (title) {
-    gtk_label_set_label (GTK_LABEL (self->lbl_title), title);
-  } else {
-    /* Translators: Used when the title of a song is unknown */
-    gtk_label_set_label (GTK_LABEL (self->lbl_title), _("Unknown Title"));
-  }
+  /* Translators: Used when the title of a song is unknown */
+  update_label (self->lbl_title, &self->title, title ?: _("Unknown Title"));
 
   g_variant_dict_lookup (&dict, "xesam:artist", "^as", &artist);
-  if (artist && g_strv_length (artist) > 0) {
-    g_autofree char *artists = g_strjoinv (", ", artist);
-    gtk_label_set_label (GTK_LABEL (self->lbl_artist), artists);
-  } else {
-    /* Translators: Used when the artist of a song is unknown */
-    gtk_label_set_label (GTK_LABEL (self->lbl_artist), _("Unknown Artist"));
-  }
+  if (artist && g_strv_length (artist) > 0)
+    artists = g_strjoinv (", ", artist);
+  /* Translators: Used when the artist of a song is unknown */
+  update_label (self->lbl_artist, &self->artist, artists ?: _("Unknown Artist"));
 
   g_variant_dict_lookup (&dict, "mpris:artUrl", "&s", &url);
+  /* Same art as before, nothing to do */
+  if (url && g_strcmp0 (url, self->art_url) == 0)
+    return;
+
+  g_free (self->art_url);
+  self->art_url = g_strdup (url);
+
   if (url) {
     g_autoptr (GIcon) icon = NULL;
+    g_autoptr (GIcon) shown = NULL;
     g_autoptr (GFile) file = g_file_new_for_uri (url);
 
+    /* Load and downscale off the main thread */
     icon = g_file_icon_new (file);
-    gtk_image_set_from_gicon (GTK_IMAGE (self->img_art), icon, GTK_ICON_SIZE_DIALOG);
+    shown = phosh_image_loader_get_icon (phosh_image_loader_get_default (),
+                                         icon,
+                                         GTK_IMAGE (self->img_art));
+    gtk_image_set_from_gicon (GTK_IMAGE (self->img_art), shown, GTK_ICON_SIZE_DIALOG);
   } else {
+    phosh_image_loader_cancel (GTK_IMAGE (self->img_art));
     gtk_image_set_from_icon_name (GTK_IMAGE (self->img_art),
                                   "audio-x-generic-symbolic",
                                   GTK_ICON_SIZE_DIALOG);
@@ -302,15 +345,20 @@ on_metadata_changed (PhoshMediaPlayer *self, GParamSpec *psepc, PhoshMprisDBusMe
 
 
 static void
-on_playback_status_changed (PhoshMediaPlayer                 *self,
-                            GParamSpec                       *psepc,
-                            PhoshMprisDBusMediaPlayer2Player *player)
+clear_metadata (PhoshMediaPlayer *self)
+{
+  g_clear_pointer (&self->metadata, g_variant_unref);
+  update_label (self->lbl_title, &self->title, "");
+  update_label (self->lbl_artist, &self->artist, "");
+}
+
+
+static void
+update_playback_status (PhoshMediaPlayer *self, PhoshMprisDBusMediaPlayer2Player *player)
 {
   const char *status, *icon = "media-playback-start-symbolic";
   PhoshMediaPlayerStatus current;
 
-  g_return_if_fail (PHOSH_IS_MEDIA_PLAYER (self));
-
   status = phosh_mpris_dbus_media_player2_player_get_playback_status (player);
 
   /* No mpris running, widget will not be shown */
@@ -328,8 +376,7 @@ on_playback_status_changed (PhoshMediaPlayer                 *self,
     set_playable (self, TRUE);
   } else if (!g_strcmp0 ("Stopped", status)) {
     self->status = PHOSH_MEDIA_PLAYER_STATUS_STOPPED;
-    gtk_label_set_label (GTK_LABEL (self->lbl_artist), "");
-    gtk_label_set_label (GTK_LABEL (self->lbl_title), "");
+    clear_metadata (self);
     set_playable (self, FALSE);
   } else {
     g_warning ("Unknown status %s", status);
@@ -344,44 +391,88 @@ on_playback_status_changed (PhoshMediaPlayer                 *self,
 
 
 static void
-on_can_go_next_changed (PhoshMediaPlayer                 *self,
-                        GParamSpec                       *psepc,
-                        PhoshMprisDBusMediaPlayer2Player *player)
+update_buttons (PhoshMediaPlayer *self, PhoshMprisDBusMediaPlayer2Player *player, PendingUpdate pending)
 {
   gboolean sensitive;
 
-  g_return_if_fail (PHOSH_IS_MEDIA_PLAYER (self));
-  sensitive = phosh_mpris_dbus_media_player2_player_get_can_go_next (player);
-  g_debug ("Can go next: %d", sensitive);
-  gtk_widget_set_sensitive (self->btn_next, sensitive);
+  if (pending & PENDING_CAN_GO_NEXT) {
+    sensitive = phosh_mpris_dbus_media_player2_player_get_can_go_next (player);
+    g_debug ("Can go next: %d", sensitive);
+    gtk_widget_set_sensitive (self->btn_next, sensitive);
+  }
+
+  if (pending & PENDING_CAN_GO_PREVIOUS) {
+    sensitive = phosh_mpris_dbus_media_player2_player_get_can_go_previous (player);
+    g_debug ("Can go prev: %d", sensitive);
+    gtk_widget_set_sensitive (self->btn_prev, sensitive);
+  }
+
+  if (pending & PENDING_CAN_PLAY) {
+    sensitive = phosh_mpris_dbus_media_player2_player_get_can_play (player);
+    g_debug ("Can play: %d", sensitive);
+    gtk_widget_set_sensitive (self->btn_play, sensitive);
+  }
 }
 
 
-static void
-on_can_go_previous_changed (PhoshMediaPlayer                 *self,
-                            GParamSpec                       *psepc,
-                            PhoshMprisDBusMediaPlayer2Player *player)
+static gboolean
+on_update_idle (PhoshMediaPlayer *self)
 {
-  gboolean sensitive;
+  PendingUpdate pending = self->pending;
 
-  g_return_if_fail (PHOSH_IS_MEDIA_PLAYER (self));
-  sensitive = phosh_mpris_dbus_media_player2_player_get_can_go_previous (player);
-  g_debug ("Can go prev: %d", sensitive);
-  gtk_widget_set_sensitive (self->btn_prev, sensitive);
+  self->update_id = 0;
+  self->pending = 0;
+
+  if (self->player == NULL)
+    return G_SOURCE_REMOVE;
+
+  if (pending & PENDING_METADATA)
+    update_metadata (self, self->player);
+
+  /* Stopping clears the metadata so handle it last */
+  if (pending & PENDING_PLAYBACK_STATUS)
+    update_playback_status (self, self->player);
+
+  update_buttons (self, self->player, pending);
+
+  return G_SOURCE_REMOVE;
 }
 
 
+/*
+ * Players can emit bursts of property changes (e.g. browsers). Collect
+ * them and update the UI once right before the next frame.
+ */
 static void
-on_can_play (PhoshMediaPlayer                 *self,
-             GParamSpec                       *psepc,
-             PhoshMprisDBusMediaPlayer2Player *player)
+on_player_property_changed (PhoshMediaPlayer                 *self,
+                            GParamSpec                       *pspec,
+                            PhoshMprisDBusMediaPlayer2Player *player)
 {
-  gboolean sensitive;
+  const char *name = g_param_spec_get_name (pspec);
 
   g_return_if_fail (PHOSH_IS_MEDIA_PLAYER (self));
-  sensitive = phosh_mpris_dbus_media_player2_player_get_can_play (player);
-  g_debug ("Can play: %d", sensitive);
-  gtk_widget_set_sensitive (self->btn_play, sensitive);
+
+  if (g_strcmp0 (name, "metadata") == 0)
+    self->pending |= PENDING_METADATA;
+  else if (g_strcmp0 (name, "playback-status") == 0)
+    self->pending |= PENDING_PLAYBACK_STATUS;
+  else if (g_strcmp0 (name, "can-go-next") == 0)
+    self->pending |= PENDING_CAN_GO_NEXT;
+  else if (g_strcmp0 (name, "can-go-previous") == 0)
+    self->pending |= PENDING_CAN_GO_PREVIOUS;
+  else if (g_strcmp0 (name, "can-play") == 0)
+    self->pending |= PENDING_CAN_PLAY;
+  else
+    return;
+
+  if (self->update_id)
+    return;
+
+  self->update_id = g_idle_add_full (GDK_PRIORITY_REDRAW - 1,
+                                     (GSourceFunc) on_update_idle,
+                                     self,
+                                     NULL);
+  g_source_set_name_by_id (self->update_id, "[phosh] media player update");
 }
 
 
@@ -397,6 +488,11 @@ phosh_media_player_dispose (GObject *object)
   }
   g_clear_object (&self->mpris);
   g_clear_object (&self->player);
+  g_clear_handle_id (&self->update_id, g_source_remove);
+  g_clear_pointer (&self->metadata, g_variant_unref);
+  g_clear_pointer (&self->title, g_free);
+  g_clear_pointer (&self->artist, g_free);
+  g_clear_pointer (&self->art_url, g_free);
 
   G_OBJECT_CLASS (phosh_media_player_parent_class)->dispose (object);
 }
@@ -490,19 +586,19 @@ attach_player_cb (GObject          *source_object,
 
   g_object_connect (self->player,
                     "swapped_object_signal::notify::metadata",
-                    G_CALLBACK (on_metadata_changed),
+                    G_CALLBACK (on_player_property_changed),
                     self,
                     "swapped_object_signal::notify::playback-status",
-                    G_CALLBACK (on_playback_status_changed),
+                    G_CALLBACK (on_player_property_changed),
                     self,
                     "swapped_object_signal::notify::can-go-next",
-                    G_CALLBACK (on_can_go_next_changed),
+                    G_CALLBACK (on_player_property_changed),
                     self,
                     "swapped_object_signal::notify::can-go-previous",
-                    G_CALLBACK (on_can_go_previous_changed),
+                    G_CALLBACK (on_player_property_changed),
                     self,
                     "swapped_object_signal::notify::can-play",
-                    G_CALLBACK (on_can_play),
+                    G_CALLBACK (on_player_property_changed),
                     self,
                     NULL);
 
@@ -550,6 +646,8 @@ attach_player (PhoshMediaPlayer *self, const char *name)
 
   g_clear_object (&self->player);
   g_clear_object (&self->mpris);
+  /* Make sure the new player's metadata gets applied */
+  g_clear_pointer (&self->metadata, g_variant_unref);
 
   g_debug ("Trying to attach player for %s", name);
 
@@ -731,8 +829,14 @@ on_idle (PhoshMediaPlayer *self)
 static void
 phosh_media_player_init (PhoshMediaPlayer *self)
 {
+  int size;
+
   gtk_widget_init_template (GTK_WIDGET (self));
 
+  /* The image loader decodes album art at the image's pixel size */
+  if (gtk_icon_size_lookup (GTK_ICON_SIZE_DIALOG, &size, NULL))
+    gtk_image_set_pixel_size (GTK_IMAGE (self->img_art), size);
+
   /* Perform DBus setup when idle */
   g_idle_add ((GSourceFunc)on_idle, self);
 }
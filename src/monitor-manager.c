@@ -43,6 +43,11 @@ typedef struct _PhoshMonitorManager
 
   int dbus_name_id;
   int serial;
+
+  /* Replies are only rebuilt when the monitor configuration changes */
+  GVariant     *resources;
+  GVariant     *current_state;
+  PhoshMonitor *cached_primary; /* only compared, never dereferenced */
 } PhoshMonitorManager;
 
 G_DEFINE_TYPE_WITH_CODE (PhoshMonitorManager,
@@ -65,16 +70,55 @@ get_display_name (PhoshMonitor *monitor)
 }
 
 
-static gboolean
-phosh_monitor_manager_handle_get_resources (
-  PhoshDisplayDbusDisplayConfig *skeleton,
-  GDBusMethodInvocation *invocation)
+static void
+drop_cached_state (PhoshMonitorManager *self)
 {
-  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (skeleton);
-  GVariantBuilder crtc_builder, output_builder, mode_builder;
+  g_clear_pointer (&self->resources, g_variant_unref);
+  g_clear_pointer (&self->current_state, g_variant_unref);
+}
 
-  g_return_val_if_fail (self->monitors->len, FALSE);
-  g_debug ("DBus %s", __func__);
+/*
+ * invalidate_state:
+ *
+ * The monitor configuration changed. Drop the cached replies, bump
+ * the serial so stale configuration requests get rejected and
+ * let clients know.
+ */
+static void
+invalidate_state (PhoshMonitorManager *self)
+{
+  drop_cached_state (self);
+  self->serial++;
+
+  g_debug ("Monitor configuration changed, serial %d", self->serial);
+  phosh_display_dbus_display_config_emit_monitors_changed (
+    PHOSH_DISPLAY_DBUS_DISPLAY_CONFIG (self));
+}
+
+/*
+ * check_primary_monitor:
+ *
+ * The primary monitor can be changed by the shell behind our back
+ * so make sure the cached replies still match it.
+ */
+static PhoshMonitor *
+check_primary_monitor (PhoshMonitorManager *self)
+{
+  PhoshMonitor *primary = phosh_shell_get_primary_monitor (phosh_shell_get_default ());
+
+  if (primary != self->cached_primary) {
+    drop_cached_state (self);
+    self->cached_primary = primary;
+  }
+
+  return primary;
+}
+
+
+static GVariant *
+build_resources (PhoshMonitorManager *self, PhoshMonitor *primary)
+{
+  GVariantBuilder crtc_builder, output_builder, mode_builder;
 
   g_variant_builder_init (&crtc_builder, G_VARIANT_TYPE ("a(uxiiiiiuaua{sv})"));
   g_variant_builder_init (&output_builder, G_VARIANT_TYPE ("a(uxiausauaua{sv})"));
@@ -129,7 +173,7 @@ phosh_monitor_manager_handle_get_resources (
                            g_variant_new_int32 (monitor->width_mm));
     g_variant_builder_add (&properties, "{sv}", "height-mm",
                            g_variant_new_int32 (monitor->height_mm));
-    is_primary = (monitor == phosh_shell_get_primary_monitor (phosh_shell_get_default()));
+    is_primary = (monitor == primary);
     g_variant_builder_add (&properties, "{sv}", "primary",
                            g_variant_new_boolean (is_primary));
 
@@ -165,16 +209,33 @@ phosh_monitor_manager_handle_get_resources (
     }
   }
 
-  phosh_display_dbus_display_config_complete_get_resources (
-    skeleton,
-    invocation,
-    self->serial,
-    g_variant_builder_end (&crtc_builder),
-    g_variant_builder_end (&output_builder),
-    g_variant_builder_end (&mode_builder),
-    65535,  /* max_screen_width */
-    65535   /* max_screen_height */
-    );
+  return g_variant_ref_sink (g_variant_new ("(u@a(uxiiiiiuaua{sv})@a(uxiausauaua{sv})@a(uxuudu)ii)",
+                                            self->serial,
+                                            g_variant_builder_end (&crtc_builder),
+                                            g_variant_builder_end (&output_builder),
+                                            g_variant_builder_end (&mode_builder),
+                                            65535,  /* max_screen_width */
+                                            65535   /* max_screen_height */));
+}
+
+
+static gboolean
+phosh_monitor_manager_handle_get_resources (
+  PhoshDisplayDbusDisplayConfig *skeleton,
+  GDBusMethodInvocation *invocation)
+{
+  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (skeleton);
+  PhoshMonitor *primary;
+
+  g_return_val_if_fail (self->monitors->len, FALSE);
+  g_debug ("DBus %s", __func__);
+
+  primary = check_primary_monitor (self);
+  if (self->resources == NULL)
+    self->resources = build_resources (self, primary);
+
+  /* Equivalent to phosh_display_dbus_display_config_complete_get_resources () */
+  g_dbus_method_invocation_return_value (invocation, self->resources);
 
   return TRUE;
 }
@@ -196,15 +257,11 @@ phosh_monitor_manager_handle_change_backlight (
 }
 
 
-struct get_wl_gamma_callback_data {
-  PhoshDisplayDbusDisplayConfig *skeleton;
-  GDBusMethodInvocation *invocation;
-};
-
-
-static void handle_wl_gamma_size(void *data, struct gamma_control *gamma_control,
-                                 uint32_t size) {
-  struct get_wl_gamma_callback_data *gamma_callback_data = data;
+static void
+complete_get_crtc_gamma (PhoshDisplayDbusDisplayConfig *skeleton,
+                         GDBusMethodInvocation         *invocation,
+                         guint                          size)
+{
   GBytes *red_bytes, *green_bytes, *blue_bytes;
   GVariant *red_v, *green_v, *blue_v;
   /* All known clients using libgnome-desktop's
@@ -223,25 +280,75 @@ static void handle_wl_gamma_size(void *data, struct gamma_control *gamma_control
   blue_v = g_variant_new_from_bytes (G_VARIANT_TYPE ("aq"), blue_bytes, TRUE);
 
   phosh_display_dbus_display_config_complete_get_crtc_gamma (
-    gamma_callback_data->skeleton,
-    gamma_callback_data->invocation,
+    skeleton,
+    invocation,
     red_v, green_v, blue_v);
 
   g_bytes_unref (red_bytes);
   g_bytes_unref (green_bytes);
   g_bytes_unref (blue_bytes);
-
-  g_free (gamma_callback_data);
-  gamma_control_destroy (gamma_control);
 }
 
 
-static const struct
-gamma_control_listener gamma_control_listener = {
-	.gamma_size = handle_wl_gamma_size,
+/* How long to wait for the compositor to report the gamma size */
+#define GAMMA_SIZE_TIMEOUT_MS 2000
+
+struct get_wl_gamma_callback_data {
+  PhoshDisplayDbusDisplayConfig *skeleton;
+  GDBusMethodInvocation *invocation;
+  PhoshMonitor *monitor;
+  gulong handler_id;
+  guint timeout_id;
 };
 
 
+/* Invoked when the handler gets disconnected or the monitor goes away */
+static void
+get_wl_gamma_callback_data_free (gpointer user_data, GClosure *closure)
+{
+  struct get_wl_gamma_callback_data *data = user_data;
+
+  g_clear_handle_id (&data->timeout_id, g_source_remove);
+  if (data->invocation) {
+    g_dbus_method_invocation_return_error (data->invocation, G_DBUS_ERROR,
+                                           G_DBUS_ERROR_FAILED,
+                                           "Monitor went away");
+  }
+  g_object_unref (data->skeleton);
+  g_free (data);
+}
+
+
+static void
+on_monitor_gamma_size_changed (PhoshMonitor *monitor, GParamSpec *pspec, gpointer user_data)
+{
+  struct get_wl_gamma_callback_data *data = user_data;
+
+  complete_get_crtc_gamma (data->skeleton,
+                           g_steal_pointer (&data->invocation),
+                           monitor->gamma_size);
+
+  /* Frees data */
+  g_signal_handler_disconnect (monitor, data->handler_id);
+}
+
+
+static gboolean
+on_monitor_gamma_size_timeout (gpointer user_data)
+{
+  struct get_wl_gamma_callback_data *data = user_data;
+
+  data->timeout_id = 0;
+  g_dbus_method_invocation_return_error (g_steal_pointer (&data->invocation), G_DBUS_ERROR,
+                                         G_DBUS_ERROR_TIMEOUT,
+                                         "Compositor didn't report the gamma size");
+  /* Frees data */
+  g_signal_handler_disconnect (data->monitor, data->handler_id);
+
+  return G_SOURCE_REMOVE;
+}
+
+
 static gboolean
 phosh_monitor_manager_handle_get_crtc_gamma (
   PhoshDisplayDbusDisplayConfig *skeleton,
@@ -251,9 +358,8 @@ phosh_monitor_manager_handle_get_crtc_gamma (
 {
   PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (skeleton);
   PhoshMonitor *monitor;
-  struct gamma_control *gamma_control;
-  struct gamma_control_manager *gamma_control_manager;
-  struct get_wl_gamma_callback_data *data;;
+  struct get_wl_gamma_callback_data *data;
+  guint size;
 
   g_debug ("DBus call %s for crtc %d, serial %d", __func__, crtc_id, serial);
 
@@ -271,25 +377,32 @@ phosh_monitor_manager_handle_get_crtc_gamma (
     return TRUE;
   }
 
-  gamma_control_manager = phosh_wayland_get_gamma_control_manager (
-    phosh_wayland_get_default ());
-  if (gamma_control_manager == NULL) {
+  if (phosh_wayland_get_gamma_control_manager (phosh_wayland_get_default ()) == NULL) {
     g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
                                            G_DBUS_ERROR_NOT_SUPPORTED,
                                            "gamma control not supported");
     return TRUE;
   }
 
-  data = g_new0 (struct get_wl_gamma_callback_data, 1);
-  data->skeleton = skeleton;
-  data->invocation = invocation;
-
+  /* The monitor's gamma control is persistent so the size is usually known */
   monitor = g_ptr_array_index (self->monitors, crtc_id);
-  gamma_control = gamma_control_manager_get_gamma_control (
-    gamma_control_manager,
-    monitor->wl_output);
-  gamma_control_add_listener (gamma_control, &gamma_control_listener, data);
+  size = phosh_monitor_get_gamma_size (monitor);
+  if (size) {
+    complete_get_crtc_gamma (skeleton, invocation, size);
+    return TRUE;
+  }
 
+  data = g_new0 (struct get_wl_gamma_callback_data, 1);
+  data->skeleton = g_object_ref (skeleton);
+  data->invocation = invocation;
+  data->monitor = monitor;
+  data->handler_id = g_signal_connect_data (monitor, "notify::gamma-size",
+                                            G_CALLBACK (on_monitor_gamma_size_changed),
+                                            data,
+                                            get_wl_gamma_callback_data_free,
+                                            0);
+  data->timeout_id = g_timeout_add (GAMMA_SIZE_TIMEOUT_MS, on_monitor_gamma_size_timeout, data);
+  g_source_set_name_by_id (data->timeout_id, "[phosh] gamma size timeout");
   return TRUE;
 }
 
@@ -306,12 +419,8 @@ phosh_monitor_manager_handle_set_crtc_gamma (
 {
   PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (skeleton);
   PhoshMonitor *monitor;
-  unsigned short *red, *green, *blue;
-  GBytes *red_bytes, *green_bytes, *blue_bytes;
-  gsize size, dummy;
-  struct gamma_control_manager *gamma_control_manager;
-  struct gamma_control *gamma_control;
-  struct wl_array wl_red, wl_green, wl_blue;
+  const guint16 *red, *green, *blue;
+  gsize n_red, n_green, n_blue;
 
   g_debug ("DBus call %s for crtc %d, serial %d", __func__, crtc_id, serial);
   if (serial != self->serial) {
@@ -328,63 +437,30 @@ phosh_monitor_manager_handle_set_crtc_gamma (
     return TRUE;
   }
 
-  gamma_control_manager = phosh_wayland_get_gamma_control_manager (
-    phosh_wayland_get_default ());
-  if (!gamma_control_manager) {
-    g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+  red = g_variant_get_fixed_array (red_v, &n_red, sizeof (guint16));
+  green = g_variant_get_fixed_array (green_v, &n_green, sizeof (guint16));
+  blue = g_variant_get_fixed_array (blue_v, &n_blue, sizeof (guint16));
+
+  if (n_red != n_green || n_red != n_blue) {
+        g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
                                            G_DBUS_ERROR_NOT_SUPPORTED,
-                                           "gamma control not supported");
+                                           "gamma for each color must have same size");
     return TRUE;
   }
 
   monitor = g_ptr_array_index (self->monitors, crtc_id);
-
-  red_bytes = g_variant_get_data_as_bytes (red_v);
-  green_bytes = g_variant_get_data_as_bytes (green_v);
-  blue_bytes = g_variant_get_data_as_bytes (blue_v);
-
-  size = g_bytes_get_size (red_bytes);
-  if (size != g_bytes_get_size (blue_bytes) || size != g_bytes_get_size (green_bytes)) {
-        g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+  /* Apply immediately, clients like gsd-color do their own fading */
+  if (!phosh_monitor_set_gamma (monitor, red, green, blue, n_red)) {
+    g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
                                            G_DBUS_ERROR_NOT_SUPPORTED,
-                                           "gamma for each color must have same size");
-    goto err;
+                                           "gamma control not supported");
+    return TRUE;
   }
 
-  red = (unsigned short*) g_bytes_get_data (red_bytes, &dummy);
-  green = (unsigned short*) g_bytes_get_data (green_bytes, &dummy);
-  blue = (unsigned short*) g_bytes_get_data (blue_bytes, &dummy);
-
-  wl_array_init (&wl_red);
-  wl_array_init (&wl_green);
-  wl_array_init (&wl_blue);
-
-  wl_array_add (&wl_red, size);
-  wl_array_add (&wl_green, size);
-  wl_array_add (&wl_blue, size);
-
-  memcpy(wl_red.data, red, size);
-  memcpy(wl_green.data, green, size);
-  memcpy(wl_blue.data, blue, size);
-
-  gamma_control = gamma_control_manager_get_gamma_control (
-    gamma_control_manager,
-    monitor->wl_output);
-  gamma_control_set_gamma(gamma_control, &wl_red, &wl_green, &wl_blue);
-  gamma_control_destroy (gamma_control);
-
   phosh_display_dbus_display_config_complete_set_crtc_gamma (
       skeleton,
       invocation);
 
-  wl_array_release (&wl_red);
-  wl_array_release (&wl_green);
-  wl_array_release (&wl_blue);
-
- err:
-  g_bytes_unref (red_bytes);
-  g_bytes_unref (green_bytes);
-  g_bytes_unref (blue_bytes);
   return TRUE;
 }
 
@@ -400,15 +476,11 @@ phosh_monitor_manager_handle_set_crtc_gamma (
 #define LOGICAL_MONITORS_FORMAT "a" LOGICAL_MONITOR_FORMAT
 
 
-static gboolean
-phosh_monitor_manager_handle_get_current_state (
-  PhoshDisplayDbusDisplayConfig *skeleton,
-  GDBusMethodInvocation *invocation)
+static GVariant *
+build_current_state (PhoshMonitorManager *self, PhoshMonitor *primary)
 {
-  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (skeleton);
   GVariantBuilder monitors_builder, logical_monitors_builder, properties_builder;
 
-  g_debug ("DBus call %s", __func__);
   g_variant_builder_init (&monitors_builder,
                           G_VARIANT_TYPE (MONITORS_FORMAT));
   g_variant_builder_init (&logical_monitors_builder,
@@ -503,7 +575,7 @@ phosh_monitor_manager_handle_get_current_state (
                            serial                               /* monitor_spec->serial, */
       );
 
-    is_primary = (monitor == phosh_shell_get_primary_monitor (phosh_shell_get_default()));
+    is_primary = (monitor == primary);
     g_variant_builder_add (&logical_monitors_builder,
                            LOGICAL_MONITOR_FORMAT,
                            (gint32)monitor->logical.x,     /* logical_monitor->rect.x */
@@ -524,13 +596,30 @@ phosh_monitor_manager_handle_get_current_state (
                          "layout-mode",
                          g_variant_new_uint32 (0));
 
-  phosh_display_dbus_display_config_complete_get_current_state (
-    skeleton,
-    invocation,
-    self->serial,
-    g_variant_builder_end (&monitors_builder),
-    g_variant_builder_end (&logical_monitors_builder),
-    g_variant_builder_end (&properties_builder));
+  return g_variant_ref_sink (g_variant_new ("(u@" MONITORS_FORMAT "@" LOGICAL_MONITORS_FORMAT "@a{sv})",
+                                            self->serial,
+                                            g_variant_builder_end (&monitors_builder),
+                                            g_variant_builder_end (&logical_monitors_builder),
+                                            g_variant_builder_end (&properties_builder)));
+}
+
+
+static gboolean
+phosh_monitor_manager_handle_get_current_state (
+  PhoshDisplayDbusDisplayConfig *skeleton,
+  GDBusMethodInvocation *invocation)
+{
+  PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (skeleton);
+  PhoshMonitor *primary;
+
+  g_debug ("DBus call %s", __func__);
+
+  primary = check_primary_monitor (self);
+  if (self->current_state == NULL)
+    self->current_state = build_current_state (self, primary);
+
+  /* Equivalent to phosh_display_dbus_display_config_complete_get_current_state () */
+  g_dbus_method_invocation_return_value (invocation, self->current_state);
 
   return TRUE;
 }
@@ -689,6 +778,7 @@ phosh_monitor_manager_handle_apply_monitors_config (
   if (primary_monitor != phosh_shell_get_primary_monitor (shell)) {
     g_debug ("New primary monitor is %s", primary_monitor->name);
     phosh_shell_set_primary_monitor (shell, primary_monitor);
+    invalidate_state (self);
   }
 
   phosh_display_dbus_display_config_complete_apply_monitors_config (
@@ -794,6 +884,7 @@ on_monitor_removed (PhoshMonitorManager *self,
 
   g_debug("Monitor %p (%s) removed", monitor, monitor->name);
   g_ptr_array_remove (self->monitors, monitor);
+  invalidate_state (self);
 }
 
 
@@ -836,6 +927,7 @@ phosh_monitor_manager_finalize (GObject *object)
   PhoshMonitorManager *self = PHOSH_MONITOR_MANAGER (object);
 
   g_ptr_array_free (self->monitors, TRUE);
+  drop_cached_state (self);
 
   G_OBJECT_CLASS (phosh_monitor_manager_parent_class)->finalize (object);
 }
@@ -934,6 +1026,11 @@ void
 phosh_monitor_manager_add_monitor (PhoshMonitorManager *self, PhoshMonitor *monitor)
 {
   g_ptr_array_add (self->monitors, monitor);
+  g_signal_connect_object (monitor, "configured",
+                           G_CALLBACK (invalidate_state),
+                           self,
+                           G_CONNECT_SWAPPED);
+  invalidate_state (self);
   g_signal_emit (self, signals[SIGNAL_MONITOR_ADDED], 0, monitor);
 }
 
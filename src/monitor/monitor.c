@@ -17,12 +17,16 @@
  *
  * A rectangualar area in the compositor space, usally corresponds to
  * physical monitor using wl_output and xdg_output Wayland protocols.
+ *
+ * The monitor keeps a single gamma control for its whole lifetime
+ * so gamma changes only cost a single protocol request.
  */
 
 enum {
   PHOSH_MONITOR_PROP_0,
   PHOSH_MONITOR_PROP_WL_OUTPUT,
   PHOSH_MONITOR_PROP_POWER_MODE,
+  PHOSH_MONITOR_PROP_GAMMA_SIZE,
   PHOSH_MONITOR_PROP_LAST_PROP,
 };
 static GParamSpec *props[PHOSH_MONITOR_PROP_LAST_PROP];
@@ -280,6 +284,72 @@ static const struct zwlr_output_power_v1_listener wlr_output_power_listener_v1 =
 };
 
 
+static void
+gamma_control_handle_gamma_size (void                 *data,
+                                 struct gamma_control *gamma_control,
+                                 uint32_t              size)
+{
+  PhoshMonitor *self = data;
+
+  g_return_if_fail (PHOSH_IS_MONITOR (self));
+  g_debug ("Gamma size of %s is %u", self->name, size);
+
+  if (self->gamma_size == size)
+    return;
+
+  self->gamma_size = size;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_MONITOR_PROP_GAMMA_SIZE]);
+}
+
+
+static const struct gamma_control_listener gamma_control_listener = {
+  .gamma_size = gamma_control_handle_gamma_size,
+};
+
+
+static gboolean
+ensure_gamma_control (PhoshMonitor *self)
+{
+  struct gamma_control_manager *gamma_control_manager;
+
+  if (self->gamma_control)
+    return TRUE;
+
+  gamma_control_manager = phosh_wayland_get_gamma_control_manager (phosh_wayland_get_default ());
+  if (gamma_control_manager == NULL)
+    return FALSE;
+
+  /* Destroying the control resets the gamma so keep it around */
+  self->gamma_control = gamma_control_manager_get_gamma_control (gamma_control_manager,
+                                                                 self->wl_output);
+  gamma_control_add_listener (self->gamma_control, &gamma_control_listener, self);
+  return TRUE;
+}
+
+
+static guint16 *
+resize_gamma_array (struct wl_array *array, gsize size)
+{
+  if (array->size != size) {
+    wl_array_release (array);
+    wl_array_init (array);
+    wl_array_add (array, size);
+  }
+
+  return array->data;
+}
+
+
+static void
+send_gamma (PhoshMonitor *self)
+{
+  gamma_control_set_gamma (self->gamma_control,
+                           &self->gamma_red,
+                           &self->gamma_green,
+                           &self->gamma_blue);
+}
+
+
 static void
 phosh_monitor_set_property (GObject *object,
                           guint property_id,
@@ -314,6 +384,9 @@ phosh_monitor_get_property (GObject *object,
   case PHOSH_MONITOR_PROP_POWER_MODE:
     g_value_set_enum (value, self->power_mode);
     break;
+  case PHOSH_MONITOR_PROP_GAMMA_SIZE:
+    g_value_set_uint (value, self->gamma_size);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -335,6 +408,14 @@ phosh_monitor_dispose (GObject *object)
   g_clear_pointer (&self->xdg_output, zxdg_output_v1_destroy);
   g_clear_pointer (&self->wlr_output_power, zwlr_output_power_v1_destroy);
 
+  g_clear_pointer (&self->gamma_control, gamma_control_destroy);
+  wl_array_release (&self->gamma_red);
+  wl_array_init (&self->gamma_red);
+  wl_array_release (&self->gamma_green);
+  wl_array_init (&self->gamma_green);
+  wl_array_release (&self->gamma_blue);
+  wl_array_init (&self->gamma_blue);
+
   G_OBJECT_CLASS (phosh_monitor_parent_class)->dispose (object);
 }
 
@@ -392,6 +473,20 @@ phosh_monitor_class_init (PhoshMonitorClass *klass)
                        PHOSH_MONITOR_POWER_SAVE_MODE_OFF,
                        G_PARAM_READABLE |
                        G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshMonitor:gamma-size:
+   *
+   * The number of entries per color channel in the monitor's gamma
+   * table. 0 if not yet known, see phosh_monitor_get_gamma_size().
+   */
+  props[PHOSH_MONITOR_PROP_GAMMA_SIZE] =
+    g_param_spec_uint ("gamma-size",
+                       "Gamma size",
+                       "The size of the gamma table",
+                       0, G_MAXUINT32, 0,
+                       G_PARAM_READABLE |
+                       G_PARAM_EXPLICIT_NOTIFY |
+                       G_PARAM_STATIC_STRINGS);
   g_object_class_install_properties (object_class, PHOSH_MONITOR_PROP_LAST_PROP, props);
 
   /**
@@ -415,6 +510,9 @@ phosh_monitor_init (PhoshMonitor *self)
   self->scale = 1.0;
   self->modes = g_array_new (FALSE, FALSE, sizeof(PhoshMonitorMode));
   self->power_mode = PHOSH_MONITOR_POWER_SAVE_MODE_OFF;
+  wl_array_init (&self->gamma_red);
+  wl_array_init (&self->gamma_green);
+  wl_array_init (&self->gamma_blue);
 }
 
 
@@ -569,3 +667,60 @@ phosh_monitor_set_power_save_mode (PhoshMonitor *self, PhoshMonitorPowerSaveMode
 
   zwlr_output_power_v1_set_mode (self->wlr_output_power, wl_mode);
 }
+
+
+/**
+ * phosh_monitor_get_gamma_size:
+ * @self: A #PhoshMonitor
+ *
+ * Gets the number of entries per color channel of the monitor's gamma
+ * table. The size is reported asynchronously by the compositor so
+ * this returns 0 until it is known. Listen to notify::gamma-size in
+ * that case.
+ *
+ * Returns: The gamma table size or 0 if not yet known.
+ */
+guint
+phosh_monitor_get_gamma_size (PhoshMonitor *self)
+{
+  g_return_val_if_fail (PHOSH_IS_MONITOR (self), 0);
+
+  ensure_gamma_control (self);
+  return self->gamma_size;
+}
+
+
+/**
+ * phosh_monitor_set_gamma:
+ * @self: A #PhoshMonitor
+ * @red: (array length=n_entries): The red channel's gamma table
+ * @green: (array length=n_entries): The green channel's gamma table
+ * @blue: (array length=n_entries): The blue channel's gamma table
+ * @n_entries: The number of entries per channel
+ *
+ * Sets the monitor's gamma tables.
+ *
+ * Returns: %FALSE if the compositor doesn't support gamma control.
+ */
+gboolean
+phosh_monitor_set_gamma (PhoshMonitor  *self,
+                         const guint16 *red,
+                         const guint16 *green,
+                         const guint16 *blue,
+                         gsize          n_entries)
+{
+  gsize size = n_entries * sizeof (guint16);
+
+  g_return_val_if_fail (PHOSH_IS_MONITOR (self), FALSE);
+  g_return_val_if_fail (red && green && blue, FALSE);
+
+  if (!ensure_gamma_control (self))
+    return FALSE;
+
+  memcpy (resize_gamma_array (&self->gamma_red, size), red, size);
+  memcpy (resize_gamma_array (&self->gamma_green, size), green, size);
+  memcpy (resize_gamma_array (&self->gamma_blue, size), blue, size);
+  send_gamma (self);
+
+  return TRUE;
+}
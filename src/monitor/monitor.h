@@ -89,6 +89,10 @@ struct _PhoshMonitor {
 
   gboolean wl_output_done;
   gboolean xdg_output_done;
+
+  struct gamma_control *gamma_control;
+  guint32 gamma_size;
+  struct wl_array gamma_red, gamma_green, gamma_blue;
 };
 
 G_DECLARE_FINAL_TYPE (PhoshMonitor, phosh_monitor, PHOSH, MONITOR, GObject)
@@ -101,3 +105,9 @@ gboolean           phosh_monitor_is_flipped (PhoshMonitor *monitor);
 guint              phosh_monitor_get_rotation (PhoshMonitor *monitor);
 void               phosh_monitor_set_power_save_mode (PhoshMonitor *self,
                                                       PhoshMonitorPowerSaveMode mode);
+guint              phosh_monitor_get_gamma_size (PhoshMonitor *self);
+gboolean           phosh_monitor_set_gamma (PhoshMonitor  *self,
+                                            const guint16 *red,
+                                            const guint16 *green,
+                                            const guint16 *blue,
+                                            gsize          n_entries);
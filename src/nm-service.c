@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-nm-service"
+
+#include "config.h"
+
+#include "nm-service.h"
+#include "trace.h"
+
+/**
+ * SECTION:nm-service
+ * @short_description: Shell wide access to NetworkManager
+ * @Title: PhoshNmService
+ *
+ * #PhoshNmService owns the single #NMClient shared by all network
+ * related parts of the shell like the Wi-Fi manager, the
+ * connectivity info and the network agent's prompt. Each
+ * #NMClient mirrors all devices, connections and access points
+ * so having only one keeps memory use and D-Bus traffic down.
+ *
+ * The client is created on the first request. Requests arriving
+ * while it is being created are queued and completed together.
+ */
+
+enum {
+  PROP_0,
+  PROP_CLIENT,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+struct _PhoshNmService {
+  GObject   parent;
+
+  NMClient *client;
+  /* GTasks waiting for the client */
+  GQueue    pending;
+  gboolean  initializing;
+  gint64    init_begin;
+};
+G_DEFINE_TYPE (PhoshNmService, phosh_nm_service, G_TYPE_OBJECT)
+
+
+static void
+phosh_nm_service_get_property (GObject    *object,
+                               guint       property_id,
+                               GValue     *value,
+                               GParamSpec *pspec)
+{
+  PhoshNmService *self = PHOSH_NM_SERVICE (object);
+
+  switch (property_id) {
+  case PROP_CLIENT:
+    g_value_set_object (value, self->client);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+on_nm_client_ready (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+  g_autoptr (PhoshNmService) self = PHOSH_NM_SERVICE (user_data);
+  g_autoptr (GError) err = NULL;
+  GTask *task;
+
+  self->initializing = FALSE;
+  self->client = nm_client_new_finish (res, &err);
+  if (self->client) {
+    phosh_trace_mark ("nm-client", self->init_begin, NULL);
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_CLIENT]);
+  } else {
+    /* Fail all waiters, the next request retries */
+    g_warning ("Failed to init NM: %s", err->message);
+  }
+
+  while ((task = g_queue_pop_head (&self->pending))) {
+    if (self->client)
+      g_task_return_pointer (task, g_object_ref (self->client), g_object_unref);
+    else
+      g_task_return_error (task, g_error_copy (err));
+    g_object_unref (task);
+  }
+}
+
+
+static void
+phosh_nm_service_dispose (GObject *object)
+{
+  PhoshNmService *self = PHOSH_NM_SERVICE (object);
+
+  g_clear_object (&self->client);
+
+  G_OBJECT_CLASS (phosh_nm_service_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_nm_service_class_init (PhoshNmServiceClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->get_property = phosh_nm_service_get_property;
+  object_class->dispose = phosh_nm_service_dispose;
+
+  /**
+   * PhoshNmService:client:
+   *
+   * The shared #NMClient or %NULL if not yet created.
+   */
+  props[PROP_CLIENT] =
+    g_param_spec_object ("client",
+                         "Client",
+                         "The shared NetworkManager client",
+                         NM_TYPE_CLIENT,
+                         G_PARAM_READABLE |
+                         G_PARAM_STATIC_STRINGS |
+                         G_PARAM_EXPLICIT_NOTIFY);
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+}
+
+
+static void
+phosh_nm_service_init (PhoshNmService *self)
+{
+  g_queue_init (&self->pending);
+}
+
+/**
+ * phosh_nm_service_get_default:
+ *
+ * Get the NetworkManager service singleton
+ *
+ * Returns:(transfer none): The NetworkManager service singleton
+ */
+PhoshNmService *
+phosh_nm_service_get_default (void)
+{
+  static PhoshNmService *instance;
+
+  if (instance == NULL) {
+    instance = g_object_new (PHOSH_TYPE_NM_SERVICE, NULL);
+    g_object_add_weak_pointer (G_OBJECT (instance), (gpointer *)&instance);
+  }
+
+  return instance;
+}
+
+/**
+ * phosh_nm_service_get_client:
+ * @self: The #PhoshNmService
+ *
+ * Get the shared client without creating it.
+ *
+ * Returns:(transfer none) (nullable): The shared #NMClient or %NULL
+ * if it wasn't created yet.
+ */
+NMClient *
+phosh_nm_service_get_client (PhoshNmService *self)
+{
+  g_return_val_if_fail (PHOSH_IS_NM_SERVICE (self), NULL);
+
+  return self->client;
+}
+
+/**
+ * phosh_nm_service_get_client_async:
+ * @self: The #PhoshNmService
+ * @cancellable: (nullable): A #GCancellable
+ * @callback: The callback to invoke when the client is ready
+ * @user_data: Data passed to @callback
+ *
+ * Get the shared #NMClient creating it if necessary. Use
+ * phosh_nm_service_get_client_finish() in @callback to get the
+ * result.
+ */
+void
+phosh_nm_service_get_client_async (PhoshNmService      *self,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data)
+{
+  GTask *task;
+
+  g_return_if_fail (PHOSH_IS_NM_SERVICE (self));
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (task, phosh_nm_service_get_client_async);
+
+  if (self->client) {
+    g_task_return_pointer (task, g_object_ref (self->client), g_object_unref);
+    g_object_unref (task);
+    return;
+  }
+
+  g_queue_push_tail (&self->pending, task);
+  if (self->initializing)
+    return;
+
+  self->initializing = TRUE;
+  self->init_begin = phosh_trace_now ();
+  nm_client_new_async (NULL, on_nm_client_ready, g_object_ref (self));
+}
+
+/**
+ * phosh_nm_service_get_client_finish:
+ * @self: The #PhoshNmService
+ * @result: The #GAsyncResult
+ * @error: Return location for an error
+ *
+ * Finish an operation started by phosh_nm_service_get_client_async().
+ *
+ * Returns:(transfer full): The shared #NMClient or %NULL on error
+ */
+NMClient *
+phosh_nm_service_get_client_finish (PhoshNmService  *self,
+                                    GAsyncResult    *result,
+                                    GError         **error)
+{
+  g_return_val_if_fail (PHOSH_IS_NM_SERVICE (self), NULL);
+  g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) ==
+                        phosh_nm_service_get_client_async, NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <NetworkManager.h>
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_NM_SERVICE (phosh_nm_service_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshNmService, phosh_nm_service, PHOSH, NM_SERVICE, GObject)
+
+PhoshNmService *phosh_nm_service_get_default      (void);
+NMClient       *phosh_nm_service_get_client       (PhoshNmService      *self);
+void            phosh_nm_service_get_client_async (PhoshNmService      *self,
+                                                   GCancellable        *cancellable,
+                                                   GAsyncReadyCallback  callback,
+                                                   gpointer             user_data);
+NMClient       *phosh_nm_service_get_client_finish (PhoshNmService     *self,
+                                                    GAsyncResult       *result,
+                                                    GError            **error);
+
+G_END_DECLS
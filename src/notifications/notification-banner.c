@@ -163,18 +163,17 @@ phosh_notification_banner_finalize (GObject *object)
 static void
 phosh_notification_banner_slide (PhoshNotificationBanner *self)
 {
-  int margin;
+  int offset;
   int height;
   double progress = hdy_ease_out_cubic (self->animation.progress);
 
   progress = 1.0 - progress;
 
+  /* The surface stays in place, only the content slides in */
   gtk_window_get_size (GTK_WINDOW (self), NULL, &height);
-  margin = (height - 300) * progress;
+  offset = -height * progress;
 
-  phosh_layer_surface_set_margins (PHOSH_LAYER_SURFACE (self), margin, 0, 0, 0);
-
-  phosh_layer_surface_wl_surface_commit (PHOSH_LAYER_SURFACE (self));
+  phosh_layer_surface_set_content_offset (PHOSH_LAYER_SURFACE (self), 0, offset);
 }
 
 
@@ -216,6 +215,8 @@ phosh_notification_banner_show (GtkWidget *widget)
 
   self->animation.last_frame = -1;
   self->animation.progress = enable_animations ? 0.0 : 1.0;
+  /* Make sure the first frame is already drawn off screen */
+  phosh_notification_banner_slide (self);
   gtk_widget_add_tick_callback (GTK_WIDGET (self), animate_down_cb, NULL, NULL);
 
   GTK_WIDGET_CLASS (phosh_notification_banner_parent_class)->show (widget);
@@ -272,7 +273,6 @@ phosh_notification_banner_new (PhoshNotification *notification)
   return g_object_new (PHOSH_TYPE_NOTIFICATION_BANNER,
                        "notification", notification,
                        /* layer surface */
-                       "margin-top", -300,
                        "layer-shell", phosh_wayland_get_zwlr_layer_shell_v1 (wl),
                        "anchor", ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP,
                        "height", 50,
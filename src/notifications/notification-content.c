@@ -10,6 +10,7 @@
 
 #include "config.h"
 #include "notification-content.h"
+#include "image-loader.h"
 
 
 /**
@@ -53,7 +54,11 @@ set_image (GBinding     *binding,
 
   gtk_widget_set_visible (self->img_image, image != NULL);
 
-  g_value_set_object (to_value, image);
+  /* File backed images are loaded off the main thread */
+  g_value_take_object (to_value,
+                       phosh_image_loader_get_icon (phosh_image_loader_get_default (),
+                                                    image,
+                                                    GTK_IMAGE (self->img_image)));
 
   return TRUE;
 }
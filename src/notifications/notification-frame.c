@@ -9,6 +9,7 @@
 #define G_LOG_DOMAIN "phosh-notification-frame"
 
 #include "config.h"
+#include "image-loader.h"
 #include "notification-content.h"
 #include "notification-frame.h"
 #include "notification-source.h"
@@ -149,6 +150,25 @@ phosh_notification_frame_new (void)
 }
 
 
+static gboolean
+set_icon (GBinding     *binding,
+          const GValue *from_value,
+          GValue       *to_value,
+          gpointer      user_data)
+{
+  PhoshNotificationFrame *self = user_data;
+  GIcon *icon = g_value_get_object (from_value);
+
+  /* File backed icons are loaded off the main thread */
+  g_value_take_object (to_value,
+                       phosh_image_loader_get_icon (phosh_image_loader_get_default (),
+                                                    icon,
+                                                    GTK_IMAGE (self->img_icon)));
+
+  return TRUE;
+}
+
+
 static GtkWidget *
 create_row (gpointer item, gpointer data)
 {
@@ -191,9 +211,13 @@ items_changed (GListModel             *list,
                                             self->lbl_app_name, "label",
                                             G_BINDING_SYNC_CREATE);
 
-  self->bind_icon = g_object_bind_property (notification,   "app-icon",
-                                            self->img_icon, "gicon",
-                                            G_BINDING_SYNC_CREATE);
+  self->bind_icon = g_object_bind_property_full (notification,   "app-icon",
+                                                 self->img_icon, "gicon",
+                                                 G_BINDING_SYNC_CREATE,
+                                                 set_icon,
+                                                 NULL,
+                                                 self,
+                                                 NULL);
 
   self->bind_timestamp = g_object_bind_property (notification,   "timestamp",
                                                  self->updated,  "timestamp",
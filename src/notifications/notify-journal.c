@@ -0,0 +1,729 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-notify-journal"
+
+#include "app-info-registry.h"
+#include "notify-journal.h"
+
+#include <gio/gdesktopappinfo.h>
+#include <glib/gstdio.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * SECTION:notify-journal
+ * @short_description: Persists active notifications across restarts
+ * @Title: PhoshNotifyJournal
+ *
+ * The journal is an append only file of serialized notifications so
+ * they can be restored when the shell restarts. It starts with a
+ * header (magic, version and the next notification id) followed by
+ * records. Each record is a 32 bit little endian size, a 32 bit
+ * little endian op code and a serialized #GVariant padded to 8 bytes.
+ *
+ * On load the journal is mmapped and replayed in a worker thread and
+ * then compacted so that only records of active notifications remain.
+ * Once it grew past 1 MiB and twice its compacted size it's
+ * compacted again.
+ * All writes happen in a dedicated writer thread. Images are stored
+ * downscaled. The journal is only readable by the user and transient
+ * notifications or ones with a sensitive category are never stored.
+ */
+
+#define JOURNAL_MAGIC               "PHNJRNL"
+#define JOURNAL_VERSION             1
+#define JOURNAL_HEADER_SIZE         16
+#define JOURNAL_RECORD_HEADER_SIZE  8
+#define JOURNAL_ALIGN(x)            (((x) + 7) & ~(gsize) 7)
+#define JOURNAL_MAX_SIZE            (1024 * 1024)
+#define JOURNAL_IMAGE_SIZE          64
+
+/* id, next_id, source_id, app_name, desktop_id, summary, body,
+   app-icon, image, urgency, actions, resident, category, timestamp */
+#define JOURNAL_ADD_TYPE            "(uusssssmvmvyasbsx)"
+#define JOURNAL_REMOVE_TYPE         "(u)"
+
+/* Categories whose contents shouldn't end up on disk. The notification
+ * spec has no such category so this is a phosh extension, clients can
+ * alternatively use the spec's "transient" hint. */
+static const char * const sensitive_categories[] = {
+  "x-phosh.sensitive",
+  NULL
+};
+
+typedef enum {
+  JOURNAL_OP_ADD    = 1,
+  JOURNAL_OP_REMOVE = 2,
+} JournalOp;
+
+typedef struct {
+  JournalOp  op;
+  guint      id;
+  guint      next_id;
+  char      *source_id;
+  char      *app_name;
+  char      *desktop_id;
+  char      *summary;
+  char      *body;
+  GIcon     *icon;
+  GIcon     *image;
+  guint8     urgency;
+  GStrv      actions;
+  gboolean   resident;
+  char      *category;
+  gint64     timestamp;
+} JournalJob;
+
+struct _PhoshNotifyJournal {
+  GObject      parent;
+
+  char        *path;
+  GThreadPool *writer;
+
+  /* Only used by the load thread and, once loaded, by the writer thread */
+  int          fd;
+  gsize        size;
+  gsize        compacted_size;
+  guint        next_id;
+  GHashTable  *live;
+};
+
+G_DEFINE_TYPE (PhoshNotifyJournal, phosh_notify_journal, G_TYPE_OBJECT)
+
+
+static void
+journal_job_free (JournalJob *job)
+{
+  g_free (job->source_id);
+  g_free (job->app_name);
+  g_free (job->desktop_id);
+  g_free (job->summary);
+  g_free (job->body);
+  g_clear_object (&job->icon);
+  g_clear_object (&job->image);
+  g_strfreev (job->actions);
+  g_free (job->category);
+  g_free (job);
+}
+
+
+void
+phosh_notify_journal_entry_free (PhoshNotifyJournalEntry *entry)
+{
+  g_free (entry->source_id);
+  g_clear_object (&entry->notification);
+  g_free (entry);
+}
+
+
+static int
+cmp_id (gconstpointer a, gconstpointer b)
+{
+  guint ia = GPOINTER_TO_UINT (a);
+  guint ib = GPOINTER_TO_UINT (b);
+
+  return (ia > ib) - (ia < ib);
+}
+
+
+static GVariant *
+serialize_icon (GIcon *icon)
+{
+  g_autoptr (GdkPixbuf) scaled = NULL;
+
+  if (icon == NULL)
+    return NULL;
+
+  if (GDK_IS_PIXBUF (icon)) {
+    GdkPixbuf *pixbuf = GDK_PIXBUF (icon);
+    int width = gdk_pixbuf_get_width (pixbuf);
+    int height = gdk_pixbuf_get_height (pixbuf);
+
+    if (width > JOURNAL_IMAGE_SIZE || height > JOURNAL_IMAGE_SIZE) {
+      double scale = (double) JOURNAL_IMAGE_SIZE / MAX (width, height);
+
+      scaled = gdk_pixbuf_scale_simple (pixbuf,
+                                        MAX (1, width * scale),
+                                        MAX (1, height * scale),
+                                        GDK_INTERP_BILINEAR);
+      icon = G_ICON (scaled);
+    }
+  }
+
+  return g_icon_serialize (icon);
+}
+
+
+static GVariant *
+job_to_record (JournalJob *job)
+{
+  const char *const no_actions[] = { NULL };
+  g_autoptr (GVariant) icon = serialize_icon (job->icon);
+  g_autoptr (GVariant) image = serialize_icon (job->image);
+
+  return g_variant_ref_sink (
+    g_variant_new ("(uusssssmvmvy^asbsx)",
+                   job->id,
+                   job->next_id,
+                   job->source_id ?: "",
+                   job->app_name ?: "",
+                   job->desktop_id ?: "",
+                   job->summary ?: "",
+                   job->body ?: "",
+                   icon,
+                   image,
+                   job->urgency,
+                   job->actions ?: (GStrv) no_actions,
+                   job->resident,
+                   job->category ?: "",
+                   job->timestamp));
+}
+
+
+static PhoshNotifyJournalEntry *
+entry_from_record (GVariant *record)
+{
+  PhoshNotifyJournalEntry *entry = g_new0 (PhoshNotifyJournalEntry, 1);
+  g_autoptr (GVariant) icon_data = NULL;
+  g_autoptr (GVariant) image_data = NULL;
+  g_autoptr (GIcon) icon = NULL;
+  g_autoptr (GIcon) image = NULL;
+  g_autoptr (GDesktopAppInfo) info = NULL;
+  g_autoptr (GDateTime) timestamp = NULL;
+  g_autofree const char **actions = NULL;
+  const char *app_name, *desktop_id, *summary, *body, *category;
+  guint id, next_id;
+  guint8 urgency;
+  gboolean resident;
+  gint64 unix_time;
+
+  g_variant_get (record, "(uus&s&s&s&smvmvy^a&sb&sx)",
+                 &id,
+                 &next_id,
+                 &entry->source_id,
+                 &app_name,
+                 &desktop_id,
+                 &summary,
+                 &body,
+                 &icon_data,
+                 &image_data,
+                 &urgency,
+                 &actions,
+                 &resident,
+                 &category,
+                 &unix_time);
+
+  if (icon_data)
+    icon = g_icon_deserialize (icon_data);
+  if (image_data)
+    image = g_icon_deserialize (image_data);
+  if (*desktop_id)
+    info = phosh_app_info_registry_lookup (phosh_app_info_registry_get_default (), desktop_id);
+  timestamp = g_date_time_new_from_unix_local (unix_time);
+
+  entry->notification = phosh_notification_new (id,
+                                                 *app_name ? app_name : NULL,
+                                                 G_APP_INFO (info),
+                                                 summary,
+                                                 body,
+                                                 icon,
+                                                 image,
+                                                 urgency,
+                                                 (GStrv) actions,
+                                                 FALSE,
+                                                 resident,
+                                                 *category ? category : NULL,
+                                                 timestamp);
+  return entry;
+}
+
+
+static gboolean
+write_all (int fd, const guint8 *buf, gsize len, GError **error)
+{
+  while (len > 0) {
+    gssize written = write (fd, buf, len);
+
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   "Failed to write journal: %s", g_strerror (errno));
+      return FALSE;
+    }
+    buf += written;
+    len -= written;
+  }
+
+  return TRUE;
+}
+
+
+static gboolean
+write_header (int fd, guint next_id, GError **error)
+{
+  guint8 header[JOURNAL_HEADER_SIZE] = { 0 };
+  guint32 version = GUINT32_TO_LE (JOURNAL_VERSION);
+  guint32 id = GUINT32_TO_LE (next_id);
+
+  memcpy (header, JOURNAL_MAGIC, sizeof (JOURNAL_MAGIC));
+  memcpy (header + 8, &version, sizeof (version));
+  memcpy (header + 12, &id, sizeof (id));
+
+  return write_all (fd, header, sizeof (header), error);
+}
+
+
+static gboolean
+write_record (int fd, JournalOp op, GVariant *record, gsize *size, GError **error)
+{
+  gsize len = g_variant_get_size (record);
+  gsize total = JOURNAL_RECORD_HEADER_SIZE + JOURNAL_ALIGN (len);
+  g_autofree guint8 *buf = g_malloc0 (total);
+  guint32 header[2] = { GUINT32_TO_LE (len), GUINT32_TO_LE (op) };
+
+  memcpy (buf, header, sizeof (header));
+  g_variant_store (record, buf + JOURNAL_RECORD_HEADER_SIZE);
+
+  if (!write_all (fd, buf, total, error))
+    return FALSE;
+
+  *size += total;
+  return TRUE;
+}
+
+
+static void
+replay (PhoshNotifyJournal *self, const char *data, gsize len)
+{
+  gsize offset = JOURNAL_HEADER_SIZE;
+  guint32 version, next_id;
+
+  if (len < JOURNAL_HEADER_SIZE || memcmp (data, JOURNAL_MAGIC, sizeof (JOURNAL_MAGIC))) {
+    g_warning ("Journal %s is corrupt, ignoring", self->path);
+    return;
+  }
+
+  memcpy (&version, data + 8, sizeof (version));
+  if (GUINT32_FROM_LE (version) != JOURNAL_VERSION) {
+    g_debug ("Ignoring journal version %u", GUINT32_FROM_LE (version));
+    return;
+  }
+  memcpy (&next_id, data + 12, sizeof (next_id));
+  self->next_id = MAX (self->next_id, GUINT32_FROM_LE (next_id));
+
+  while (offset + JOURNAL_RECORD_HEADER_SIZE <= len) {
+    g_autoptr (GVariant) record = NULL;
+    g_autoptr (GBytes) bytes = NULL;
+    guint32 size, op;
+    guint id, record_next_id;
+
+    memcpy (&size, data + offset, sizeof (size));
+    memcpy (&op, data + offset + 4, sizeof (op));
+    size = GUINT32_FROM_LE (size);
+    op = GUINT32_FROM_LE (op);
+    offset += JOURNAL_RECORD_HEADER_SIZE;
+
+    if (size > len - offset) {
+      /* Torn write, e.g. when we crashed while writing */
+      g_debug ("Truncated record at %" G_GSIZE_FORMAT, offset);
+      return;
+    }
+
+    bytes = g_bytes_new (data + offset, size);
+    offset += JOURNAL_ALIGN (size);
+
+    switch (op) {
+    case JOURNAL_OP_ADD:
+      record = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (JOURNAL_ADD_TYPE),
+                                                             bytes, FALSE));
+      if (!g_variant_is_normal_form (record)) {
+        g_warning ("Invalid record in %s, stopping replay", self->path);
+        return;
+      }
+      g_variant_get_child (record, 0, "u", &id);
+      g_variant_get_child (record, 1, "u", &record_next_id);
+      self->next_id = MAX (self->next_id, record_next_id);
+      g_hash_table_insert (self->live, GUINT_TO_POINTER (id), g_steal_pointer (&record));
+      break;
+    case JOURNAL_OP_REMOVE:
+      record = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (JOURNAL_REMOVE_TYPE),
+                                                             bytes, FALSE));
+      if (!g_variant_is_normal_form (record)) {
+        g_warning ("Invalid record in %s, stopping replay", self->path);
+        return;
+      }
+      g_variant_get (record, JOURNAL_REMOVE_TYPE, &id);
+      g_hash_table_remove (self->live, GUINT_TO_POINTER (id));
+      break;
+    default:
+      g_warning ("Unknown record type %u in %s, stopping replay", op, self->path);
+      return;
+    }
+  }
+}
+
+
+/* Rewrite the journal with only the records of active notifications */
+static gboolean
+compact (PhoshNotifyJournal *self, GError **error)
+{
+  g_autofree char *tmp = g_strdup_printf ("%s.tmp", self->path);
+  g_autofree char *dir = g_path_get_dirname (self->path);
+  g_autoptr (GList) ids = NULL;
+  gsize size = JOURNAL_HEADER_SIZE;
+  int fd;
+
+  if (g_mkdir_with_parents (dir, 0700) < 0) {
+    g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                 "Failed to create %s: %s", dir, g_strerror (errno));
+    return FALSE;
+  }
+
+  fd = g_open (tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                 "Failed to open %s: %s", tmp, g_strerror (errno));
+    return FALSE;
+  }
+
+  if (!write_header (fd, self->next_id, error))
+    goto err;
+
+  ids = g_list_sort (g_hash_table_get_keys (self->live), cmp_id);
+  for (GList *l = ids; l; l = l->next) {
+    GVariant *record = g_hash_table_lookup (self->live, l->data);
+
+    if (!write_record (fd, JOURNAL_OP_ADD, record, &size, error))
+      goto err;
+  }
+
+  if (g_rename (tmp, self->path) < 0) {
+    g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                 "Failed to rename %s: %s", tmp, g_strerror (errno));
+    goto err;
+  }
+
+  /* We're at the end of the new file so further writes append */
+  if (self->fd >= 0)
+    close (self->fd);
+  self->fd = fd;
+  self->size = size;
+  self->compacted_size = size;
+
+  return TRUE;
+
+ err:
+  close (fd);
+  g_unlink (tmp);
+  return FALSE;
+}
+
+
+static void
+load_thread (GTask        *task,
+             gpointer      source_object,
+             gpointer      task_data,
+             GCancellable *cancellable)
+{
+  PhoshNotifyJournal *self = PHOSH_NOTIFY_JOURNAL (source_object);
+  g_autoptr (GMappedFile) mapped = NULL;
+  g_autoptr (GPtrArray) records = NULL;
+  g_autoptr (GList) ids = NULL;
+  GError *err = NULL;
+
+  mapped = g_mapped_file_new (self->path, FALSE, &err);
+  if (mapped) {
+    replay (self, g_mapped_file_get_contents (mapped), g_mapped_file_get_length (mapped));
+    g_clear_pointer (&mapped, g_mapped_file_unref);
+  } else {
+    if (!g_error_matches (err, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+      g_warning ("Failed to map %s: %s", self->path, err->message);
+    g_clear_error (&err);
+  }
+
+  if (!compact (self, &err)) {
+    g_task_return_error (task, err);
+    return;
+  }
+
+  /* Notifications are built on the main thread since looking up
+   * their app info isn't thread safe */
+  records = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_unref);
+  ids = g_list_sort (g_hash_table_get_keys (self->live), cmp_id);
+  for (GList *l = ids; l; l = l->next)
+    g_ptr_array_add (records, g_variant_ref (g_hash_table_lookup (self->live, l->data)));
+
+  g_task_return_pointer (task, g_steal_pointer (&records), (GDestroyNotify) g_ptr_array_unref);
+}
+
+
+static void
+writer_func (gpointer data, gpointer user_data)
+{
+  PhoshNotifyJournal *self = PHOSH_NOTIFY_JOURNAL (user_data);
+  JournalJob *job = data;
+  g_autoptr (GVariant) record = NULL;
+  g_autoptr (GError) err = NULL;
+  gboolean success;
+
+  if (self->fd < 0)
+    goto out;
+
+  switch (job->op) {
+  case JOURNAL_OP_ADD:
+    record = job_to_record (job);
+    self->next_id = MAX (self->next_id, job->next_id);
+    g_hash_table_insert (self->live, GUINT_TO_POINTER (job->id), g_variant_ref (record));
+    break;
+  case JOURNAL_OP_REMOVE:
+    if (!g_hash_table_remove (self->live, GUINT_TO_POINTER (job->id)))
+      goto out;
+    record = g_variant_ref_sink (g_variant_new (JOURNAL_REMOVE_TYPE, job->id));
+    break;
+  default:
+    g_assert_not_reached ();
+  }
+
+  /* Lots of large live notifications keep the compacted journal big,
+   * don't rewrite it on every update then */
+  if (self->size > MAX (JOURNAL_MAX_SIZE, 2 * self->compacted_size))
+    success = compact (self, &err);
+  else
+    success = write_record (self->fd, job->op, record, &self->size, &err);
+
+  if (!success)
+    g_warning ("Failed to update journal: %s", err->message);
+
+ out:
+  journal_job_free (job);
+}
+
+
+static void
+phosh_notify_journal_dispose (GObject *object)
+{
+  PhoshNotifyJournal *self = PHOSH_NOTIFY_JOURNAL (object);
+
+  /* Flush out pending writes */
+  if (self->writer) {
+    g_thread_pool_free (self->writer, FALSE, TRUE);
+    self->writer = NULL;
+  }
+
+  G_OBJECT_CLASS (phosh_notify_journal_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_notify_journal_finalize (GObject *object)
+{
+  PhoshNotifyJournal *self = PHOSH_NOTIFY_JOURNAL (object);
+
+  if (self->fd >= 0)
+    close (self->fd);
+
+  g_clear_pointer (&self->live, g_hash_table_destroy);
+  g_free (self->path);
+
+  G_OBJECT_CLASS (phosh_notify_journal_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_notify_journal_class_init (PhoshNotifyJournalClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = phosh_notify_journal_dispose;
+  object_class->finalize = phosh_notify_journal_finalize;
+}
+
+
+static void
+phosh_notify_journal_init (PhoshNotifyJournal *self)
+{
+  self->fd = -1;
+  self->live = g_hash_table_new_full (g_direct_hash,
+                                      g_direct_equal,
+                                      NULL,
+                                      (GDestroyNotify) g_variant_unref);
+  /* A single thread so writes happen in order */
+  self->writer = g_thread_pool_new (writer_func, self, 1, FALSE, NULL);
+}
+
+
+/**
+ * phosh_notify_journal_new:
+ * @path: The journal's file name
+ *
+ * Returns: A new #PhoshNotifyJournal
+ */
+PhoshNotifyJournal *
+phosh_notify_journal_new (const char *path)
+{
+  PhoshNotifyJournal *self;
+
+  g_return_val_if_fail (path, NULL);
+
+  self = g_object_new (PHOSH_TYPE_NOTIFY_JOURNAL, NULL);
+  self->path = g_strdup (path);
+
+  return self;
+}
+
+
+/**
+ * phosh_notify_journal_load_async:
+ * @self: The #PhoshNotifyJournal
+ * @cancellable: (nullable): A #GCancellable
+ * @callback: The callback to invoke when done
+ * @user_data: Data passed to @callback
+ *
+ * Replays and compacts the journal in a worker thread. This must be
+ * invoked once before any other operation on @self.
+ */
+void
+phosh_notify_journal_load_async (PhoshNotifyJournal  *self,
+                                 GCancellable        *cancellable,
+                                 GAsyncReadyCallback  callback,
+                                 gpointer             user_data)
+{
+  g_autoptr (GTask) task = NULL;
+
+  g_return_if_fail (PHOSH_IS_NOTIFY_JOURNAL (self));
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (task, phosh_notify_journal_load_async);
+  g_task_run_in_thread (task, load_thread);
+}
+
+
+/**
+ * phosh_notify_journal_load_finish:
+ * @self: The #PhoshNotifyJournal
+ * @result: The #GAsyncResult
+ * @next_id: (out): The next notification id to use
+ * @error: Return location for a #GError
+ *
+ * Finish loading the journal.
+ *
+ * Returns: (transfer full) (element-type PhoshNotifyJournalEntry): The
+ *   restored notifications ordered by id or %NULL on error
+ */
+GPtrArray *
+phosh_notify_journal_load_finish (PhoshNotifyJournal  *self,
+                                  GAsyncResult        *result,
+                                  guint               *next_id,
+                                  GError             **error)
+{
+  g_autoptr (GPtrArray) records = NULL;
+  GPtrArray *entries;
+
+  g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+  records = g_task_propagate_pointer (G_TASK (result), error);
+  if (records == NULL)
+    return NULL;
+
+  entries = g_ptr_array_new_with_free_func ((GDestroyNotify) phosh_notify_journal_entry_free);
+  for (guint i = 0; i < records->len; i++)
+    g_ptr_array_add (entries, entry_from_record (g_ptr_array_index (records, i)));
+
+  if (next_id)
+    *next_id = self->next_id;
+
+  return entries;
+}
+
+
+/**
+ * phosh_notify_journal_add:
+ * @self: The #PhoshNotifyJournal
+ * @source_id: The source @notification belongs to
+ * @notification: The notification to store
+ * @next_id: The next notification id that will be handed out
+ *
+ * Stores @notification in the journal. If a notification with the
+ * same id is in the journal already it is replaced. Serializing and
+ * writing happens in a separate thread. Transient notifications and
+ * ones with a sensitive category aren't stored.
+ */
+void
+phosh_notify_journal_add (PhoshNotifyJournal *self,
+                          const char         *source_id,
+                          PhoshNotification  *notification,
+                          guint               next_id)
+{
+  JournalJob *job;
+  GDateTime *timestamp;
+  GAppInfo *info;
+  GIcon *icon, *image;
+  const char *category;
+
+  g_return_if_fail (PHOSH_IS_NOTIFY_JOURNAL (self));
+  g_return_if_fail (PHOSH_IS_NOTIFICATION (notification));
+
+  category = phosh_notification_get_category (notification);
+  if (phosh_notification_get_transient (notification) ||
+      (category && g_strv_contains (sensitive_categories, category))) {
+    /* Drop an older version of the notification */
+    phosh_notify_journal_remove (self, phosh_notification_get_id (notification));
+    return;
+  }
+
+  job = g_new0 (JournalJob, 1);
+  job->op = JOURNAL_OP_ADD;
+  job->id = phosh_notification_get_id (notification);
+  job->next_id = next_id;
+  job->source_id = g_strdup (source_id);
+  job->app_name = g_strdup (phosh_notification_get_app_name (notification));
+  info = phosh_notification_get_app_info (notification);
+  if (info)
+    job->desktop_id = g_strdup (g_app_info_get_id (info));
+  job->summary = g_strdup (phosh_notification_get_summary (notification));
+  job->body = g_strdup (phosh_notification_get_body (notification));
+  icon = phosh_notification_get_app_icon (notification);
+  job->icon = icon ? g_object_ref (icon) : NULL;
+  image = phosh_notification_get_image (notification);
+  job->image = image ? g_object_ref (image) : NULL;
+  job->urgency = phosh_notification_get_urgency (notification);
+  job->actions = g_strdupv (phosh_notification_get_actions (notification));
+  job->resident = phosh_notification_get_resident (notification);
+  job->category = g_strdup (category);
+  timestamp = phosh_notification_get_timestamp (notification);
+  job->timestamp = timestamp ? g_date_time_to_unix (timestamp) : g_get_real_time () / G_USEC_PER_SEC;
+
+  g_thread_pool_push (self->writer, job, NULL);
+}
+
+
+/**
+ * phosh_notify_journal_remove:
+ * @self: The #PhoshNotifyJournal
+ * @id: The id of the notification to remove
+ *
+ * Removes the notification with the given @id from the journal.
+ */
+void
+phosh_notify_journal_remove (PhoshNotifyJournal *self, guint id)
+{
+  JournalJob *job;
+
+  g_return_if_fail (PHOSH_IS_NOTIFY_JOURNAL (self));
+
+  job = g_new0 (JournalJob, 1);
+  job->op = JOURNAL_OP_REMOVE;
+  job->id = id;
+
+  g_thread_pool_push (self->writer, job, NULL);
+}
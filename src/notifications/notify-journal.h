@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "notification.h"
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/**
+ * PhoshNotifyJournalEntry:
+ * @source_id: The source the notification belongs to
+ * @notification: The restored notification
+ *
+ * A notification restored from the journal
+ */
+typedef struct _PhoshNotifyJournalEntry {
+  char              *source_id;
+  PhoshNotification *notification;
+} PhoshNotifyJournalEntry;
+
+void phosh_notify_journal_entry_free (PhoshNotifyJournalEntry *entry);
+
+#define PHOSH_TYPE_NOTIFY_JOURNAL (phosh_notify_journal_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshNotifyJournal, phosh_notify_journal, PHOSH, NOTIFY_JOURNAL, GObject)
+
+PhoshNotifyJournal *phosh_notify_journal_new         (const char          *path);
+void                phosh_notify_journal_load_async  (PhoshNotifyJournal  *self,
+                                                      GCancellable        *cancellable,
+                                                      GAsyncReadyCallback  callback,
+                                                      gpointer             user_data);
+GPtrArray          *phosh_notify_journal_load_finish (PhoshNotifyJournal  *self,
+                                                      GAsyncResult        *result,
+                                                      guint               *next_id,
+                                                      GError             **error);
+void                phosh_notify_journal_add         (PhoshNotifyJournal  *self,
+                                                      const char          *source_id,
+                                                      PhoshNotification   *notification,
+                                                      guint                next_id);
+void                phosh_notify_journal_remove      (PhoshNotifyJournal  *self,
+                                                      guint                id);
+
+G_END_DECLS
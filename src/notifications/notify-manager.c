@@ -12,8 +12,10 @@
 
 #include <gio/gdesktopappinfo.h>
 
+#include "app-info-registry.h"
 #include "notification-banner.h"
 #include "notification-list.h"
+#include "notify-journal.h"
 #include "notify-manager.h"
 #include "shell.h"
 #include "phosh-enums.h"
@@ -24,12 +26,21 @@
 #define NOTIFICATIONS_SCHEMA_ID "org.gnome.desktop.notifications"
 #define NOTIFICATIONS_KEY_SHOW_BANNERS "show-banners"
 
+#define NOTIFICATIONS_JOURNAL_FILE "notifications.journal"
+#define NOTIFICATIONS_RESTORE_BATCH 8
+
 /**
  * SECTION:notify-manager
  * @short_description: Provides the org.freedesktop.Notification DBus interface
  * @Title: PhoshNotifyManager
  *
  * See https://developer.gnome.org/notification-spec/
+ *
+ * When a journal is enabled via phosh_notify_manager_enable_journal()
+ * active notifications are persisted and restored on the next start.
+ * While restoring incoming notifications and close requests are
+ * deferred so ids keep increasing monotonically across restarts and
+ * restored notifications can be closed.
  */
 
 #define NOTIFY_DBUS_NAME "org.freedesktop.Notifications"
@@ -49,6 +60,14 @@ typedef struct _PhoshNotifyManager
   GSettings *settings;
 
   PhoshNotificationList *list;
+
+  PhoshNotifyJournal *journal;
+  GCancellable       *cancel;
+  gboolean            restoring;
+  GPtrArray          *restore;
+  guint               restore_pos;
+  guint               restore_id;
+  GQueue              pending_calls;
 } PhoshNotifyManager;
 
 G_DEFINE_TYPE_WITH_CODE (PhoshNotifyManager,
@@ -75,6 +94,14 @@ handle_close_notification (PhoshNotifyDbusNotifications *skeleton,
   PhoshNotifyManager *self = PHOSH_NOTIFY_MANAGER (skeleton);
 
   g_return_val_if_fail (PHOSH_IS_NOTIFY_MANAGER (self), FALSE);
+
+  /* The notification might not be restored yet */
+  if (self->restoring) {
+    g_debug ("Deferring CloseNotification until notifications are restored");
+    g_queue_push_tail (&self->pending_calls, invocation);
+    return TRUE;
+  }
+
   g_debug ("DBus call CloseNotification %u", arg_id);
 
   notification = phosh_notification_list_get_by_id (self->list, arg_id);
@@ -187,11 +214,39 @@ on_notification_closed (PhoshNotifyManager      *self,
 
   g_debug ("Emitting NotificationClosed: %d, %d", id, reason);
 
+  if (self->journal)
+    phosh_notify_journal_remove (self->journal, id);
+
   phosh_notify_dbus_notifications_emit_notification_closed (
     PHOSH_NOTIFY_DBUS_NOTIFICATIONS (self), id, reason);
 }
 
 
+static void
+track_notification (PhoshNotifyManager *self,
+                    const char         *source_id,
+                    PhoshNotification  *notification)
+{
+  phosh_notification_list_add (self->list, source_id, notification);
+
+  g_signal_connect_object (notification,
+                           "expired",
+                           G_CALLBACK (on_notification_expired),
+                           self,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect_object (notification,
+                           "actioned",
+                           G_CALLBACK (on_notification_actioned),
+                           self,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect_object (notification,
+                           "closed",
+                           G_CALLBACK (on_notification_closed),
+                           self,
+                           G_CONNECT_SWAPPED);
+}
+
+
 static GIcon *
 parse_icon_data (GVariant *variant)
 {
@@ -307,6 +362,13 @@ handle_notify (PhoshNotifyDbusNotifications *skeleton,
     g_warning ("Could not get local time");
   g_return_val_if_fail (PHOSH_IS_NOTIFY_MANAGER (self), FALSE);
 
+  /* Ids and replaces_id are only valid once restored notifications are back */
+  if (self->restoring) {
+    g_debug ("Deferring Notify until notifications are restored");
+    g_queue_push_tail (&self->pending_calls, invocation);
+    return TRUE;
+  }
+
   g_debug ("DBus call Notify: %s (%u): %s (%s), %s, %d", app_name, replaces_id, summary, body, app_icon, expire_timeout);
 
   app_gicon = parse_icon_string (app_icon);
@@ -370,7 +432,8 @@ handle_notify (PhoshNotifyDbusNotifications *skeleton,
     GDesktopAppInfo *desktop_info;
     source_id = g_strdup_printf ("%s.desktop", desktop_id);
 
-    desktop_info = g_desktop_app_info_new (source_id);
+    desktop_info = phosh_app_info_registry_lookup (phosh_app_info_registry_get_default (),
+                                                   source_id);
 
     if (desktop_info) {
       info = G_APP_INFO (desktop_info);
@@ -422,23 +485,7 @@ handle_notify (PhoshNotifyDbusNotifications *skeleton,
                                            category,
                                            timestamp);
 
-    phosh_notification_list_add (self->list, source_id, notification);
-
-    g_signal_connect_object (notification,
-                             "expired",
-                             G_CALLBACK (on_notification_expired),
-                             self,
-                             G_CONNECT_SWAPPED);
-    g_signal_connect_object (notification,
-                             "actioned",
-                             G_CALLBACK (on_notification_actioned),
-                             self,
-                             G_CONNECT_SWAPPED);
-    g_signal_connect_object (notification,
-                             "closed",
-                             G_CALLBACK (on_notification_closed),
-                             self,
-                             G_CONNECT_SWAPPED);
+    track_notification (self, source_id, notification);
 
     if (expire_timeout) {
       phosh_notification_expires (notification, expire_timeout);
@@ -447,6 +494,9 @@ handle_notify (PhoshNotifyDbusNotifications *skeleton,
     g_signal_emit (self, signals[SIGNAL_NEW_NOTIFICATION], 0, notification);
   }
 
+  if (self->journal)
+    phosh_notify_journal_add (self->journal, source_id, notification, self->next_id);
+
   phosh_notify_dbus_notifications_complete_notify (
     skeleton, invocation, id);
 
@@ -464,6 +514,98 @@ phosh_notify_manager_notify_iface_init (PhoshNotifyDbusNotificationsIface *iface
 }
 
 
+static void
+restore_done (PhoshNotifyManager *self)
+{
+  GDBusMethodInvocation *invocation;
+
+  self->restoring = FALSE;
+
+  while ((invocation = g_queue_pop_head (&self->pending_calls))) {
+    GVariant *params = g_dbus_method_invocation_get_parameters (invocation);
+    const char *method = g_dbus_method_invocation_get_method_name (invocation);
+    g_autofree const char **actions = NULL;
+    g_autoptr (GVariant) hints = NULL;
+    const char *app_name, *app_icon, *summary, *body;
+    guint replaces_id;
+    int expire_timeout;
+
+    if (g_strcmp0 (method, "CloseNotification") == 0) {
+      guint id;
+
+      g_variant_get (params, "(u)", &id);
+      handle_close_notification (PHOSH_NOTIFY_DBUS_NOTIFICATIONS (self), invocation, id);
+      continue;
+    }
+
+    g_variant_get (params, "(&su&s&s&s^a&s@a{sv}i)",
+                   &app_name, &replaces_id, &app_icon, &summary, &body,
+                   &actions, &hints, &expire_timeout);
+    handle_notify (PHOSH_NOTIFY_DBUS_NOTIFICATIONS (self), invocation,
+                   app_name, replaces_id, app_icon, summary, body,
+                   actions, hints, expire_timeout);
+  }
+}
+
+
+static gboolean
+restore_idle_cb (PhoshNotifyManager *self)
+{
+  /* Restore in small batches to not block the main loop */
+  for (int i = 0; i < NOTIFICATIONS_RESTORE_BATCH && self->restore_pos < self->restore->len; i++) {
+    PhoshNotifyJournalEntry *entry = g_ptr_array_index (self->restore, self->restore_pos++);
+    guint id = phosh_notification_get_id (entry->notification);
+
+    if (phosh_notification_list_get_by_id (self->list, id))
+      continue;
+
+    g_debug ("Restoring notification %u", id);
+    track_notification (self, entry->source_id, entry->notification);
+  }
+
+  if (self->restore_pos < self->restore->len)
+    return G_SOURCE_CONTINUE;
+
+  self->restore_id = 0;
+  g_clear_pointer (&self->restore, g_ptr_array_unref);
+  restore_done (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+on_journal_loaded (GObject      *source_object,
+                   GAsyncResult *res,
+                   gpointer      user_data)
+{
+  PhoshNotifyManager *self;
+  g_autoptr (GError) err = NULL;
+  GPtrArray *entries;
+  guint next_id = 0;
+
+  entries = phosh_notify_journal_load_finish (PHOSH_NOTIFY_JOURNAL (source_object), res,
+                                              &next_id, &err);
+  if (entries == NULL && g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    return;
+
+  self = PHOSH_NOTIFY_MANAGER (user_data);
+  if (entries == NULL) {
+    g_warning ("Failed to load notification journal: %s", err->message);
+    g_clear_object (&self->journal);
+    restore_done (self);
+    return;
+  }
+
+  g_debug ("Restoring %u notifications, next id %u", entries->len, next_id);
+  self->next_id = MAX (self->next_id, next_id);
+  self->restore = entries;
+  self->restore_pos = 0;
+  self->restore_id = g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) restore_idle_cb, self, NULL);
+  g_source_set_name_by_id (self->restore_id, "[phosh] restore notifications");
+}
+
+
 static void
 on_notifications_setting_changed (PhoshNotifyManager *self,
                                   const char         *key,
@@ -515,6 +657,20 @@ static void
 phosh_notify_manager_dispose (GObject *object)
 {
   PhoshNotifyManager *self = PHOSH_NOTIFY_MANAGER (object);
+  GDBusMethodInvocation *invocation;
+
+  g_cancellable_cancel (self->cancel);
+  g_clear_object (&self->cancel);
+  if (self->restore_id) {
+    g_source_remove (self->restore_id);
+    self->restore_id = 0;
+  }
+  g_clear_pointer (&self->restore, g_ptr_array_unref);
+  while ((invocation = g_queue_pop_head (&self->pending_calls))) {
+    g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED,
+                                           "Notification server shutting down");
+  }
+  g_clear_object (&self->journal);
 
   g_clear_object (&self->settings);
 
@@ -583,6 +739,7 @@ phosh_notify_manager_init (PhoshNotifyManager *self)
   self->next_id = 1;
 
   self->list = phosh_notification_list_new ();
+  g_queue_init (&self->pending_calls);
 }
 
 
@@ -632,3 +789,34 @@ phosh_notify_manager_get_show_banners (PhoshNotifyManager *self)
 
   return self->show_banners;
 }
+
+
+/**
+ * phosh_notify_manager_enable_journal:
+ * @self: the #PhoshNotifyManager
+ * @path: (nullable): The journal's file name or %NULL for the default
+ *
+ * Persist active notifications to the journal at @path and restore
+ * the ones from a previous run. Loading happens in a worker thread and
+ * notifications are restored from an idle callback so this doesn't
+ * block startup.
+ */
+void
+phosh_notify_manager_enable_journal (PhoshNotifyManager *self, const char *path)
+{
+  g_autofree char *default_path = NULL;
+
+  g_return_if_fail (PHOSH_IS_NOTIFY_MANAGER (self));
+  g_return_if_fail (self->journal == NULL);
+
+  if (path == NULL) {
+    default_path = g_build_filename (g_get_user_cache_dir (), "phosh",
+                                     NOTIFICATIONS_JOURNAL_FILE, NULL);
+    path = default_path;
+  }
+
+  self->journal = phosh_notify_journal_new (path);
+  self->cancel = g_cancellable_new ();
+  self->restoring = TRUE;
+  phosh_notify_journal_load_async (self->journal, self->cancel, on_journal_loaded, self);
+}
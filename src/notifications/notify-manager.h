@@ -22,6 +22,8 @@ G_DECLARE_FINAL_TYPE (PhoshNotifyManager, phosh_notify_manager, PHOSH, NOTIFY_MA
 PhoshNotifyManager    *phosh_notify_manager_get_default      (void);
 PhoshNotificationList *phosh_notify_manager_get_list         (PhoshNotifyManager *self);
 gboolean               phosh_notify_manager_get_show_banners (PhoshNotifyManager *self);
+void                   phosh_notify_manager_enable_journal   (PhoshNotifyManager *self,
+                                                              const char         *path);
 
 
 G_END_DECLS
@@ -6,6 +6,7 @@
 
 #define G_LOG_DOMAIN "phosh-timestamp-label"
 
+#include "display-state.h"
 #include "timestamp-label.h"
 #include "config.h"
 #include <glib/gi18n.h>
@@ -17,6 +18,8 @@
  *
  * The #PhoshTimestampLabel is used to display the time difference between
  * the timestamp stored in the #PhoshTimestampLabel and the current time.
+ * While the display is off the label isn't refreshed, it catches up
+ * once the display is on again.
  */
 
 
@@ -24,6 +27,7 @@ struct _PhoshTimestampLabel {
   GtkLabel   parent;
   GDateTime *date;
   guint      refresh_time;
+  gboolean   stale;
 };
 
 
@@ -277,7 +281,14 @@ phosh_timestamp_label_update (PhoshTimestampLabel *self)
 {
   g_autofree char *str = NULL;
   GTimeSpan time = 0;
-  if (self->date != NULL) {
+  PhoshDisplayState *state = phosh_display_state_get_default ();
+
+  if (self->date != NULL && phosh_display_state_get_display_off (state)) {
+    /* Nothing to see, refresh when the display is on again */
+    phosh_display_state_add_avoided_wakeups (state, 1);
+    g_clear_handle_id (&(self->refresh_time), g_source_remove);
+    self->stale = TRUE;
+  } else if (self->date != NULL) {
     str = phosh_time_ago_in_words (self ->date);
     gtk_label_set_label (GTK_LABEL (self), str);
 
@@ -295,6 +306,19 @@ phosh_timestamp_label_update (PhoshTimestampLabel *self)
 }
 
 
+static void
+on_display_off_changed (PhoshTimestampLabel *self,
+                        GParamSpec          *pspec,
+                        PhoshDisplayState   *state)
+{
+  if (phosh_display_state_get_display_off (state) || !self->stale)
+    return;
+
+  self->stale = FALSE;
+  phosh_timestamp_label_update (self);
+}
+
+
 static void
 phosh_timestamp_label_get_property (GObject    *object,
                                     guint       property_id,
@@ -375,6 +399,12 @@ phosh_timestamp_label_init (PhoshTimestampLabel *self)
   gtk_label_set_attributes (GTK_LABEL (self), attrs);
 
   g_clear_pointer (&attrs, pango_attr_list_unref);
+
+  g_signal_connect_object (phosh_display_state_get_default (),
+                           "notify::display-off",
+                           G_CALLBACK (on_display_off_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
 }
 
 
@@ -18,6 +18,7 @@
 #include "util.h"
 #include "toplevel-manager.h"
 #include "toplevel-thumbnail.h"
+#include "trace.h"
 #include "phosh-private-client-protocol.h"
 #include "phosh-wayland.h"
 
@@ -26,7 +27,13 @@
 #define HANDY_USE_UNSTABLE_API
 #include <handy.h>
 
+#include <math.h>
+
 #define OVERVIEW_ICON_SIZE 64
+/* Pages around the current one that get a full activity */
+#define OVERVIEW_ATTACHED_PAGES 1
+/* Unused activities kept around for reuse */
+#define OVERVIEW_MAX_SPARE_ACTIVITIES (2 * OVERVIEW_ATTACHED_PAGES + 1)
 
 /**
  * SECTION:overview
@@ -36,6 +43,19 @@
  *
  * The #PhoshOverview shows running apps (#PhoshActivity) and
  * the app grid (#PhoshAppGrid) to launch new applications.
+ *
+ * Each running app gets a lightweight slot in the carousel. Only
+ * the slots around the current page hold a full #PhoshActivity
+ * (and request a thumbnail). When swiping, activities of slots that
+ * move out of range are recycled for the slots moving into range so
+ * the cost of opening the overview doesn't grow with the number of
+ * running apps.
+ *
+ * When the home bar starts to unfold phosh_overview_prefetch() requests
+ * the thumbnails of the attached activities right away, sized from the
+ * monitor if the activities weren't allocated yet, so the frames arrive
+ * while the unfold animation runs. Thumbnails that fail or whose
+ * toplevel closes meanwhile don't hold back the measurement.
  */
 
 enum {
@@ -52,6 +72,16 @@ typedef struct
   /* Running activities */
   GtkWidget *carousel_running_activities;
   GtkWidget *app_grid;
+
+  /* Activities not attached to a slot */
+  GPtrArray *spare_activities;
+  int        attached_page;
+
+  /* Unfold → thumbnails painted measurement */
+  gint64      prefetch_begin;
+  guint       prefetch_requested;
+  /* toplevel -> thumbnail not ready yet */
+  GHashTable *prefetch_pending;
 } PhoshOverviewPrivate;
 
 
@@ -76,25 +106,30 @@ get_toplevel_from_activity (PhoshActivity *activity)
 
 
 static PhoshActivity *
-find_activity_by_toplevel (PhoshOverview        *self,
-                           PhoshToplevel        *needle)
+get_activity_from_slot (GtkWidget *slot)
+{
+  return g_object_get_data (G_OBJECT (slot), "activity");
+}
+
+
+static GtkWidget *
+find_slot_by_toplevel (PhoshOverview        *self,
+                       PhoshToplevel        *needle)
 {
   g_autoptr(GList) children;
-  PhoshActivity *activity = NULL;
+  GtkWidget *slot = NULL;
   PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
 
   children = gtk_container_get_children (GTK_CONTAINER (priv->carousel_running_activities));
   for (GList *l = children; l; l = l->next) {
-    PhoshToplevel *toplevel;
-
-    activity = PHOSH_ACTIVITY (l->data);
-    toplevel = get_toplevel_from_activity (activity);
-    if (toplevel == needle)
+    if (g_object_get_data (G_OBJECT (l->data), "toplevel") == needle) {
+      slot = l->data;
       break;
+    }
   }
 
-  g_return_val_if_fail (activity, NULL);
-  return activity;
+  g_return_val_if_fail (slot, NULL);
+  return slot;
 }
 
 
@@ -139,26 +174,10 @@ on_activity_close_clicked (PhoshOverview *self, PhoshActivity *activity)
 
 
 static void
-on_toplevel_closed (PhoshToplevel *toplevel, PhoshActivity *activity)
+on_thumbnail_failed (PhoshThumbnail *thumbnail, PhoshActivity *activity)
 {
-  g_return_if_fail (PHOSH_IS_TOPLEVEL (toplevel));
-  g_return_if_fail (PHOSH_IS_ACTIVITY (activity));
-  gtk_widget_destroy (GTK_WIDGET (activity));
-}
-
-
-static void
-on_toplevel_activated_changed (PhoshToplevel *toplevel, GParamSpec *pspec, PhoshOverview *overview)
-{
-  PhoshActivity *activity;
-  PhoshOverviewPrivate *priv;
-  g_return_if_fail (PHOSH_IS_OVERVIEW (overview));
-  g_return_if_fail (PHOSH_IS_TOPLEVEL (toplevel));
-  priv = phosh_overview_get_instance_private (overview);
-
-  activity = find_activity_by_toplevel (overview, toplevel);
-  if (phosh_toplevel_is_activated (toplevel))
-    hdy_carousel_scroll_to (HDY_CAROUSEL (priv->carousel_running_activities), GTK_WIDGET (activity));
+  /* Never becomes ready so nobody else takes it */
+  g_object_unref (thumbnail);
 }
 
 
@@ -168,72 +187,339 @@ on_thumbnail_ready_changed (PhoshThumbnail *thumbnail, GParamSpec *pspec, PhoshA
   g_return_if_fail (PHOSH_IS_THUMBNAIL (thumbnail));
   g_return_if_fail (PHOSH_IS_ACTIVITY (activity));
 
+  /* The activity got recycled for another toplevel meanwhile */
+  if (g_object_get_data (G_OBJECT (thumbnail), "toplevel") !=
+      g_object_get_data (G_OBJECT (activity), "toplevel")) {
+    g_object_unref (thumbnail);
+    return;
+  }
+
   phosh_activity_set_thumbnail (activity, thumbnail);
 }
 
 
 static void
-request_thumbnail (PhoshActivity *activity, PhoshToplevel *toplevel)
+get_thumbnail_size (PhoshActivity *activity, int *width, int *height)
 {
-  PhoshToplevelThumbnail *thumbnail;
+  PhoshMonitor *monitor;
   GtkAllocation allocation;
   int scale;
-  g_return_if_fail (PHOSH_IS_ACTIVITY (activity));
-  g_return_if_fail (PHOSH_IS_TOPLEVEL (toplevel));
+
   scale = gtk_widget_get_scale_factor (GTK_WIDGET (activity));
   gtk_widget_get_allocation (GTK_WIDGET (activity), &allocation);
-  thumbnail = phosh_toplevel_thumbnail_new_from_toplevel (toplevel, allocation.width * scale, allocation.height * scale);
+  if (allocation.width > 1 && allocation.height > 1) {
+    *width = allocation.width * scale;
+    *height = allocation.height * scale;
+    return;
+  }
+
+  /* Not allocated yet: the card takes about the upper half of the monitor */
+  monitor = phosh_shell_get_primary_monitor (phosh_shell_get_default ());
+  if (monitor) {
+    *width = monitor->width;
+    *height = monitor->height / 2;
+  } else {
+    *width = *height = 0;
+  }
+}
+
+
+static PhoshToplevelThumbnail *
+request_thumbnail (PhoshActivity *activity, PhoshToplevel *toplevel, int width, int height)
+{
+  PhoshToplevelThumbnail *thumbnail;
+  g_return_val_if_fail (PHOSH_IS_ACTIVITY (activity), NULL);
+  g_return_val_if_fail (PHOSH_IS_TOPLEVEL (toplevel), NULL);
+
+  thumbnail = phosh_toplevel_thumbnail_new_from_toplevel (toplevel, width, height);
+  if (thumbnail == NULL)
+    return NULL;
+
+  g_object_set_data (G_OBJECT (thumbnail), "toplevel", toplevel);
   g_signal_connect_object (thumbnail, "notify::ready", G_CALLBACK (on_thumbnail_ready_changed), activity, 0);
+  g_signal_connect_object (thumbnail, "failed", G_CALLBACK (on_thumbnail_failed), activity, 0);
+  g_object_set_data (G_OBJECT (activity), "thumbnail-width", GINT_TO_POINTER (width));
+  g_object_set_data (G_OBJECT (activity), "thumbnail-height", GINT_TO_POINTER (height));
+
+  return thumbnail;
 }
 
 
 static void
-on_activity_size_allocated (PhoshActivity *activity, GtkAllocation *alloc, PhoshToplevel *toplevel)
+on_activity_size_allocated (PhoshActivity *activity, GtkAllocation *alloc, gpointer unused)
 {
-  request_thumbnail (activity, toplevel);
+  PhoshToplevel *toplevel = g_object_get_data (G_OBJECT (activity), "toplevel");
+  int scale, width, height;
+
+  /* Spare activities don't need a thumbnail */
+  if (toplevel == NULL)
+    return;
+
+  scale = gtk_widget_get_scale_factor (GTK_WIDGET (activity));
+  width = alloc->width * scale;
+  height = alloc->height * scale;
+
+  /* Already requested at that size when attached or prefetched */
+  if (GPOINTER_TO_INT (g_object_get_data (G_OBJECT (activity), "thumbnail-width")) == width &&
+      GPOINTER_TO_INT (g_object_get_data (G_OBJECT (activity), "thumbnail-height")) == height)
+    return;
+
+  request_thumbnail (activity, toplevel, width, height);
 }
 
 
 static void
-add_activity (PhoshOverview *self, PhoshToplevel *toplevel)
+on_after_paint (PhoshOverview *self, GdkFrameClock *frame_clock)
 {
-  PhoshMonitor *monitor = phosh_shell_get_primary_monitor (phosh_shell_get_default ());
-  PhoshOverviewPrivate *priv;
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+
+  g_signal_handlers_disconnect_by_func (frame_clock, on_after_paint, self);
+  phosh_trace_mark ("overview-unfold", priv->prefetch_begin, "%u thumbnails painted",
+                    priv->prefetch_requested);
+}
+
+
+static void
+prefetch_done (PhoshOverview *self, PhoshToplevel *toplevel)
+{
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+  GdkFrameClock *frame_clock;
+
+  if (priv->prefetch_pending == NULL || !g_hash_table_remove (priv->prefetch_pending, toplevel))
+    return;
+
+  if (g_hash_table_size (priv->prefetch_pending))
+    return;
+
+  /* The last thumbnail got set, measure until it hit the screen */
+  frame_clock = gtk_widget_get_frame_clock (GTK_WIDGET (self));
+  if (frame_clock == NULL) {
+    phosh_trace_mark ("overview-unfold", priv->prefetch_begin, "%u thumbnails (unmapped)",
+                      priv->prefetch_requested);
+    return;
+  }
+
+  g_signal_connect_object (frame_clock, "after-paint",
+                           G_CALLBACK (on_after_paint),
+                           self,
+                           G_CONNECT_SWAPPED);
+}
+
+
+static void
+on_prefetched_thumbnail_done (PhoshOverview *self, PhoshThumbnail *thumbnail)
+{
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+  PhoshToplevel *toplevel = g_object_get_data (G_OBJECT (thumbnail), "toplevel");
+
+  /* Belongs to an earlier unfold */
+  if (g_hash_table_lookup (priv->prefetch_pending, toplevel) != thumbnail)
+    return;
+
+  prefetch_done (self, toplevel);
+}
+
+
+static void
+on_prefetched_thumbnail_ready (PhoshOverview *self, GParamSpec *pspec, PhoshThumbnail *thumbnail)
+{
+  if (!phosh_thumbnail_is_ready (thumbnail))
+    return;
+
+  on_prefetched_thumbnail_done (self, thumbnail);
+}
+
+
+static PhoshActivity *
+get_spare_activity (PhoshOverview *self)
+{
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
   GtkWidget *activity;
+
+  if (priv->spare_activities->len)
+    return g_ptr_array_steal_index_fast (priv->spare_activities, priv->spare_activities->len - 1);
+
+  activity = g_object_ref_sink (g_object_new (PHOSH_TYPE_ACTIVITY, NULL));
+  g_signal_connect_swapped (activity, "clicked", G_CALLBACK (on_activity_clicked), self);
+  g_signal_connect_swapped (activity, "close-clicked",
+                            G_CALLBACK (on_activity_close_clicked), self);
+  g_signal_connect (activity, "size-allocate", G_CALLBACK (on_activity_size_allocated), NULL);
+  phosh_connect_button_feedback (GTK_BUTTON (activity));
+
+  return PHOSH_ACTIVITY (activity);
+}
+
+
+static void
+attach_activity (PhoshOverview *self, GtkWidget *slot)
+{
+  PhoshMonitor *monitor = phosh_shell_get_primary_monitor (phosh_shell_get_default ());
+  PhoshToplevel *toplevel = g_object_get_data (G_OBJECT (slot), "toplevel");
+  PhoshActivity *activity;
+  GBinding *binding;
+  GtkAllocation alloc;
   const char *app_id, *title;
 
-  g_return_if_fail (PHOSH_IS_OVERVIEW (self));
-  priv = phosh_overview_get_instance_private (self);
+  if (get_activity_from_slot (slot))
+    return;
 
   app_id = phosh_toplevel_get_app_id (toplevel);
   title = phosh_toplevel_get_title (toplevel);
 
   g_debug ("Building activator for '%s' (%s)", app_id, title);
-  activity = phosh_activity_new (app_id, title);
-  g_object_set (activity,
-                "win-width", monitor->width / monitor->scale,  /* TODO: Get the real size somehow */
-                "win-height", monitor->height / monitor->scale,
-                "maximized", phosh_toplevel_is_maximized (toplevel),
-                NULL);
+  activity = get_spare_activity (self);
+  phosh_activity_set_app_id (activity, app_id);
+  phosh_activity_set_title (activity, title);
+  phosh_activity_set_thumbnail (activity, NULL);
+
+  gtk_widget_get_allocation (GTK_WIDGET (self), &alloc);
+  if (alloc.width > 1 && alloc.height > 1) {
+    g_object_set (activity, "win-width", alloc.width, "win-height", alloc.height, NULL);
+  } else if (monitor) {
+    g_object_set (activity,
+                  "win-width", monitor->width / monitor->scale,  /* TODO: Get the real size somehow */
+                  "win-height", monitor->height / monitor->scale,
+                  NULL);
+  }
   g_object_set_data (G_OBJECT (activity), "toplevel", toplevel);
+  binding = g_object_bind_property (toplevel, "maximized", activity, "maximized", G_BINDING_SYNC_CREATE);
+  g_object_set_data (G_OBJECT (activity), "binding", binding);
 
-  gtk_container_add (GTK_CONTAINER (priv->carousel_running_activities), activity);
-  gtk_widget_show (activity);
+  g_object_set_data (G_OBJECT (slot), "activity", activity);
+  gtk_container_add (GTK_CONTAINER (slot), GTK_WIDGET (activity));
+  gtk_widget_show (GTK_WIDGET (activity));
+  g_object_unref (activity);
+}
 
-  g_signal_connect_swapped (activity, "clicked", G_CALLBACK (on_activity_clicked), self);
-  g_signal_connect_swapped (activity, "close-clicked",
-                            G_CALLBACK (on_activity_close_clicked), self);
 
-  g_signal_connect_object (toplevel, "closed", G_CALLBACK (on_toplevel_closed), activity, 0);
-  g_signal_connect_object (toplevel, "notify::activated", G_CALLBACK (on_toplevel_activated_changed), self, 0);
-  g_object_bind_property (toplevel, "maximized", activity, "maximized", G_BINDING_DEFAULT);
+static void
+detach_activity (PhoshOverview *self, GtkWidget *slot)
+{
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+  PhoshActivity *activity = get_activity_from_slot (slot);
 
-  g_signal_connect (activity, "size-allocate", G_CALLBACK (on_activity_size_allocated), toplevel);
+  if (activity == NULL)
+    return;
 
-  phosh_connect_button_feedback (GTK_BUTTON (activity));
+  g_debug ("Recycling activator for '%s'", phosh_activity_get_app_id (activity));
+  g_object_ref (activity);
+  g_object_set_data (G_OBJECT (slot), "activity", NULL);
+  gtk_container_remove (GTK_CONTAINER (slot), GTK_WIDGET (activity));
+
+  g_binding_unbind (g_object_get_data (G_OBJECT (activity), "binding"));
+  g_object_set_data (G_OBJECT (activity), "binding", NULL);
+  g_object_set_data (G_OBJECT (activity), "toplevel", NULL);
+  g_object_set_data (G_OBJECT (activity), "thumbnail-width", NULL);
+  g_object_set_data (G_OBJECT (activity), "thumbnail-height", NULL);
+  phosh_activity_set_thumbnail (activity, NULL);
+
+  if (priv->spare_activities->len < OVERVIEW_MAX_SPARE_ACTIVITIES) {
+    g_ptr_array_add (priv->spare_activities, activity);
+  } else {
+    gtk_widget_destroy (GTK_WIDGET (activity));
+    g_object_unref (activity);
+  }
+}
+
+
+static void
+update_attached_activities (PhoshOverview *self)
+{
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+  g_autoptr(GList) children = NULL;
+  int current, i = 0;
+  GList *l;
+
+  current = round (hdy_carousel_get_position (HDY_CAROUSEL (priv->carousel_running_activities)));
+  priv->attached_page = current;
+  children = gtk_container_get_children (GTK_CONTAINER (priv->carousel_running_activities));
+
+  /* Detach first so activities can be recycled right away */
+  for (l = children, i = 0; l; l = l->next, i++) {
+    if (ABS (i - current) > OVERVIEW_ATTACHED_PAGES)
+      detach_activity (self, l->data);
+  }
+
+  for (l = children, i = 0; l; l = l->next, i++) {
+    if (ABS (i - current) <= OVERVIEW_ATTACHED_PAGES)
+      attach_activity (self, l->data);
+  }
+}
+
+
+static void
+on_carousel_position_changed (PhoshOverview *self)
+{
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+  int current;
+
+  current = round (hdy_carousel_get_position (HDY_CAROUSEL (priv->carousel_running_activities)));
+  if (current == priv->attached_page)
+    return;
+
+  update_attached_activities (self);
+}
+
+
+static void
+on_toplevel_closed (PhoshOverview *self, PhoshToplevel *toplevel)
+{
+  GtkWidget *slot;
+
+  g_return_if_fail (PHOSH_IS_OVERVIEW (self));
+  g_return_if_fail (PHOSH_IS_TOPLEVEL (toplevel));
+
+  /* Its thumbnail won't arrive anymore */
+  prefetch_done (self, toplevel);
+
+  slot = find_slot_by_toplevel (self, toplevel);
+  g_return_if_fail (slot);
 
+  detach_activity (self, slot);
+  gtk_widget_destroy (slot);
+  update_attached_activities (self);
+}
+
+
+static void
+on_toplevel_activated_changed (PhoshToplevel *toplevel, GParamSpec *pspec, PhoshOverview *overview)
+{
+  GtkWidget *slot;
+  PhoshOverviewPrivate *priv;
+  g_return_if_fail (PHOSH_IS_OVERVIEW (overview));
+  g_return_if_fail (PHOSH_IS_TOPLEVEL (toplevel));
+  priv = phosh_overview_get_instance_private (overview);
+
+  slot = find_slot_by_toplevel (overview, toplevel);
   if (phosh_toplevel_is_activated (toplevel))
-    hdy_carousel_scroll_to (HDY_CAROUSEL (priv->carousel_running_activities), activity);
+    hdy_carousel_scroll_to (HDY_CAROUSEL (priv->carousel_running_activities), slot);
+}
+
+
+static void
+add_activity (PhoshOverview *self, PhoshToplevel *toplevel)
+{
+  PhoshOverviewPrivate *priv;
+  GtkWidget *slot;
+
+  g_return_if_fail (PHOSH_IS_OVERVIEW (self));
+  priv = phosh_overview_get_instance_private (self);
+
+  /* The activity itself is only built when the slot gets close to the current page */
+  slot = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_widget_set_hexpand (slot, TRUE);
+  gtk_widget_set_vexpand (slot, TRUE);
+  g_object_set_data (G_OBJECT (slot), "toplevel", toplevel);
+  gtk_container_add (GTK_CONTAINER (priv->carousel_running_activities), slot);
+  gtk_widget_show (slot);
+
+  g_signal_connect_object (toplevel, "closed", G_CALLBACK (on_toplevel_closed), self, G_CONNECT_SWAPPED);
+  g_signal_connect_object (toplevel, "notify::activated", G_CALLBACK (on_toplevel_activated_changed), self, 0);
+
+  if (phosh_toplevel_is_activated (toplevel))
+    hdy_carousel_scroll_to (HDY_CAROUSEL (priv->carousel_running_activities), slot);
+
+  update_attached_activities (self);
 }
 
 
@@ -274,18 +560,26 @@ toplevel_changed_cb (PhoshOverview        *self,
                      PhoshToplevelManager *manager)
 {
   PhoshActivity *activity;
+  GtkWidget *slot;
+  int width, height;
 
   g_return_if_fail (PHOSH_IS_OVERVIEW (self));
   g_return_if_fail (PHOSH_IS_TOPLEVEL (toplevel));
   g_return_if_fail (PHOSH_IS_TOPLEVEL_MANAGER (manager));
 
-  activity = find_activity_by_toplevel (self, toplevel);
-  g_return_if_fail (activity);
+  slot = find_slot_by_toplevel (self, toplevel);
+  g_return_if_fail (slot);
+
+  /* Detached slots pick up the changes once attached */
+  activity = get_activity_from_slot (slot);
+  if (activity == NULL)
+    return;
 
   /* TODO: update other properties */
   phosh_activity_set_title (activity,
                             phosh_toplevel_get_title (toplevel));
-  request_thumbnail (activity, toplevel);
+  get_thumbnail_size (activity, &width, &height);
+  request_thumbnail (activity, toplevel, width, height);
 }
 
 
@@ -317,7 +611,12 @@ phosh_overview_size_allocate (GtkWidget     *widget,
   children = gtk_container_get_children (GTK_CONTAINER (priv->carousel_running_activities));
 
   for (l = children; l; l = l->next) {
-    g_object_set (l->data,
+    PhoshActivity *activity = get_activity_from_slot (l->data);
+
+    if (activity == NULL)
+      continue;
+
+    g_object_set (activity,
                   "win-width", alloc->width,
                   "win-height", alloc->height,
                   NULL);
@@ -365,6 +664,11 @@ phosh_overview_constructed (GObject *object)
                            self,
                            G_CONNECT_SWAPPED);
 
+  g_signal_connect_object (priv->carousel_running_activities, "notify::position",
+                           G_CALLBACK (on_carousel_position_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
+
   get_running_activities (self);
 
   g_signal_connect_swapped (priv->app_grid, "app-launched",
@@ -372,6 +676,27 @@ phosh_overview_constructed (GObject *object)
 }
 
 
+static void
+phosh_overview_dispose (GObject *object)
+{
+  PhoshOverview *self = PHOSH_OVERVIEW (object);
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+
+  if (priv->spare_activities) {
+    for (guint i = 0; i < priv->spare_activities->len; i++) {
+      GtkWidget *activity = g_ptr_array_index (priv->spare_activities, i);
+
+      gtk_widget_destroy (activity);
+      g_object_unref (activity);
+    }
+    g_clear_pointer (&priv->spare_activities, g_ptr_array_unref);
+  }
+  g_clear_pointer (&priv->prefetch_pending, g_hash_table_destroy);
+
+  G_OBJECT_CLASS (phosh_overview_parent_class)->dispose (object);
+}
+
+
 static void
 phosh_overview_class_init (PhoshOverviewClass *klass)
 {
@@ -379,6 +704,7 @@ phosh_overview_class_init (PhoshOverviewClass *klass)
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
   object_class->constructed = phosh_overview_constructed;
+  object_class->dispose = phosh_overview_dispose;
   widget_class->size_allocate = phosh_overview_size_allocate;
 
   gtk_widget_class_set_css_name (widget_class, "phosh-overview");
@@ -411,6 +737,12 @@ phosh_overview_class_init (PhoshOverviewClass *klass)
 static void
 phosh_overview_init (PhoshOverview *self)
 {
+  PhoshOverviewPrivate *priv = phosh_overview_get_instance_private (self);
+
+  priv->spare_activities = g_ptr_array_new ();
+  priv->prefetch_pending = g_hash_table_new (NULL, NULL);
+  priv->attached_page = -1;
+
   gtk_widget_init_template (GTK_WIDGET (self));
 }
 
@@ -425,6 +757,61 @@ phosh_overview_reset (PhoshOverview *self)
 }
 
 
+/**
+ * phosh_overview_prefetch:
+ * @self: The #PhoshOverview
+ *
+ * Request fresh thumbnails for the activities around the current page
+ * so they're likely ready by the time the overview is fully visible.
+ * Invoke this as soon as the overview starts to become visible. The
+ * time until all of them got painted is recorded as `overview-unfold`
+ * trace mark.
+ */
+void
+phosh_overview_prefetch (PhoshOverview *self)
+{
+  PhoshOverviewPrivate *priv;
+  g_autoptr(GList) children = NULL;
+
+  g_return_if_fail (PHOSH_IS_OVERVIEW (self));
+  priv = phosh_overview_get_instance_private (self);
+
+  priv->prefetch_begin = phosh_trace_now ();
+  priv->prefetch_requested = 0;
+  g_hash_table_remove_all (priv->prefetch_pending);
+
+  update_attached_activities (self);
+
+  children = gtk_container_get_children (GTK_CONTAINER (priv->carousel_running_activities));
+  for (GList *l = children; l; l = l->next) {
+    PhoshActivity *activity = get_activity_from_slot (l->data);
+    PhoshToplevelThumbnail *thumbnail;
+    int width, height;
+
+    if (activity == NULL)
+      continue;
+
+    get_thumbnail_size (activity, &width, &height);
+    thumbnail = request_thumbnail (activity, get_toplevel_from_activity (activity), width, height);
+    if (thumbnail == NULL)
+      continue;
+
+    g_signal_connect_object (thumbnail, "notify::ready",
+                             G_CALLBACK (on_prefetched_thumbnail_ready),
+                             self,
+                             G_CONNECT_SWAPPED);
+    g_signal_connect_object (thumbnail, "failed",
+                             G_CALLBACK (on_prefetched_thumbnail_done),
+                             self,
+                             G_CONNECT_SWAPPED);
+    g_hash_table_insert (priv->prefetch_pending, get_toplevel_from_activity (activity), thumbnail);
+    priv->prefetch_requested++;
+  }
+
+  g_debug ("Prefetching %u thumbnails", priv->prefetch_requested);
+}
+
+
 GtkWidget *
 phosh_overview_new (void)
 {
@@ -16,6 +16,7 @@
 
 #include "bt-info.h"
 #include "connectivity-info.h"
+#include "display-state.h"
 #include "panel.h"
 #include "shell.h"
 #include "session.h"
@@ -53,6 +54,7 @@ typedef struct {
   GtkWidget *settings;       /* settings menu */
 
   GnomeWallClock *wall_clock;
+  gint64 clock_paused;
   GnomeXkbInfo *xkbinfo;
   GSettings *input_settings;
   GdkSeat *seat;
@@ -151,6 +153,41 @@ wall_clock_notify_cb (PhoshPanel *self,
 }
 
 
+static void
+wall_clock_start (PhoshPanel *self)
+{
+  PhoshPanelPrivate *priv = phosh_panel_get_instance_private (self);
+
+  priv->wall_clock = gnome_wall_clock_new ();
+  g_signal_connect_object (priv->wall_clock,
+                           "notify::clock",
+                           G_CALLBACK (wall_clock_notify_cb),
+                           self,
+                           G_CONNECT_SWAPPED);
+  wall_clock_notify_cb (self, NULL, priv->wall_clock);
+}
+
+
+/* The wall clock wakes up every minute so drop it while the display is off */
+static void
+on_display_off_changed (PhoshPanel        *self,
+                        GParamSpec        *pspec,
+                        PhoshDisplayState *state)
+{
+  PhoshPanelPrivate *priv = phosh_panel_get_instance_private (self);
+
+  if (phosh_display_state_get_display_off (state)) {
+    g_clear_object (&priv->wall_clock);
+    priv->clock_paused = g_get_monotonic_time ();
+  } else if (priv->wall_clock == NULL) {
+    gint64 paused = g_get_monotonic_time () - priv->clock_paused;
+
+    phosh_display_state_add_avoided_wakeups (state, paused / (60 * G_USEC_PER_SEC));
+    wall_clock_start (self);
+  }
+}
+
+
 static gboolean
 needs_keyboard_label (PhoshPanel *self)
 {
@@ -279,13 +316,6 @@ phosh_panel_constructed (GObject *object)
   G_OBJECT_CLASS (phosh_panel_parent_class)->constructed (object);
 
   priv->state = PHOSH_PANEL_STATE_FOLDED;
-  priv->wall_clock = gnome_wall_clock_new ();
-
-  g_signal_connect_object (priv->wall_clock,
-                           "notify::clock",
-                           G_CALLBACK (wall_clock_notify_cb),
-                           self,
-                           G_CONNECT_SWAPPED);
 
   g_signal_connect_object (priv->btn_top_panel,
                            "clicked",
@@ -306,7 +336,13 @@ phosh_panel_constructed (GObject *object)
   gtk_style_context_remove_class (gtk_widget_get_style_context (priv->btn_top_panel),
                                   "image-button");
 
-  wall_clock_notify_cb (self, NULL, priv->wall_clock);
+  wall_clock_start (self);
+  g_signal_connect_object (phosh_display_state_get_default (),
+                           "notify::display-off",
+                           G_CALLBACK (on_display_off_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
+  on_display_off_changed (self, NULL, phosh_display_state_get_default ());
 
   /* language indicator */
   if (display) {
@@ -10,6 +10,7 @@
 
 #include "config.h"
 #include "phosh-wayland.h"
+#include "trace.h"
 
 #include <gdk/gdkwayland.h>
 
@@ -21,11 +22,16 @@
  * The #PhoshWayland singleton is responsible for listening to wayland
  * registry events registering the objects that show up there to make
  * them available to Phosh's other classes.
+ *
+ * Globals are bound asynchronously. Once the compositor announced
+ * all initial globals #PhoshWayland:ready becomes %TRUE. Use
+ * phosh_wayland_roundtrip() if you need to block until then.
  */
 
 enum {
   PHOSH_WAYLAND_PROP_0,
   PHOSH_WAYLAND_PROP_WL_OUTPUTS,
+  PHOSH_WAYLAND_PROP_READY,
   PHOSH_WAYLAND_PROP_LAST_PROP,
 };
 static GParamSpec *props[PHOSH_WAYLAND_PROP_LAST_PROP];
@@ -46,6 +52,10 @@ typedef struct {
   struct zxdg_output_manager_v1 *zxdg_output_manager_v1;
   struct wl_shm *wl_shm;
   GHashTable *wl_outputs;
+
+  struct wl_callback *initial_sync;
+  gint64 initial_sync_begin;
+  gboolean ready;
 } PhoshWaylandPrivate;
 
 
@@ -175,6 +185,50 @@ static const struct wl_registry_listener registry_listener = {
 };
 
 
+static void
+initial_sync_handle_done (void               *data,
+                          struct wl_callback *callback,
+                          uint32_t            serial)
+{
+  PhoshWayland *self = PHOSH_WAYLAND (data);
+  PhoshWaylandPrivate *priv = phosh_wayland_get_instance_private (self);
+  guint num_outputs;
+
+  g_clear_pointer (&priv->initial_sync, wl_callback_destroy);
+
+  /* All globals announced before our sync request are bound now */
+  num_outputs = g_hash_table_size(priv->wl_outputs);
+  if (!num_outputs || !priv->layer_shell || !priv->idle_manager ||
+      !priv->input_inhibit_manager || !priv->xdg_wm_base ||
+      !priv->zxdg_output_manager_v1) {
+    g_error ("Could not find needed globals\n"
+             "outputs: %d, layer_shell: %p, idle_manager: %p, "
+             "inhibit: %p, xdg_wm: %p, "
+             "xdg_output: %p, wlr_output_manager: %p, "
+             "wlr_foreign_toplevel_manager: %p"
+             "\n",
+             num_outputs, priv->layer_shell, priv->idle_manager,
+             priv->input_inhibit_manager, priv->xdg_wm_base,
+             priv->zxdg_output_manager_v1,
+             priv->zwlr_output_manager_v1,
+             priv->zwlr_foreign_toplevel_manager_v1);
+  }
+  if (!priv->phosh_private) {
+    g_info ("Could not find phosh private interface, disabling some features");
+  }
+
+  g_debug ("Wayland globals ready");
+  phosh_trace_mark ("wayland-globals", priv->initial_sync_begin, "%u outputs", num_outputs);
+  priv->ready = TRUE;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_WAYLAND_PROP_READY]);
+}
+
+
+static const struct wl_callback_listener initial_sync_listener = {
+  initial_sync_handle_done,
+};
+
+
 static void
 phosh_wayland_set_property (GObject *object,
                             guint property_id,
@@ -203,6 +257,9 @@ phosh_wayland_get_property (GObject *object,
   case PHOSH_WAYLAND_PROP_WL_OUTPUTS:
     g_value_set_boxed (value, priv->wl_outputs);
     break;
+  case PHOSH_WAYLAND_PROP_READY:
+    g_value_set_boolean (value, priv->ready);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -215,7 +272,6 @@ phosh_wayland_constructed (GObject *object)
 {
   PhoshWayland *self = PHOSH_WAYLAND (object);
   PhoshWaylandPrivate *priv = phosh_wayland_get_instance_private (self);
-  guint num_outputs;
   GdkDisplay *gdk_display;
 
   G_OBJECT_CLASS (phosh_wayland_parent_class)->constructed (object);
@@ -231,27 +287,12 @@ phosh_wayland_constructed (GObject *object)
   priv->registry = wl_display_get_registry (priv->display);
   wl_registry_add_listener (priv->registry, &registry_listener, self);
 
-  /* Wait until we have been notified about the wayland globals we require */
-  phosh_wayland_roundtrip (self);
-  num_outputs = g_hash_table_size(priv->wl_outputs);
-  if (!num_outputs || !priv->layer_shell || !priv->idle_manager ||
-      !priv->input_inhibit_manager || !priv->xdg_wm_base ||
-      !priv->zxdg_output_manager_v1) {
-    g_error ("Could not find needed globals\n"
-             "outputs: %d, layer_shell: %p, idle_manager: %p, "
-             "inhibit: %p, xdg_wm: %p, "
-             "xdg_output: %p, wlr_output_manager: %p, "
-             "wlr_foreign_toplevel_manager: %p"
-             "\n",
-             num_outputs, priv->layer_shell, priv->idle_manager,
-             priv->input_inhibit_manager, priv->xdg_wm_base,
-             priv->zxdg_output_manager_v1,
-             priv->zwlr_output_manager_v1,
-             priv->zwlr_foreign_toplevel_manager_v1);
-  }
-  if (!priv->phosh_private) {
-    g_info ("Could not find phosh private interface, disabling some features");
-  }
+  /* Don't block on the compositor, the sync's done event tells us
+   * when the initial globals got announced */
+  priv->initial_sync_begin = phosh_trace_now ();
+  priv->initial_sync = wl_display_sync (priv->display);
+  wl_callback_add_listener (priv->initial_sync, &initial_sync_listener, self);
+  wl_display_flush (priv->display);
 }
 
 
@@ -261,6 +302,7 @@ phosh_wayland_dispose (GObject *object)
   PhoshWayland *self = PHOSH_WAYLAND (object);
   PhoshWaylandPrivate *priv = phosh_wayland_get_instance_private (self);
 
+  g_clear_pointer (&priv->initial_sync, wl_callback_destroy);
   g_clear_pointer (&priv->wl_outputs, g_hash_table_destroy);
   G_OBJECT_CLASS (phosh_wayland_parent_class)->dispose (object);
 }
@@ -283,6 +325,18 @@ phosh_wayland_class_init (PhoshWaylandClass *klass)
                         "The currently known wayland outputs",
                         G_TYPE_HASH_TABLE,
                         G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshWayland:ready:
+   *
+   * Whether all globals initially announced by the compositor are
+   * bound.
+   */
+  props[PHOSH_WAYLAND_PROP_READY] =
+    g_param_spec_boolean ("ready",
+                          "Ready",
+                          "Whether the initial globals are bound",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
   g_object_class_install_properties (object_class, PHOSH_WAYLAND_PROP_LAST_PROP, props);
 }
 
@@ -442,6 +496,24 @@ phosh_wayland_has_wl_output (PhoshWayland *self, struct wl_output *wl_output)
 }
 
 
+/**
+ * phosh_wayland_is_ready:
+ * @self: The #PhoshWayland singleton
+ *
+ * Returns: %TRUE once all initially announced globals are bound.
+ */
+gboolean
+phosh_wayland_is_ready (PhoshWayland *self)
+{
+  PhoshWaylandPrivate *priv;
+
+  g_return_val_if_fail (PHOSH_IS_WAYLAND (self), FALSE);
+  priv = phosh_wayland_get_instance_private (self);
+
+  return priv->ready;
+}
+
+
 void
 phosh_wayland_roundtrip (PhoshWayland *self)
 {
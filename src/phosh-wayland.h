@@ -41,4 +41,5 @@ struct zwlr_layer_shell_v1           *phosh_wayland_get_zwlr_layer_shell_v1 (Pho
 struct zwlr_output_manager_v1        *phosh_wayland_get_zwlr_output_manager_v1 (PhoshWayland *self);
 struct zwlr_output_power_manager_v1 *phosh_wayland_get_zwlr_output_power_manager_v1 (PhoshWayland *self);
 struct zxdg_output_manager_v1        *phosh_wayland_get_zxdg_output_manager_v1 (PhoshWayland *self);
+gboolean                              phosh_wayland_is_ready (PhoshWayland *self);
 void                                  phosh_wayland_roundtrip (PhoshWayland *self);
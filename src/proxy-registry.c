@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-proxy-registry"
+
+#include "config.h"
+
+#include "proxy-registry.h"
+#include "trace.h"
+
+/**
+ * SECTION:proxy-registry
+ * @short_description: Shared D-Bus proxies for well known services
+ * @Title: PhoshProxyRegistry
+ *
+ * Creating a #GDBusProxy takes several D-Bus round trips (looking up
+ * the name owner, fetching properties). #PhoshProxyRegistry creates
+ * each proxy (identified by bus name, object path, interface, proxy
+ * type and flags) once and hands out references to it. Requests arriving while a
+ * proxy is being created are completed together.
+ *
+ * When the service's name owner vanishes the proxy is dropped from
+ * the registry so the next request gets a fresh one. Callers still
+ * holding a reference can keep using theirs since #GDBusProxy tracks
+ * name owner changes itself.
+ */
+
+enum {
+  PROP_0,
+  PROP_BUS_TYPE,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+struct _PhoshProxyRegistry {
+  GObject     parent;
+
+  GBusType    bus_type;
+  GHashTable *proxies;    /* key -> GDBusProxy */
+  GHashTable *pending;    /* key -> GPtrArray of GTasks */
+};
+G_DEFINE_TYPE (PhoshProxyRegistry, phosh_proxy_registry, G_TYPE_OBJECT)
+
+
+typedef struct {
+  PhoshProxyRegistry *self;
+  char               *key;
+  gint64              begin;
+} ProxyRequest;
+
+
+static void
+proxy_request_free (ProxyRequest *request)
+{
+  g_object_unref (request->self);
+  g_free (request->key);
+  g_free (request);
+}
+
+
+static char *
+make_key (GType           proxy_type,
+          GDBusProxyFlags flags,
+          const char     *name,
+          const char     *object_path,
+          const char     *interface_name)
+{
+  /* Callers cast the proxy to the type they asked for */
+  return g_strdup_printf ("%s:%s:%s:%s:%x", name, object_path, interface_name,
+                          g_type_name (proxy_type), flags);
+}
+
+
+static char *
+make_proxy_key (GDBusProxy *proxy)
+{
+  return make_key (G_OBJECT_TYPE (proxy),
+                   g_dbus_proxy_get_flags (proxy),
+                   g_dbus_proxy_get_name (proxy),
+                   g_dbus_proxy_get_object_path (proxy),
+                   g_dbus_proxy_get_interface_name (proxy));
+}
+
+
+static void
+on_name_owner_changed (PhoshProxyRegistry *self, GParamSpec *pspec, GDBusProxy *proxy)
+{
+  g_autofree char *owner = g_dbus_proxy_get_name_owner (proxy);
+  g_autofree char *key = NULL;
+
+  if (owner)
+    return;
+
+  key = make_proxy_key (proxy);
+  if (g_hash_table_lookup (self->proxies, key) != proxy)
+    return;
+
+  g_debug ("%s vanished, dropping proxy", key);
+  g_signal_handlers_disconnect_by_data (proxy, self);
+  g_hash_table_remove (self->proxies, key);
+}
+
+
+static void
+on_proxy_ready (GObject *source_object, GAsyncResult *res, ProxyRequest *request)
+{
+  PhoshProxyRegistry *self = request->self;
+  g_autoptr (GError) err = NULL;
+  g_autoptr (GDBusProxy) proxy = NULL;
+  g_autoptr (GPtrArray) tasks = NULL;
+
+  proxy = G_DBUS_PROXY (g_async_initable_new_finish (G_ASYNC_INITABLE (source_object), res, &err));
+
+  tasks = g_ptr_array_ref (g_hash_table_lookup (self->pending, request->key));
+  g_hash_table_remove (self->pending, request->key);
+
+  if (proxy) {
+    phosh_trace_mark ("dbus-proxy", request->begin, "%s", request->key);
+    g_hash_table_insert (self->proxies, g_strdup (request->key), g_object_ref (proxy));
+    g_signal_connect_object (proxy,
+                             "notify::g-name-owner",
+                             G_CALLBACK (on_name_owner_changed),
+                             self,
+                             G_CONNECT_SWAPPED);
+  } else {
+    g_debug ("Failed to create proxy for %s: %s", request->key, err->message);
+  }
+
+  for (guint i = 0; i < tasks->len; i++) {
+    GTask *task = g_ptr_array_index (tasks, i);
+
+    if (proxy)
+      g_task_return_pointer (task, g_object_ref (proxy), g_object_unref);
+    else
+      g_task_return_error (task, g_error_copy (err));
+  }
+
+  proxy_request_free (request);
+}
+
+
+static void
+phosh_proxy_registry_set_property (GObject      *object,
+                                   guint         property_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+  PhoshProxyRegistry *self = PHOSH_PROXY_REGISTRY (object);
+
+  switch (property_id) {
+  case PROP_BUS_TYPE:
+    self->bus_type = g_value_get_enum (value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_proxy_registry_get_property (GObject    *object,
+                                   guint       property_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+  PhoshProxyRegistry *self = PHOSH_PROXY_REGISTRY (object);
+
+  switch (property_id) {
+  case PROP_BUS_TYPE:
+    g_value_set_enum (value, self->bus_type);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_proxy_registry_dispose (GObject *object)
+{
+  PhoshProxyRegistry *self = PHOSH_PROXY_REGISTRY (object);
+  GHashTableIter iter;
+  GDBusProxy *proxy;
+
+  if (self->proxies) {
+    g_hash_table_iter_init (&iter, self->proxies);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &proxy))
+      g_signal_handlers_disconnect_by_data (proxy, self);
+  }
+  g_clear_pointer (&self->proxies, g_hash_table_destroy);
+
+  G_OBJECT_CLASS (phosh_proxy_registry_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_proxy_registry_finalize (GObject *object)
+{
+  PhoshProxyRegistry *self = PHOSH_PROXY_REGISTRY (object);
+
+  /* Pending requests hold a reference so there can't be any left */
+  g_hash_table_destroy (self->pending);
+
+  G_OBJECT_CLASS (phosh_proxy_registry_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_proxy_registry_class_init (PhoshProxyRegistryClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->set_property = phosh_proxy_registry_set_property;
+  object_class->get_property = phosh_proxy_registry_get_property;
+  object_class->dispose = phosh_proxy_registry_dispose;
+  object_class->finalize = phosh_proxy_registry_finalize;
+
+  /**
+   * PhoshProxyRegistry:bus-type:
+   *
+   * The bus the proxies are created on
+   */
+  props[PROP_BUS_TYPE] =
+    g_param_spec_enum ("bus-type",
+                       "Bus type",
+                       "The bus the proxies are created on",
+                       G_TYPE_BUS_TYPE,
+                       G_BUS_TYPE_SESSION,
+                       G_PARAM_READWRITE |
+                       G_PARAM_CONSTRUCT_ONLY |
+                       G_PARAM_STATIC_STRINGS);
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+}
+
+
+static void
+phosh_proxy_registry_init (PhoshProxyRegistry *self)
+{
+  self->proxies = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->pending = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         g_free,
+                                         (GDestroyNotify) g_ptr_array_unref);
+}
+
+
+PhoshProxyRegistry *
+phosh_proxy_registry_new (GBusType bus_type)
+{
+  return g_object_new (PHOSH_TYPE_PROXY_REGISTRY, "bus-type", bus_type, NULL);
+}
+
+/**
+ * phosh_proxy_registry_get_proxy:
+ * @self: The #PhoshProxyRegistry
+ * @proxy_type: The proxy's type, either %G_TYPE_DBUS_PROXY or a type
+ *   generated by gdbus-codegen
+ * @flags: Flags used when the proxy needs to be created
+ * @name: The bus name
+ * @object_path: The object path
+ * @interface_name: The D-Bus interface
+ * @cancellable: (nullable): A #GCancellable
+ * @callback: The callback to invoke when the proxy is available
+ * @user_data: The user data for @callback
+ *
+ * Gets the shared proxy for the given service. If there's none yet
+ * it gets created. Call phosh_proxy_registry_get_proxy_finish() from
+ * @callback to get the result.
+ */
+void
+phosh_proxy_registry_get_proxy (PhoshProxyRegistry  *self,
+                                GType                proxy_type,
+                                GDBusProxyFlags      flags,
+                                const char          *name,
+                                const char          *object_path,
+                                const char          *interface_name,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  g_autoptr (GTask) task = NULL;
+  g_autofree char *key = NULL;
+  ProxyRequest *request;
+  GDBusProxy *proxy;
+  GPtrArray *tasks;
+
+  g_return_if_fail (PHOSH_IS_PROXY_REGISTRY (self));
+  g_return_if_fail (g_type_is_a (proxy_type, G_TYPE_DBUS_PROXY));
+  g_return_if_fail (name && object_path && interface_name);
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (task, phosh_proxy_registry_get_proxy);
+
+  key = make_key (proxy_type, flags, name, object_path, interface_name);
+  proxy = g_hash_table_lookup (self->proxies, key);
+  if (proxy) {
+    g_task_return_pointer (task, g_object_ref (proxy), g_object_unref);
+    return;
+  }
+
+  tasks = g_hash_table_lookup (self->pending, key);
+  if (tasks) {
+    g_ptr_array_add (tasks, g_steal_pointer (&task));
+    return;
+  }
+
+  tasks = g_ptr_array_new_with_free_func (g_object_unref);
+  g_ptr_array_add (tasks, g_steal_pointer (&task));
+  g_hash_table_insert (self->pending, g_strdup (key), tasks);
+
+  request = g_new0 (ProxyRequest, 1);
+  request->self = g_object_ref (self);
+  request->key = g_steal_pointer (&key);
+  request->begin = phosh_trace_now ();
+
+  /* Not cancellable since other callers might be waiting as well */
+  g_async_initable_new_async (proxy_type,
+                              G_PRIORITY_DEFAULT,
+                              NULL,
+                              (GAsyncReadyCallback) on_proxy_ready,
+                              request,
+                              "g-flags", flags,
+                              "g-bus-type", self->bus_type,
+                              "g-name", name,
+                              "g-object-path", object_path,
+                              "g-interface-name", interface_name,
+                              NULL);
+}
+
+/**
+ * phosh_proxy_registry_get_proxy_finish:
+ * @self: The #PhoshProxyRegistry
+ * @result: The #GAsyncResult passed to the callback
+ * @error: The return location for a #GError
+ *
+ * Returns: (transfer full) (nullable): The proxy or %NULL on error
+ */
+GDBusProxy *
+phosh_proxy_registry_get_proxy_finish (PhoshProxyRegistry  *self,
+                                       GAsyncResult        *result,
+                                       GError             **error)
+{
+  g_return_val_if_fail (PHOSH_IS_PROXY_REGISTRY (self), NULL);
+  g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == phosh_proxy_registry_get_proxy, NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
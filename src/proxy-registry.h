@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_PROXY_REGISTRY (phosh_proxy_registry_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshProxyRegistry, phosh_proxy_registry, PHOSH, PROXY_REGISTRY, GObject)
+
+PhoshProxyRegistry *phosh_proxy_registry_new              (GBusType             bus_type);
+void                phosh_proxy_registry_get_proxy        (PhoshProxyRegistry  *self,
+                                                           GType                proxy_type,
+                                                           GDBusProxyFlags      flags,
+                                                           const char          *name,
+                                                           const char          *object_path,
+                                                           const char          *interface_name,
+                                                           GCancellable        *cancellable,
+                                                           GAsyncReadyCallback  callback,
+                                                           gpointer             user_data);
+GDBusProxy         *phosh_proxy_registry_get_proxy_finish (PhoshProxyRegistry  *self,
+                                                           GAsyncResult        *result,
+                                                           GError             **error);
+
+G_END_DECLS
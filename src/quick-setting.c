@@ -10,6 +10,8 @@
 
 #include "config.h"
 
+#include "proxy-registry.h"
+#include "shell.h"
 #include "status-icon.h"
 #include "quick-setting.h"
 
@@ -238,7 +240,7 @@ call_dbus_cb (GDBusProxy *proxy,
 }
 
 static void
-create_dbus_proxy_cb (GObject *source_object, GAsyncResult *res, char *panel)
+create_dbus_proxy_cb (PhoshProxyRegistry *registry, GAsyncResult *res, char *panel)
 {
   g_autoptr (GDBusProxy) proxy = NULL;
   g_autoptr (GError) err = NULL;
@@ -246,10 +248,11 @@ create_dbus_proxy_cb (GObject *source_object, GAsyncResult *res, char *panel)
   GVariant *params[3];
   GVariant *array[1];
 
-  proxy = g_dbus_proxy_new_for_bus_finish (res, &err);
+  proxy = phosh_proxy_registry_get_proxy_finish (registry, res, &err);
 
   if (err != NULL) {
     g_warning ("Can't open panel %s: %s", panel, err->message);
+    g_free (panel);
     return;
   }
 
@@ -278,14 +281,17 @@ create_dbus_proxy_cb (GObject *source_object, GAsyncResult *res, char *panel)
 void
 phosh_quick_setting_open_settings_panel (char *panel)
 {
-  g_dbus_proxy_new_for_bus (G_BUS_TYPE_SESSION,
-			    G_DBUS_PROXY_FLAGS_NONE,
-			    NULL,
-			    "org.gnome.ControlCenter",
-			    "/org/gnome/ControlCenter",
-			    "org.gtk.Actions",
-			    NULL,
-			    (GAsyncReadyCallback) create_dbus_proxy_cb,
-			    g_strdup (panel));
-
+  PhoshProxyRegistry *registry = phosh_shell_get_proxy_registry (phosh_shell_get_default ());
+
+  g_return_if_fail (PHOSH_IS_PROXY_REGISTRY (registry));
+
+  phosh_proxy_registry_get_proxy (registry,
+                                  G_TYPE_DBUS_PROXY,
+                                  G_DBUS_PROXY_FLAGS_NONE,
+                                  "org.gnome.ControlCenter",
+                                  "/org/gnome/ControlCenter",
+                                  "org.gtk.Actions",
+                                  NULL,
+                                  (GAsyncReadyCallback) create_dbus_proxy_cb,
+                                  g_strdup (panel));
 }
@@ -18,6 +18,7 @@
 #include "settings/gvc-channel-bar.h"
 #include "wwan/phosh-wwan-mm.h"
 #include "rotateinfo.h"
+#include "value-writer.h"
 #include "feedbackinfo.h"
 #include "feedback-manager.h"
 #include "notifications/notify-manager.h"
@@ -37,11 +38,18 @@
 #include <libfeedback.h>
 
 #define VOLUME_SCALE 5
+/* PulseAudio doesn't tell us when a volume change got applied so
+   assume it's done after a couple of frames */
+#define VOLUME_WRITE_TIMEOUT_MS 50
 
 /**
  * SECTION:settings
  * @short_description: The settings menu
  * @Title: PhoshSettings
+ *
+ * The volume mixer, the media player and the notification list
+ * widgets are only set up once the menu gets mapped for the first
+ * time (or a volume key gets pressed) since they're not needed before.
  */
 
 enum {
@@ -58,14 +66,19 @@ typedef struct _PhoshSettings
   GtkWidget *quick_settings;
   GtkWidget *scale_brightness;
   GtkWidget *output_vol_bar;
+  GtkWidget *media_player;
 
   /* Output volume control */
   GvcMixerControl *mixer_control;
   GvcMixerStream *output_stream;
   gboolean allow_volume_above_100_percent;
   gboolean setting_volume;
+  PhoshValueWriter *volume_writer;
+  /* Volume key presses before the mixer found the output stream */
+  int pending_volume_steps;
 
   /* Notifications */
+  gboolean   notifications_bound;
   GtkWidget *list_notifications;
   GtkWidget *sw_notifications;
   LfbEvent  *notify_event;
@@ -88,6 +101,15 @@ brightness_value_changed_cb (GtkScale *scale_brightness, gpointer *unused)
   brightness_set (brightness);
 }
 
+
+static gboolean
+on_brightness_button_released (PhoshSettings *self)
+{
+  brightness_flush ();
+
+  return GDK_EVENT_PROPAGATE;
+}
+
 static void
 rotation_setting_clicked_cb (PhoshSettings *self)
 {
@@ -149,12 +171,21 @@ battery_setting_clicked_cb (PhoshSettings *self)
   g_signal_emit (self, signals[SETTING_DONE], 0);
 }
 
+static void ensure_mixer (PhoshSettings *self);
+
 static void change_volume (PhoshSettings *self,
                            int steps)
 {
   GtkAdjustment *adj;
   double vol, inc;
 
+  ensure_mixer (self);
+  if (!self->output_stream) {
+    g_debug ("No output stream yet, queuing volume change");
+    self->pending_volume_steps += steps;
+    return;
+  }
+
   adj = GTK_ADJUSTMENT (gvc_channel_bar_get_adjustment (GVC_CHANNEL_BAR (self->output_vol_bar)));
 
   vol = gtk_adjustment_get_value (adj);
@@ -240,6 +271,10 @@ output_stream_notify_volume_cb (GvcMixerStream *stream, GParamSpec *pspec, gpoin
 {
   PhoshSettings *self = PHOSH_SETTINGS (data);
 
+  /* Don't let the echos of our own writes move the slider */
+  if (phosh_value_writer_is_busy (self->volume_writer))
+    return;
+
   if (!self->setting_volume)
     update_output_vol_bar (self);
 }
@@ -283,28 +318,54 @@ mixer_control_output_update_cb (GvcMixerControl *mixer, guint id, gpointer *data
                     G_CALLBACK (output_stream_notify_is_muted_cb),
                     self);
   update_output_vol_bar (self);
+
+  if (self->pending_volume_steps) {
+    int steps = self->pending_volume_steps;
+
+    self->pending_volume_steps = 0;
+    change_volume (self, steps);
+  }
 }
 
 
 static void
-vol_adjustment_value_changed_cb (GtkAdjustment *adjustment,
-                                 PhoshSettings *self)
+write_volume (PhoshValueWriter *writer, double volume, gpointer data)
 {
-  double volume, rounded;
-  g_autofree char *name = NULL;
+  PhoshSettings *self = PHOSH_SETTINGS (data);
+  double rounded;
 
-  if (!self->output_stream)
+  if (!self->output_stream && self->mixer_control)
     self->output_stream = gvc_mixer_control_get_default_sink (self->mixer_control);
 
-  volume = gtk_adjustment_get_value (adjustment);
   rounded = round (volume);
-
-  g_object_get (self->output_vol_bar, "name", &name, NULL);
-  g_debug ("Setting stream volume %lf (rounded: %lf) for bar '%s'", volume, rounded, name);
+  g_debug ("Setting stream volume %lf (rounded: %lf)", volume, rounded);
 
   g_return_if_fail (self->output_stream);
   if (gvc_mixer_stream_set_volume (self->output_stream, (pa_volume_t) rounded) != FALSE)
     gvc_mixer_stream_push_volume (self->output_stream);
+  else
+    phosh_value_writer_done (writer);
+}
+
+
+static void
+vol_adjustment_value_changed_cb (GtkAdjustment *adjustment,
+                                 PhoshSettings *self)
+{
+  /* Value came from the stream, nothing to write back */
+  if (self->setting_volume)
+    return;
+
+  phosh_value_writer_set (self->volume_writer, gtk_adjustment_get_value (adjustment));
+}
+
+
+static gboolean
+on_vol_bar_button_released (PhoshSettings *self)
+{
+  phosh_value_writer_flush (self->volume_writer);
+
+  return GDK_EVENT_PROPAGATE;
 }
 
 
@@ -383,6 +444,77 @@ on_notifcation_items_changed (PhoshSettings *self,
   }
 }
 
+static void
+ensure_mixer (PhoshSettings *self)
+{
+  if (self->mixer_control)
+    return;
+
+  self->mixer_control = gvc_mixer_control_new ("Phone Shell Volume Control");
+  g_return_if_fail (self->mixer_control);
+
+  gvc_mixer_control_open (self->mixer_control);
+  g_signal_connect (self->mixer_control,
+                    "active-output-update",
+                    G_CALLBACK (mixer_control_output_update_cb),
+                    self);
+}
+
+
+static void
+ensure_media_player (PhoshSettings *self)
+{
+  if (self->media_player)
+    return;
+
+  self->media_player = phosh_media_player_new ();
+  g_object_set (self->media_player,
+                "valign", GTK_ALIGN_CENTER,
+                "can-focus", FALSE,
+                NULL);
+  g_object_bind_property (self->media_player, "playable",
+                          self->media_player, "visible",
+                          G_BINDING_SYNC_CREATE);
+  g_signal_connect_swapped (self->media_player,
+                            "player-raised",
+                            G_CALLBACK (on_media_player_raised),
+                            self);
+  gtk_box_pack_start (GTK_BOX (self->box_settings), self->media_player, FALSE, TRUE, 0);
+}
+
+
+static void
+ensure_notifications_bound (PhoshSettings *self)
+{
+  PhoshNotifyManager *manager;
+
+  if (self->notifications_bound)
+    return;
+
+  manager = phosh_notify_manager_get_default ();
+  gtk_list_box_bind_model (GTK_LIST_BOX (self->list_notifications),
+                           G_LIST_MODEL (phosh_notify_manager_get_list (manager)),
+                           create_notification_row,
+                           NULL,
+                           NULL);
+  self->notifications_bound = TRUE;
+}
+
+
+static void
+phosh_settings_map (GtkWidget *widget)
+{
+  PhoshSettings *self = PHOSH_SETTINGS (widget);
+
+  /* Only needed once the menu is shown */
+  ensure_mixer (self);
+  ensure_media_player (self);
+  ensure_notifications_bound (self);
+
+  GTK_WIDGET_CLASS (phosh_settings_parent_class)->map (widget);
+}
+
+
 static void
 phosh_settings_constructed (GObject *object)
 {
@@ -398,36 +530,38 @@ phosh_settings_constructed (GObject *object)
                     "value-changed",
                     G_CALLBACK(brightness_value_changed_cb),
                     NULL);
+  g_signal_connect_object (self->scale_brightness,
+                           "button-release-event",
+                           G_CALLBACK (on_brightness_button_released),
+                           self,
+                           G_CONNECT_SWAPPED);
+
+  self->volume_writer = phosh_value_writer_new (write_volume, self, VOLUME_WRITE_TIMEOUT_MS);
 
   self->output_vol_bar = create_vol_channel_bar (self);
   gtk_box_pack_start (GTK_BOX (self->box_settings), self->output_vol_bar, FALSE, FALSE, 0);
   gtk_box_reorder_child (GTK_BOX (self->box_settings), self->output_vol_bar, 1);
 
-  self->mixer_control = gvc_mixer_control_new ("Phone Shell Volume Control");
-  g_return_if_fail (self->mixer_control);
-
-  gvc_mixer_control_open (self->mixer_control);
-  g_signal_connect (self->mixer_control,
-                    "active-output-update",
-                    G_CALLBACK (mixer_control_output_update_cb),
-                    self);
   adj = gvc_channel_bar_get_adjustment (GVC_CHANNEL_BAR (self->output_vol_bar));
   g_signal_connect (adj,
                     "value-changed",
                     G_CALLBACK (vol_adjustment_value_changed_cb),
                     self);
+  /* Events from the scale bubble up to the bar */
+  g_signal_connect_object (self->output_vol_bar,
+                           "button-release-event",
+                           G_CALLBACK (on_vol_bar_button_released),
+                           self,
+                           G_CONNECT_SWAPPED);
 
   g_signal_connect (self->quick_settings,
                     "child-activated",
                     G_CALLBACK (on_quicksetting_activated),
                     self);
 
+  /* Rows are only created once mapped but we need to track
+     notifications for feedback right away */
   manager = phosh_notify_manager_get_default ();
-  gtk_list_box_bind_model (GTK_LIST_BOX (self->list_notifications),
-                           G_LIST_MODEL (phosh_notify_manager_get_list (manager)),
-                           create_notification_row,
-                           NULL,
-                           NULL);
   g_signal_connect_swapped (phosh_notify_manager_get_list (manager),
                             "items-changed",
                             G_CALLBACK (on_notifcation_items_changed),
@@ -466,6 +600,7 @@ phosh_settings_finalize (GObject *object)
   PhoshSettings *self = PHOSH_SETTINGS (object);
 
   g_clear_object (&self->mixer_control);
+  g_clear_object (&self->volume_writer);
 
   G_OBJECT_CLASS (phosh_settings_parent_class)->finalize (object);
 }
@@ -482,6 +617,8 @@ phosh_settings_class_init (PhoshSettingsClass *klass)
   object_class->finalize = phosh_settings_finalize;
   object_class->constructed = phosh_settings_constructed;
 
+  widget_class->map = phosh_settings_map;
+
   gtk_widget_class_set_template_from_resource (widget_class,
                                                "/sm/puri/phosh/ui/settings-menu.ui");
 
@@ -493,7 +630,6 @@ phosh_settings_class_init (PhoshSettingsClass *klass)
   g_type_ensure (PHOSH_TYPE_QUICK_SETTING);
   g_type_ensure (PHOSH_TYPE_ROTATE_INFO);
   g_type_ensure (PHOSH_TYPE_FEEDBACK_INFO);
-  g_type_ensure (PHOSH_TYPE_MEDIA_PLAYER);
 
   gtk_widget_class_bind_template_child (widget_class, PhoshSettings, box_settings);
   gtk_widget_class_bind_template_child (widget_class, PhoshSettings, quick_settings);
@@ -508,7 +644,6 @@ phosh_settings_class_init (PhoshSettingsClass *klass)
   gtk_widget_class_bind_template_callback (widget_class, wifi_setting_clicked_cb);
   gtk_widget_class_bind_template_callback (widget_class, wwan_setting_clicked_cb);
   gtk_widget_class_bind_template_callback (widget_class, bt_setting_clicked_cb);
-  gtk_widget_class_bind_template_callback (widget_class, on_media_player_raised);
 }
 
 
@@ -12,10 +12,14 @@
 #include <gtk/gtk.h>
 
 #include "settings/brightness.h"
+#include "shell.h"
+#include "value-writer.h"
 
+#define BRIGHTNESS_CALL_TIMEOUT_MS 2000
 
 GDBusProxy *brightness_proxy;
 gboolean setting_brightness;
+static PhoshValueWriter *brightness_writer;
 
 
 static void
@@ -31,6 +35,10 @@ brightness_changed_cb (GDBusProxy *proxy,
   if (setting_brightness)
     return;
 
+  /* Don't let the echos of our own writes move the slider */
+  if (brightness_writer && phosh_value_writer_is_busy (brightness_writer))
+    return;
+
   ret = g_variant_lookup (changed_props,
                           "Brightness",
                           "i", &value);
@@ -42,15 +50,15 @@ brightness_changed_cb (GDBusProxy *proxy,
 
 
 static void
-brightness_init_cb (GObject      *source_object,
-                    GAsyncResult *res,
-                    GtkScale     *scale)
+brightness_init_cb (PhoshProxyRegistry *registry,
+                    GAsyncResult       *res,
+                    GtkScale           *scale)
 {
   g_autoptr(GError) err = NULL;
   GVariant *var;
   int value;
 
-  brightness_proxy = g_dbus_proxy_new_finish (res, &err);
+  brightness_proxy = phosh_proxy_registry_get_proxy_finish (registry, res, &err);
   if (!brightness_proxy || err) {
     g_warning ("Could not connect to brightness service %s", err->message);
     return;
@@ -78,29 +86,24 @@ brightness_init_cb (GObject      *source_object,
 void
 brightness_init (GtkScale *scale)
 {
-  g_autoptr(GError) err = NULL;
-  g_autoptr(GDBusConnection) session_con = NULL;
-
-  session_con = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, &err);
-  if (err != NULL) {
-    g_error ("Can not connect to session bus: %s", err->message);
-    return;
-  }
-
-  g_dbus_proxy_new (session_con,
-                    G_DBUS_PROXY_FLAGS_NONE,
-                    NULL,
-                    "org.gnome.SettingsDaemon.Power",
-                    "/org/gnome/SettingsDaemon/Power",
-                    "org.gnome.SettingsDaemon.Power.Screen",
-                    NULL,
-                    (GAsyncReadyCallback)brightness_init_cb,
-                    scale);
+  PhoshProxyRegistry *registry = phosh_shell_get_proxy_registry (phosh_shell_get_default ());
+
+  g_return_if_fail (PHOSH_IS_PROXY_REGISTRY (registry));
+
+  phosh_proxy_registry_get_proxy (registry,
+                                  G_TYPE_DBUS_PROXY,
+                                  G_DBUS_PROXY_FLAGS_NONE,
+                                  "org.gnome.SettingsDaemon.Power",
+                                  "/org/gnome/SettingsDaemon/Power",
+                                  "org.gnome.SettingsDaemon.Power.Screen",
+                                  NULL,
+                                  (GAsyncReadyCallback)brightness_init_cb,
+                                  scale);
 }
 
 
 static void
-brightness_set_cb (GDBusProxy *proxy, GAsyncResult *res, gpointer unused)
+brightness_set_cb (GDBusProxy *proxy, GAsyncResult *res, PhoshValueWriter *writer)
 {
   GError *err = NULL;
   GVariant *var;
@@ -110,26 +113,27 @@ brightness_set_cb (GDBusProxy *proxy, GAsyncResult *res, gpointer unused)
   if (err) {
     g_warning ("Could not set brightness %s", err->message);
     g_error_free (err);
-    return;
   }
 
   if (var)
     g_variant_unref (var);
 
-  setting_brightness = FALSE;
+  phosh_value_writer_done (writer);
+  g_object_unref (writer);
 }
 
 
-void
-brightness_set (int brightness)
+static void
+write_brightness (PhoshValueWriter *writer, double value, gpointer unused)
 {
-  if (!brightness_proxy)
-    return;
+  int brightness = (int) value;
 
-  if (setting_brightness)
+  /* Might run after brightness_dispose () when a reply comes in late */
+  if (!brightness_proxy) {
+    phosh_value_writer_done (writer);
     return;
+  }
 
-  setting_brightness = TRUE;
   g_dbus_proxy_call (brightness_proxy,
                      "org.freedesktop.DBus.Properties.Set",
                      g_variant_new (
@@ -138,15 +142,44 @@ brightness_set (int brightness)
                          "Brightness",
                          g_variant_new ("i", brightness)),
                      G_DBUS_CALL_FLAGS_NONE,
-                     2000,
+                     BRIGHTNESS_CALL_TIMEOUT_MS,
                      NULL,
                      (GAsyncReadyCallback)brightness_set_cb,
-                     NULL);
+                     g_object_ref (writer));
+}
+
+
+void
+brightness_set (int brightness)
+{
+  if (!brightness_proxy)
+    return;
+
+  if (!brightness_writer) {
+    /* The D-Bus call times out on its own */
+    brightness_writer = phosh_value_writer_new (write_brightness, NULL, 0);
+  }
+
+  phosh_value_writer_set (brightness_writer, brightness);
+}
+
+
+void
+brightness_flush (void)
+{
+  if (brightness_writer)
+    phosh_value_writer_flush (brightness_writer);
 }
 
 
 void
 brightness_dispose (void)
 {
+  /* The proxy is shared so drop our handler */
+  if (brightness_proxy) {
+    g_signal_handlers_disconnect_matched (brightness_proxy, G_SIGNAL_MATCH_FUNC,
+                                          0, 0, NULL, brightness_changed_cb, NULL);
+  }
   g_clear_pointer (&brightness_proxy, g_object_unref);
+  g_clear_object (&brightness_writer);
 }
@@ -9,3 +9,4 @@
 void brightness_init (GtkScale *scale);
 void brightness_dispose (void);
 void brightness_set (int brightness);
+void brightness_flush (void);
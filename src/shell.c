@@ -29,6 +29,7 @@
 #include "batteryinfo.h"
 #include "background-manager.h"
 #include "bt-manager.h"
+#include "display-state.h"
 #include "fader.h"
 #include "feedback-manager.h"
 #include "home.h"
@@ -47,6 +48,7 @@
 #include "screen-saver-manager.h"
 #include "session.h"
 #include "system-prompter.h"
+#include "trace.h"
 #include "util.h"
 #include "wifiinfo.h"
 #include "wwaninfo.h"
@@ -70,6 +72,7 @@ enum {
   PHOSH_SHELL_PROP_ROTATION,
   PHOSH_SHELL_PROP_LOCKED,
   PHOSH_SHELL_PROP_PRIMARY_MONITOR,
+  PHOSH_SHELL_PROP_STARTUP_FINISHED,
   PHOSH_SHELL_PROP_LAST_PROP
 };
 static GParamSpec *props[PHOSH_SHELL_PROP_LAST_PROP];
@@ -82,6 +85,7 @@ typedef struct
 
   GtkWidget *notification_banner;
 
+  PhoshProxyRegistry *proxy_registry;
   PhoshBackgroundManager *background_manager;
   PhoshMonitor *primary_monitor;
   PhoshMonitor *builtin_monitor;
@@ -104,6 +108,12 @@ typedef struct
 
   gboolean startup_finished;
   int rot; /* current rotation of primary monitor */
+
+  guint deferred_services_id;
+
+  gboolean lock_pending;     /* locked before the lockscreen manager exists */
+  gint64 startup_time;       /* monotonic time the shell got created */
+  gboolean first_mapped;     /* the first surface got mapped */
 } PhoshShellPrivate;
 
 
@@ -150,6 +160,9 @@ phosh_shell_get_locked (PhoshShell *self)
 {
   PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
 
+  if (priv->lockscreen_manager == NULL)
+    return priv->lock_pending;
+
   return phosh_lockscreen_manager_get_locked (priv->lockscreen_manager);
 }
 
@@ -168,12 +181,16 @@ phosh_shell_set_locked (PhoshShell *self, gboolean state)
   PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
   gboolean current;
 
-  current = phosh_lockscreen_manager_get_locked (priv->lockscreen_manager);
+  current = phosh_shell_get_locked (self);
 
   if (current == state)
     return;
 
-  phosh_lockscreen_manager_set_locked (priv->lockscreen_manager, state);
+  /* Wayland globals not bound yet, lock as soon as they are */
+  if (priv->lockscreen_manager == NULL)
+    priv->lock_pending = state;
+  else
+    phosh_lockscreen_manager_set_locked (priv->lockscreen_manager, state);
   g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_SHELL_PROP_LOCKED]);
 }
 
@@ -196,6 +213,21 @@ on_home_state_changed (PhoshShell *self, GParamSpec *pspec, PhoshHome *home)
 }
 
 
+static void
+on_panel_configured (PhoshShell *self, PhoshLayerSurface *panel)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+
+  g_signal_handlers_disconnect_by_func (panel, on_panel_configured, self);
+
+  if (priv->first_mapped)
+    return;
+
+  priv->first_mapped = TRUE;
+  phosh_trace_mark ("first-map", priv->startup_time, "panel configured");
+}
+
+
 static void
 panels_create (PhoshShell *self)
 {
@@ -220,6 +252,13 @@ panels_create (PhoshShell *self)
     G_CALLBACK(settings_activated_cb),
     self);
 
+  if (!priv->first_mapped) {
+    g_signal_connect_swapped (priv->panel,
+                              "configured",
+                              G_CALLBACK (on_panel_configured),
+                              self);
+  }
+
   g_signal_connect_swapped (
     priv->home,
     "notify::state",
@@ -306,12 +345,14 @@ phosh_shell_get_property (GObject *object,
     g_value_set_uint (value, phosh_monitor_get_rotation(priv->primary_monitor));
     break;
   case PHOSH_SHELL_PROP_LOCKED:
-    g_value_set_boolean (value,
-                         phosh_lockscreen_manager_get_locked (priv->lockscreen_manager));
+    g_value_set_boolean (value, phosh_shell_get_locked (self));
     break;
   case PHOSH_SHELL_PROP_PRIMARY_MONITOR:
     g_value_set_object (value, phosh_shell_get_primary_monitor (self));
     break;
+  case PHOSH_SHELL_PROP_STARTUP_FINISHED:
+    g_value_set_boolean (value, priv->startup_finished);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     break;
@@ -332,6 +373,8 @@ phosh_shell_dispose (GObject *object)
       g_clear_object (&priv->sensor_proxy_manager);
   }
 
+  g_clear_handle_id (&priv->deferred_services_id, g_source_remove);
+
   panels_dispose (self);
   g_clear_pointer (&priv->faders, g_ptr_array_unref);
 
@@ -353,6 +396,7 @@ phosh_shell_dispose (GObject *object)
   g_clear_object (&priv->builtin_monitor);
   g_clear_object (&priv->primary_monitor);
   g_clear_object (&priv->background_manager);
+  g_clear_object (&priv->proxy_registry);
 
   /* sensors */
   g_clear_object (&priv->proximity);
@@ -437,14 +481,45 @@ on_fade_out_timeout (PhoshShell *self)
 }
 
 
+/*
+ * setup_deferred_services_cb:
+ *
+ * Services that need to be registered with other daemons before they
+ * get invoked via DBus but are rarely used. Bring them up once
+ * startup finished and the main loop is otherwise idle.
+ */
+static gboolean
+setup_deferred_services_cb (PhoshShell *self)
+{
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+  gint64 begin;
+
+  priv->deferred_services_id = 0;
+
+  begin = phosh_trace_now ();
+  phosh_system_prompter_register ();
+  phosh_trace_mark ("system-prompter", begin, NULL);
+
+  begin = phosh_trace_now ();
+  priv->polkit_auth_agent = phosh_polkit_auth_agent_new ();
+  phosh_trace_mark ("polkit-auth-agent", begin, NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
+
 static gboolean
 setup_idle_cb (PhoshShell *self)
 {
   PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+  gint64 begin, idle_begin = phosh_trace_now ();
+
+  /* Panels and lock screen are up, bring up the rest */
 
-  panels_create (self);
   /* Create background after panel since it needs the panel's size */
+  begin = phosh_trace_now ();
   priv->background_manager = phosh_background_manager_new ();
+  phosh_trace_mark ("background-manager", begin, NULL);
 
   g_signal_connect_object (priv->toplevel_manager,
                            "notify::num-toplevels",
@@ -460,30 +535,48 @@ setup_idle_cb (PhoshShell *self)
                            G_CONNECT_SWAPPED);
 
   /* Screen saver manager needs lock screen manager */
+  begin = phosh_trace_now ();
   priv->screen_saver_manager = phosh_screen_saver_manager_get_default (
     priv->lockscreen_manager);
+  phosh_trace_mark ("screen-saver-manager", begin, NULL);
 
+  begin = phosh_trace_now ();
   priv->notify_manager = phosh_notify_manager_get_default ();
   g_signal_connect_object (priv->notify_manager,
                            "new-notification",
                            G_CALLBACK (on_new_notification),
                            self,
                            G_CONNECT_SWAPPED);
+  phosh_notify_manager_enable_journal (priv->notify_manager, NULL);
+  phosh_trace_mark ("notify-manager", begin, NULL);
 
+  begin = phosh_trace_now ();
   priv->sensor_proxy_manager = phosh_sensor_proxy_manager_get_default_failable ();
   if (priv->sensor_proxy_manager) {
     priv->proximity = phosh_proximity_new (priv->sensor_proxy_manager,
                                            priv->lockscreen_manager);
     /* TODO: accelerometer */
   }
+  phosh_trace_mark ("sensors", begin, NULL);
 
+  begin = phosh_trace_now ();
   phosh_session_register (PHOSH_APP_ID);
+  phosh_trace_mark ("session-register", begin, NULL);
 
   /* If we start rotated, fix this up */
   if (phosh_shell_get_rotation (self))
     phosh_shell_rotate_display (self, 0);
 
+  phosh_trace_mark ("setup-idle", idle_begin, NULL);
+  phosh_trace_mark ("startup", priv->startup_time, "finished");
   priv->startup_finished = TRUE;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_SHELL_PROP_STARTUP_FINISHED]);
+
+  priv->deferred_services_id = g_idle_add_full (G_PRIORITY_LOW,
+                                                (GSourceFunc) setup_deferred_services_cb,
+                                                self,
+                                                NULL);
+  g_source_set_name_by_id (priv->deferred_services_id, "[phosh] deferred services");
 
   return FALSE;
 }
@@ -510,6 +603,9 @@ on_builtin_monitor_power_mode_changed (PhoshShell *self, GParamSpec *pspec, Phos
   g_object_get (monitor, "power-mode", &mode, NULL);
   if (mode == PHOSH_MONITOR_POWER_SAVE_MODE_OFF)
     phosh_shell_lock (self);
+
+  phosh_display_state_set_display_off (phosh_display_state_get_default (),
+                                       mode == PHOSH_MONITOR_POWER_SAVE_MODE_OFF);
 }
 
 
@@ -534,20 +630,30 @@ on_primary_monitor_configured (PhoshShell   *self,
 }
 
 
+/*
+ * on_wayland_ready:
+ *
+ * All subsystems needing wayland globals start here. The panels
+ * and (if requested) the lock screen get mapped first, everything
+ * else is deferred to the idle handler.
+ */
 static void
-phosh_shell_constructed (GObject *object)
+on_wayland_ready (PhoshShell *self, GParamSpec *pspec, PhoshWayland *wl)
 {
-  PhoshShell *self = PHOSH_SHELL (object);
   PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+  gint64 begin;
 
-  G_OBJECT_CLASS (phosh_shell_parent_class)->constructed (object);
+  if (!phosh_wayland_is_ready (wl) || priv->monitor_manager)
+    return;
 
-  priv->rot = -1; /* force initial update */
+  g_signal_handlers_disconnect_by_func (wl, on_wayland_ready, self);
+
+  begin = phosh_trace_now ();
   priv->monitor_manager = phosh_monitor_manager_new ();
   if (phosh_monitor_manager_get_num_monitors(priv->monitor_manager)) {
     PhoshMonitor *monitor = phosh_monitor_manager_get_monitor (priv->monitor_manager, 0);
-    /* Can't invoke phosh_shell_set_primary_monitor () since the shell
-       object does not really exit yet but we need the primary monitor
+    /* Can't invoke phosh_shell_set_primary_monitor () since the
+       panels don't exist yet but we need the primary monitor
        early for the panels */
     priv->primary_monitor = g_object_ref (monitor);
     g_signal_connect_swapped (priv->primary_monitor,
@@ -560,23 +666,19 @@ phosh_shell_constructed (GObject *object)
     priv->builtin_monitor = priv->primary_monitor;
   else
     priv->builtin_monitor = phosh_shell_get_builtin_monitor(self);
+  phosh_trace_mark ("monitor-manager", begin, NULL);
 
-  gtk_icon_theme_add_resource_path (gtk_icon_theme_get_default (),
-                                    "/sm/puri/phosh/icons");
-  env_setup ();
-  css_setup (self);
-  type_setup ();
-
+  begin = phosh_trace_now ();
   priv->lockscreen_manager = phosh_lockscreen_manager_new ();
+  phosh_trace_mark ("lockscreen-manager", begin, NULL);
+
+  begin = phosh_trace_now ();
   priv->idle_manager = phosh_idle_manager_get_default();
+  phosh_trace_mark ("idle-manager", begin, NULL);
 
+  begin = phosh_trace_now ();
   priv->toplevel_manager = phosh_toplevel_manager_new ();
-  priv->faders = g_ptr_array_new_with_free_func ((GDestroyNotify) (gtk_widget_destroy));
-
-  phosh_system_prompter_register ();
-  priv->polkit_auth_agent = phosh_polkit_auth_agent_new ();
-
-  priv->feedback_manager = phosh_feedback_manager_new ();
+  phosh_trace_mark ("toplevel-manager", begin, NULL);
 
   if (priv->builtin_monitor) {
     g_signal_connect_swapped (
@@ -586,10 +688,55 @@ phosh_shell_constructed (GObject *object)
       self);
   }
 
+  begin = phosh_trace_now ();
+  panels_create (self);
+  phosh_trace_mark ("panels", begin, NULL);
+
+  if (priv->lock_pending) {
+    priv->lock_pending = FALSE;
+    begin = phosh_trace_now ();
+    phosh_lockscreen_manager_set_locked (priv->lockscreen_manager, TRUE);
+    phosh_trace_mark ("lockscreen", begin, "initial lock");
+  }
+
   g_idle_add ((GSourceFunc) setup_idle_cb, self);
 }
 
 
+static void
+phosh_shell_constructed (GObject *object)
+{
+  PhoshShell *self = PHOSH_SHELL (object);
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
+  PhoshWayland *wl = phosh_wayland_get_default ();
+  gint64 begin = phosh_trace_now ();
+
+  G_OBJECT_CLASS (phosh_shell_parent_class)->constructed (object);
+
+  priv->rot = -1; /* force initial update */
+
+  gtk_icon_theme_add_resource_path (gtk_icon_theme_get_default (),
+                                    "/sm/puri/phosh/icons");
+  env_setup ();
+  css_setup (self);
+  type_setup ();
+  phosh_trace_mark ("shell-setup", begin, "icons, css, types");
+
+  priv->faders = g_ptr_array_new_with_free_func ((GDestroyNotify) (gtk_widget_destroy));
+
+  /* Everything else needs wayland globals which get bound asynchronously */
+  if (phosh_wayland_is_ready (wl)) {
+    on_wayland_ready (self, NULL, wl);
+  } else {
+    g_signal_connect_object (wl,
+                             "notify::ready",
+                             G_CALLBACK (on_wayland_ready),
+                             self,
+                             G_CONNECT_SWAPPED);
+  }
+}
+
+
 static void
 phosh_shell_class_init (PhoshShellClass *klass)
 {
@@ -624,6 +771,13 @@ phosh_shell_class_init (PhoshShellClass *klass)
                          PHOSH_TYPE_MONITOR,
                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  props[PHOSH_SHELL_PROP_STARTUP_FINISHED] =
+    g_param_spec_boolean ("startup-finished",
+                          "Startup finished",
+                          "Whether the shell finished startup",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, PHOSH_SHELL_PROP_LAST_PROP, props);
 }
 
@@ -631,8 +785,12 @@ phosh_shell_class_init (PhoshShellClass *klass)
 static void
 phosh_shell_init (PhoshShell *self)
 {
+  PhoshShellPrivate *priv = phosh_shell_get_instance_private (self);
   GtkSettings *gtk_settings;
 
+  priv->startup_time = phosh_trace_now ();
+  priv->proxy_registry = phosh_proxy_registry_new (G_BUS_TYPE_SESSION);
+
   gtk_settings = gtk_settings_get_default ();
   g_object_set (G_OBJECT (gtk_settings), "gtk-application-prefer-dark-theme", TRUE, NULL);
 }
@@ -751,6 +909,10 @@ phosh_shell_get_primary_monitor (PhoshShell *self)
   if (priv->primary_monitor)
     return priv->primary_monitor;
 
+  /* Wayland globals not bound yet */
+  if (priv->monitor_manager == NULL)
+    return NULL;
+
   /* When the shell started up we might not have had all monitors */
   monitor = phosh_monitor_manager_get_monitor (priv->monitor_manager, 0);
   g_return_val_if_fail (monitor, NULL);
@@ -853,8 +1015,11 @@ phosh_shell_get_feedback_manager (PhoshShell *self)
 
   g_return_val_if_fail (PHOSH_IS_SHELL (self), NULL);
   priv = phosh_shell_get_instance_private (self);
-  g_return_val_if_fail (PHOSH_IS_FEEDBACK_MANAGER (priv->feedback_manager), NULL);
 
+  if (!priv->feedback_manager)
+    priv->feedback_manager = phosh_feedback_manager_new ();
+
+  g_return_val_if_fail (PHOSH_IS_FEEDBACK_MANAGER (priv->feedback_manager), NULL);
   return priv->feedback_manager;
 }
 
@@ -886,6 +1051,23 @@ phosh_shell_get_wwan (PhoshShell *self)
   return priv->wwan;
 }
 
+/**
+ * phosh_shell_get_proxy_registry:
+ * @self: The shell
+ *
+ * Returns: (transfer none): The registry of shared session bus proxies
+ */
+PhoshProxyRegistry *
+phosh_shell_get_proxy_registry (PhoshShell *self)
+{
+  PhoshShellPrivate *priv;
+
+  g_return_val_if_fail (PHOSH_IS_SHELL (self), NULL);
+  priv = phosh_shell_get_instance_private (self);
+
+  return priv->proxy_registry;
+}
+
 
 /**
  * Returns the usable area in pixels usable by a client on the phone
@@ -13,6 +13,7 @@
 #include "monitor/monitor.h"
 #include "lockscreen-manager.h"
 #include "osk-manager.h"
+#include "proxy-registry.h"
 #include "toplevel-manager.h"
 #include "wifimanager.h"
 #include "bt-manager.h"
@@ -52,6 +53,7 @@ PhoshWifiManager    *phosh_shell_get_wifi_manager    (PhoshShell *self);
 PhoshFeedbackManager *phosh_shell_get_feedback_manager (PhoshShell *self);
 PhoshBtManager      *phosh_shell_get_bt_manager      (PhoshShell *self);
 PhoshWWan           *phosh_shell_get_wwan        (PhoshShell *self);
+PhoshProxyRegistry  *phosh_shell_get_proxy_registry (PhoshShell *self);
 void                 phosh_shell_fade_out (PhoshShell *self, guint timeout);
 void                 phosh_shell_enable_power_save (PhoshShell *self, gboolean enable);
 gboolean             phosh_shell_started_by_display_manager(PhoshShell *self);
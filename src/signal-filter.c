@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-signal-filter"
+
+#include "config.h"
+
+#include "phosh-enums.h"
+#include "signal-filter.h"
+
+/**
+ * SECTION:signal-filter
+ * @short_description: Turns signal strengths into stable icon buckets
+ * @Title: PhoshSignalFilter
+ *
+ * Signal strengths reported by NetworkManager or the modem jitter
+ * around the bucket boundaries in weak signal areas. Mapping them
+ * to icons directly makes the indicators redraw constantly.
+ *
+ * #PhoshSignalFilter maps the strength (in percent) to a
+ * #PhoshSignalLevel with a hysteresis around each bucket boundary:
+ * the strength has to move past a boundary by a margin before the
+ * level changes. Level changes are also rate limited to at most one
+ * per minimum interval. If a change gets held back, the latest
+ * strength is applied once the interval is over.
+ */
+
+/* Lower bounds (exclusive) of the buckets above PHOSH_SIGNAL_LEVEL_NONE */
+static const guint thresholds[] = { 5, 30, 55, 80 };
+#define HYSTERESIS 5
+
+enum {
+  PROP_0,
+  PROP_MIN_INTERVAL,
+  PROP_LEVEL,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+struct _PhoshSignalFilter {
+  GObject          parent;
+
+  guint            min_interval;
+  guint            strength;
+  PhoshSignalLevel level;
+  gboolean         has_level;
+  gint64           last_change;
+  guint            timeout_id;
+};
+G_DEFINE_TYPE (PhoshSignalFilter, phosh_signal_filter, G_TYPE_OBJECT)
+
+
+static PhoshSignalLevel
+level_for_strength (guint strength, int offset)
+{
+  PhoshSignalLevel level = PHOSH_SIGNAL_LEVEL_NONE;
+
+  for (guint i = 0; i < G_N_ELEMENTS (thresholds); i++) {
+    if ((int)strength > (int)thresholds[i] + offset)
+      level++;
+  }
+
+  return level;
+}
+
+
+static void
+set_level (PhoshSignalFilter *self, PhoshSignalLevel level)
+{
+  self->has_level = TRUE;
+  self->last_change = g_get_monotonic_time ();
+
+  if (self->level == level)
+    return;
+
+  g_debug ("Signal level %d -> %d (strength %u)", self->level, level, self->strength);
+  self->level = level;
+  g_object_notify_by_pspec (G_OBJECT (self), props[PROP_LEVEL]);
+}
+
+
+static gboolean on_timeout (PhoshSignalFilter *self);
+
+static void
+evaluate (PhoshSignalFilter *self)
+{
+  PhoshSignalLevel target = self->level;
+  PhoshSignalLevel up, down;
+  gint64 elapsed, interval;
+
+  if (!self->has_level) {
+    set_level (self, level_for_strength (self->strength, 0));
+    return;
+  }
+
+  up = level_for_strength (self->strength, HYSTERESIS);
+  down = level_for_strength (self->strength, -HYSTERESIS);
+  if (up > self->level)
+    target = up;
+  else if (down < self->level)
+    target = down;
+
+  if (target == self->level) {
+    /* Back within the current bucket, drop any held back change */
+    g_clear_handle_id (&self->timeout_id, g_source_remove);
+    return;
+  }
+
+  interval = (gint64) self->min_interval * 1000;
+  elapsed = g_get_monotonic_time () - self->last_change;
+  if (elapsed < interval) {
+    if (self->timeout_id == 0) {
+      self->timeout_id = g_timeout_add ((interval - elapsed) / 1000 + 1,
+                                        (GSourceFunc) on_timeout,
+                                        self);
+      g_source_set_name_by_id (self->timeout_id, "[phosh] signal filter");
+    }
+    return;
+  }
+
+  g_clear_handle_id (&self->timeout_id, g_source_remove);
+  set_level (self, target);
+}
+
+
+static gboolean
+on_timeout (PhoshSignalFilter *self)
+{
+  self->timeout_id = 0;
+  evaluate (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+phosh_signal_filter_set_property (GObject      *object,
+                                  guint         property_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  PhoshSignalFilter *self = PHOSH_SIGNAL_FILTER (object);
+
+  switch (property_id) {
+  case PROP_MIN_INTERVAL:
+    self->min_interval = g_value_get_uint (value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_signal_filter_get_property (GObject    *object,
+                                  guint       property_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  PhoshSignalFilter *self = PHOSH_SIGNAL_FILTER (object);
+
+  switch (property_id) {
+  case PROP_MIN_INTERVAL:
+    g_value_set_uint (value, self->min_interval);
+    break;
+  case PROP_LEVEL:
+    g_value_set_enum (value, self->level);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_signal_filter_dispose (GObject *object)
+{
+  PhoshSignalFilter *self = PHOSH_SIGNAL_FILTER (object);
+
+  g_clear_handle_id (&self->timeout_id, g_source_remove);
+
+  G_OBJECT_CLASS (phosh_signal_filter_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_signal_filter_class_init (PhoshSignalFilterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->set_property = phosh_signal_filter_set_property;
+  object_class->get_property = phosh_signal_filter_get_property;
+  object_class->dispose = phosh_signal_filter_dispose;
+
+  /**
+   * PhoshSignalFilter:min-interval:
+   *
+   * The minimum time in milliseconds between two level changes
+   */
+  props[PROP_MIN_INTERVAL] =
+    g_param_spec_uint ("min-interval",
+                       "Minimum interval",
+                       "Minimum time between level changes in ms",
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READWRITE |
+                       G_PARAM_CONSTRUCT_ONLY |
+                       G_PARAM_STATIC_STRINGS);
+  /**
+   * PhoshSignalFilter:level:
+   *
+   * The filtered signal level
+   */
+  props[PROP_LEVEL] =
+    g_param_spec_enum ("level",
+                       "Level",
+                       "The filtered signal level",
+                       PHOSH_TYPE_SIGNAL_LEVEL,
+                       PHOSH_SIGNAL_LEVEL_NONE,
+                       G_PARAM_READABLE |
+                       G_PARAM_STATIC_STRINGS |
+                       G_PARAM_EXPLICIT_NOTIFY);
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+}
+
+
+static void
+phosh_signal_filter_init (PhoshSignalFilter *self)
+{
+}
+
+
+PhoshSignalFilter *
+phosh_signal_filter_new (guint min_interval_ms)
+{
+  return g_object_new (PHOSH_TYPE_SIGNAL_FILTER, "min-interval", min_interval_ms, NULL);
+}
+
+/**
+ * phosh_signal_filter_update:
+ * @self: The #PhoshSignalFilter
+ * @strength: The new signal strength in percent
+ *
+ * Feed a new strength into the filter. #PhoshSignalFilter:level is
+ * notified when the displayed bucket changes.
+ */
+void
+phosh_signal_filter_update (PhoshSignalFilter *self, guint strength)
+{
+  g_return_if_fail (PHOSH_IS_SIGNAL_FILTER (self));
+
+  self->strength = MIN (strength, 100);
+  evaluate (self);
+}
+
+/**
+ * phosh_signal_filter_reset:
+ * @self: The #PhoshSignalFilter
+ *
+ * Forget the filter's history, e.g. when connecting to a different
+ * access point. The next update is applied without hysteresis and
+ * rate limiting.
+ */
+void
+phosh_signal_filter_reset (PhoshSignalFilter *self)
+{
+  g_return_if_fail (PHOSH_IS_SIGNAL_FILTER (self));
+
+  g_clear_handle_id (&self->timeout_id, g_source_remove);
+  self->has_level = FALSE;
+}
+
+
+PhoshSignalLevel
+phosh_signal_filter_get_level (PhoshSignalFilter *self)
+{
+  g_return_val_if_fail (PHOSH_IS_SIGNAL_FILTER (self), PHOSH_SIGNAL_LEVEL_NONE);
+
+  return self->level;
+}
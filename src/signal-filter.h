@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * PhoshSignalLevel:
+ * @PHOSH_SIGNAL_LEVEL_NONE: No usable signal
+ * @PHOSH_SIGNAL_LEVEL_WEAK: Weak signal
+ * @PHOSH_SIGNAL_LEVEL_OK: Ok signal
+ * @PHOSH_SIGNAL_LEVEL_GOOD: Good signal
+ * @PHOSH_SIGNAL_LEVEL_EXCELLENT: Excellent signal
+ *
+ * The signal strength buckets the status icons can display.
+ */
+typedef enum {
+  PHOSH_SIGNAL_LEVEL_NONE,
+  PHOSH_SIGNAL_LEVEL_WEAK,
+  PHOSH_SIGNAL_LEVEL_OK,
+  PHOSH_SIGNAL_LEVEL_GOOD,
+  PHOSH_SIGNAL_LEVEL_EXCELLENT,
+} PhoshSignalLevel;
+
+#define PHOSH_TYPE_SIGNAL_FILTER (phosh_signal_filter_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshSignalFilter, phosh_signal_filter, PHOSH, SIGNAL_FILTER, GObject)
+
+PhoshSignalFilter *phosh_signal_filter_new       (guint              min_interval_ms);
+void               phosh_signal_filter_update    (PhoshSignalFilter *self,
+                                                  guint              strength);
+void               phosh_signal_filter_reset     (PhoshSignalFilter *self);
+PhoshSignalLevel   phosh_signal_filter_get_level (PhoshSignalFilter *self);
+
+G_END_DECLS
@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-stall-watchdog"
+
+#include "config.h"
+
+#include "stall-watchdog.h"
+#include "trace.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+
+#ifdef HAVE_EXECINFO_H
+# include <execinfo.h>
+# include <stdlib.h>
+#endif
+
+/**
+ * SECTION:stall-watchdog
+ * @short_description: Detects and records main loop stalls
+ * @Title: PhoshStallWatchdog
+ *
+ * A #PhoshStallWatchdog heartbeats the default main context from a
+ * high priority timeout. A separate thread checks the heartbeat and
+ * when it's late by more than the threshold the main thread gets
+ * interrupted by a signal to capture the name of the #GSource being
+ * dispatched (see g_source_set_name()) and a backtrace. The last
+ * %PHOSH_STALL_WATCHDOG_MAX_RECORDS stalls are kept in a ring buffer,
+ * see phosh_stall_watchdog_foreach().
+ *
+ * Since the heartbeat wakes up the main loop regularly the watchdog
+ * is meant for debugging only. It must be created from the main
+ * thread and there can only be one at a time.
+ */
+
+#define CAPTURE_SIGNAL       SIGPROF
+#define CAPTURE_TIMEOUT_MS   100
+#define CAPTURE_MAX_FRAMES   64
+#define CAPTURE_SOURCE_LEN   128
+
+enum {
+  PROP_0,
+  PROP_THRESHOLD,
+  PROP_LAST_PROP
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
+/* Filled by the signal handler on the main thread. The watchdog
+ * thread sets @requested to a new generation for each capture. The
+ * handler claims it by negating it so a signal arriving after the
+ * watchdog gave up can't write into a later capture. */
+static struct {
+  char   source[CAPTURE_SOURCE_LEN];
+  void  *frames[CAPTURE_MAX_FRAMES];
+  int    n_frames;
+  gint   requested;
+  sem_t  done;
+} capture;
+static gint capture_generation;
+static gboolean in_use;
+
+struct _PhoshStallWatchdog {
+  GObject           parent;
+
+  guint             threshold;
+  guint             heartbeat_id;
+  pthread_t         main_thread;
+  struct sigaction  old_action;
+  GThread          *thread;
+
+  /* Protected by lock */
+  GMutex            lock;
+  GCond             cond;
+  gboolean          stop;
+  gint64            last_beat;
+  PhoshStallRecord  records[PHOSH_STALL_WATCHDOG_MAX_RECORDS];
+  guint             first_record;
+  guint             num_records;
+  PhoshStallRecord *current;
+};
+G_DEFINE_TYPE (PhoshStallWatchdog, phosh_stall_watchdog, G_TYPE_OBJECT)
+
+
+static void
+on_capture_signal (int signo)
+{
+  int saved_errno = errno;
+  GSource *source;
+  const char *name = NULL;
+  gsize i = 0;
+  gint gen;
+
+  /* Not requested (anymore) or claimed by an earlier signal */
+  gen = g_atomic_int_get (&capture.requested);
+  if (gen <= 0 || !g_atomic_int_compare_and_exchange (&capture.requested, gen, -gen)) {
+    errno = saved_errno;
+    return;
+  }
+
+  /* Neither call is async-signal-safe by POSIX. Since the main thread
+   * dispatched the heartbeat already the thread local dispatch data
+   * exists so they only read it and the source's name without
+   * allocating or locking. The name could only be stale if the
+   * signal interrupted g_source_set_name () on that very source,
+   * which is acceptable for a debugging aid. The heartbeat can't
+   * record the name instead since it doesn't run during a stall. */
+  source = g_main_current_source ();
+  if (source)
+    name = g_source_get_name (source);
+
+  for (; name && name[i] && i < CAPTURE_SOURCE_LEN - 1; i++)
+    capture.source[i] = name[i];
+  capture.source[i] = '\0';
+
+#ifdef HAVE_EXECINFO_H
+  capture.n_frames = backtrace (capture.frames, CAPTURE_MAX_FRAMES);
+#endif
+
+  sem_post (&capture.done);
+  errno = saved_errno;
+}
+
+
+static char *
+format_backtrace (void)
+{
+#ifdef HAVE_EXECINFO_H
+  g_autoptr (GString) str = NULL;
+  char **symbols;
+
+  if (capture.n_frames <= 1)
+    return NULL;
+
+  symbols = backtrace_symbols (capture.frames, capture.n_frames);
+  if (symbols == NULL)
+    return NULL;
+
+  str = g_string_new (NULL);
+  /* Skip the signal handler itself */
+  for (int i = 1; i < capture.n_frames; i++)
+    g_string_append_printf (str, "#%-2d %s\n", i - 1, symbols[i]);
+  free (symbols);
+
+  return g_string_free (g_steal_pointer (&str), FALSE);
+#else
+  return NULL;
+#endif
+}
+
+
+static gboolean
+wait_for_capture (void)
+{
+  struct timespec deadline;
+
+  clock_gettime (CLOCK_REALTIME, &deadline);
+  deadline.tv_nsec += CAPTURE_TIMEOUT_MS * 1000 * 1000;
+  deadline.tv_sec += deadline.tv_nsec / (1000 * 1000 * 1000);
+  deadline.tv_nsec %= 1000 * 1000 * 1000;
+
+  while (sem_timedwait (&capture.done, &deadline) != 0) {
+    if (errno != EINTR)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+
+/* Called on the watchdog thread with lock held */
+static void
+begin_stall (PhoshStallWatchdog *self, gint64 begin)
+{
+  PhoshStallRecord *record;
+  char *source = NULL, *bt = NULL;
+  gboolean captured = FALSE;
+  gint gen;
+
+  /* Don't hold the lock while waiting for the main thread */
+  g_mutex_unlock (&self->lock);
+
+  while (sem_trywait (&capture.done) == 0)
+    ;
+  capture.source[0] = '\0';
+  capture.n_frames = 0;
+  gen = ++capture_generation;
+  if (gen <= 0)
+    gen = capture_generation = 1;
+  g_atomic_int_set (&capture.requested, gen);
+
+  if (pthread_kill (self->main_thread, CAPTURE_SIGNAL) == 0 && wait_for_capture ()) {
+    captured = TRUE;
+  } else if (!g_atomic_int_compare_and_exchange (&capture.requested, gen, 0)) {
+    /* The handler claimed the capture already, let it finish so it
+     * doesn't race with the next one */
+    while (sem_wait (&capture.done) != 0 && errno == EINTR)
+      ;
+    captured = TRUE;
+  }
+
+  if (captured) {
+    if (capture.source[0])
+      source = g_strdup (capture.source);
+    bt = format_backtrace ();
+  } else {
+    g_debug ("Failed to capture main thread state");
+  }
+
+  g_message ("Main loop stalled for more than %ums in '%s'", self->threshold,
+             source ?: "unknown source");
+
+  g_mutex_lock (&self->lock);
+  if (self->num_records < PHOSH_STALL_WATCHDOG_MAX_RECORDS) {
+    record = &self->records[(self->first_record + self->num_records) % PHOSH_STALL_WATCHDOG_MAX_RECORDS];
+    self->num_records++;
+  } else {
+    /* Buffer full, overwrite the oldest record */
+    record = &self->records[self->first_record];
+    self->first_record = (self->first_record + 1) % PHOSH_STALL_WATCHDOG_MAX_RECORDS;
+    g_free (record->source);
+    g_free (record->backtrace);
+  }
+
+  record->begin = begin;
+  record->duration = 0;
+  record->source = source;
+  record->backtrace = bt;
+  self->current = record;
+}
+
+
+/* Called on the watchdog thread with lock held */
+static void
+end_stall (PhoshStallWatchdog *self, gint64 end)
+{
+  PhoshStallRecord *record = self->current;
+
+  /* Cleared meanwhile */
+  if (record == NULL)
+    return;
+
+  record->duration = end - record->begin;
+  self->current = NULL;
+
+  g_debug ("Main loop stall in '%s' took %.1fms", record->source ?: "unknown source",
+           record->duration / 1000.0);
+  phosh_trace_event ("main-loop-stall", "%.1fms in '%s'", record->duration / 1000.0,
+                     record->source ?: "unknown source");
+}
+
+
+static gpointer
+watchdog_thread (gpointer data)
+{
+  PhoshStallWatchdog *self = PHOSH_STALL_WATCHDOG (data);
+  gint64 threshold = (gint64) self->threshold * 1000;
+  gint64 interval = MAX (threshold / 4, 1000);
+  gint64 stall_begin = 0;
+  gboolean stalled = FALSE;
+
+  g_mutex_lock (&self->lock);
+  while (!self->stop) {
+    gint64 now;
+
+    g_cond_wait_until (&self->cond, &self->lock, g_get_monotonic_time () + interval);
+    if (self->stop)
+      break;
+
+    now = g_get_monotonic_time ();
+    if (!stalled && now - self->last_beat > threshold) {
+      stalled = TRUE;
+      stall_begin = self->last_beat;
+      begin_stall (self, stall_begin);
+    } else if (stalled && self->last_beat > stall_begin) {
+      stalled = FALSE;
+      end_stall (self, self->last_beat);
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  return NULL;
+}
+
+
+static gboolean
+on_heartbeat (PhoshStallWatchdog *self)
+{
+  g_mutex_lock (&self->lock);
+  self->last_beat = g_get_monotonic_time ();
+  g_mutex_unlock (&self->lock);
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+static void
+clear_records (PhoshStallWatchdog *self)
+{
+  for (guint i = 0; i < self->num_records; i++) {
+    PhoshStallRecord *record = &self->records[(self->first_record + i) % PHOSH_STALL_WATCHDOG_MAX_RECORDS];
+
+    g_clear_pointer (&record->source, g_free);
+    g_clear_pointer (&record->backtrace, g_free);
+  }
+  self->first_record = 0;
+  self->num_records = 0;
+  self->current = NULL;
+}
+
+
+static void
+phosh_stall_watchdog_set_property (GObject      *object,
+                                   guint         property_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+  PhoshStallWatchdog *self = PHOSH_STALL_WATCHDOG (object);
+
+  switch (property_id) {
+  case PROP_THRESHOLD:
+    self->threshold = g_value_get_uint (value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_stall_watchdog_get_property (GObject    *object,
+                                   guint       property_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+  PhoshStallWatchdog *self = PHOSH_STALL_WATCHDOG (object);
+
+  switch (property_id) {
+  case PROP_THRESHOLD:
+    g_value_set_uint (value, self->threshold);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_stall_watchdog_constructed (GObject *object)
+{
+  PhoshStallWatchdog *self = PHOSH_STALL_WATCHDOG (object);
+  struct sigaction action = { 0 };
+  guint interval;
+
+  G_OBJECT_CLASS (phosh_stall_watchdog_parent_class)->constructed (object);
+
+  g_return_if_fail (!in_use);
+  in_use = TRUE;
+
+  self->main_thread = pthread_self ();
+#ifdef HAVE_EXECINFO_H
+  /* backtrace () might load libgcc on first use which isn't safe
+   * from within a signal handler */
+  capture.n_frames = backtrace (capture.frames, CAPTURE_MAX_FRAMES);
+#endif
+
+  action.sa_handler = on_capture_signal;
+  action.sa_flags = SA_RESTART;
+  sigemptyset (&action.sa_mask);
+  if (sigaction (CAPTURE_SIGNAL, &action, &self->old_action) != 0)
+    g_warning ("Failed to install signal handler: %s", g_strerror (errno));
+
+  self->last_beat = g_get_monotonic_time ();
+  interval = MAX (self->threshold / 2, 1);
+  self->heartbeat_id = g_timeout_add_full (G_PRIORITY_HIGH,
+                                           interval,
+                                           (GSourceFunc) on_heartbeat,
+                                           self,
+                                           NULL);
+  g_source_set_name_by_id (self->heartbeat_id, "[phosh] stall watchdog heartbeat");
+
+  self->thread = g_thread_new ("phosh-stall-watchdog", watchdog_thread, self);
+  g_debug ("Watching for main loop stalls > %ums", self->threshold);
+}
+
+
+static void
+phosh_stall_watchdog_dispose (GObject *object)
+{
+  PhoshStallWatchdog *self = PHOSH_STALL_WATCHDOG (object);
+
+  if (self->thread) {
+    g_mutex_lock (&self->lock);
+    self->stop = TRUE;
+    g_cond_signal (&self->cond);
+    g_mutex_unlock (&self->lock);
+
+    g_clear_pointer (&self->thread, g_thread_join);
+    sigaction (CAPTURE_SIGNAL, &self->old_action, NULL);
+    in_use = FALSE;
+  }
+  g_clear_handle_id (&self->heartbeat_id, g_source_remove);
+
+  G_OBJECT_CLASS (phosh_stall_watchdog_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_stall_watchdog_finalize (GObject *object)
+{
+  PhoshStallWatchdog *self = PHOSH_STALL_WATCHDOG (object);
+
+  clear_records (self);
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (phosh_stall_watchdog_parent_class)->finalize (object);
+}
+
+
+static void
+phosh_stall_watchdog_class_init (PhoshStallWatchdogClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->constructed = phosh_stall_watchdog_constructed;
+  object_class->dispose = phosh_stall_watchdog_dispose;
+  object_class->finalize = phosh_stall_watchdog_finalize;
+  object_class->set_property = phosh_stall_watchdog_set_property;
+  object_class->get_property = phosh_stall_watchdog_get_property;
+
+  /**
+   * PhoshStallWatchdog:threshold:
+   *
+   * Main loop iterations taking longer than this many milliseconds
+   * are recorded as stall
+   */
+  props[PROP_THRESHOLD] =
+    g_param_spec_uint ("threshold",
+                       "Threshold",
+                       "Stall threshold in ms",
+                       1, G_MAXUINT, 50,
+                       G_PARAM_READWRITE |
+                       G_PARAM_CONSTRUCT_ONLY |
+                       G_PARAM_STATIC_STRINGS);
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+
+  sem_init (&capture.done, 0, 0);
+}
+
+
+static void
+phosh_stall_watchdog_init (PhoshStallWatchdog *self)
+{
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+}
+
+
+PhoshStallWatchdog *
+phosh_stall_watchdog_new (guint threshold_ms)
+{
+  return g_object_new (PHOSH_TYPE_STALL_WATCHDOG, "threshold", threshold_ms, NULL);
+}
+
+
+guint
+phosh_stall_watchdog_get_threshold (PhoshStallWatchdog *self)
+{
+  g_return_val_if_fail (PHOSH_IS_STALL_WATCHDOG (self), 0);
+
+  return self->threshold;
+}
+
+/**
+ * phosh_stall_watchdog_foreach:
+ * @self: The #PhoshStallWatchdog
+ * @func: (scope call): The function to invoke
+ * @user_data: The user data passed to @func
+ *
+ * Invokes @func for every recorded stall, oldest first. @func is
+ * invoked with an internal lock held so it must not call back into
+ * @self.
+ */
+void
+phosh_stall_watchdog_foreach (PhoshStallWatchdog   *self,
+                              PhoshStallRecordFunc  func,
+                              gpointer              user_data)
+{
+  g_return_if_fail (PHOSH_IS_STALL_WATCHDOG (self));
+  g_return_if_fail (func);
+
+  g_mutex_lock (&self->lock);
+  for (guint i = 0; i < self->num_records; i++)
+    func (&self->records[(self->first_record + i) % PHOSH_STALL_WATCHDOG_MAX_RECORDS], user_data);
+  g_mutex_unlock (&self->lock);
+}
+
+/**
+ * phosh_stall_watchdog_clear:
+ * @self: The #PhoshStallWatchdog
+ *
+ * Drops all recorded stalls.
+ */
+void
+phosh_stall_watchdog_clear (PhoshStallWatchdog *self)
+{
+  g_return_if_fail (PHOSH_IS_STALL_WATCHDOG (self));
+
+  g_mutex_lock (&self->lock);
+  clear_records (self);
+  g_mutex_unlock (&self->lock);
+}
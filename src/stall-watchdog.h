@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_STALL_WATCHDOG_MAX_RECORDS 32
+
+/**
+ * PhoshStallRecord:
+ * @begin: Monotonic time in µs of the last heartbeat before the stall
+ * @duration: The stall's duration in µs, 0 while it's still ongoing
+ * @source: (nullable): The name of the #GSource being dispatched
+ * @backtrace: (nullable): The main thread's backtrace during the stall
+ *
+ * A recorded main loop stall.
+ */
+typedef struct _PhoshStallRecord {
+  gint64  begin;
+  gint64  duration;
+  char   *source;
+  char   *backtrace;
+} PhoshStallRecord;
+
+typedef void (*PhoshStallRecordFunc) (const PhoshStallRecord *record, gpointer user_data);
+
+#define PHOSH_TYPE_STALL_WATCHDOG (phosh_stall_watchdog_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshStallWatchdog, phosh_stall_watchdog, PHOSH, STALL_WATCHDOG, GObject)
+
+PhoshStallWatchdog *phosh_stall_watchdog_new           (guint                 threshold_ms);
+guint               phosh_stall_watchdog_get_threshold (PhoshStallWatchdog   *self);
+void                phosh_stall_watchdog_foreach       (PhoshStallWatchdog   *self,
+                                                        PhoshStallRecordFunc  func,
+                                                        gpointer              user_data);
+void                phosh_stall_watchdog_clear         (PhoshStallWatchdog   *self);
+
+G_END_DECLS
@@ -10,12 +10,17 @@
 
 #include "config.h"
 
+#include "display-state.h"
 #include "status-icon.h"
 
 /**
  * SECTION:status-icon
  * @short_description: Base clase for different status icons e.g in the top bar
  * @Title: PhoshStatusIcon
+ *
+ * While the display is off icon changes are not applied but
+ * deferred until the display is powered on again so invisible
+ * widgets don't get laid out over and over.
  */
 
 enum {
@@ -34,6 +39,11 @@ typedef struct
   GtkWidget *extra_widget;
   GtkIconSize icon_size;
   char *info;
+
+  /* Updates deferred while the display is off */
+  gboolean icon_pending;
+  char *pending_icon_name;
+  gboolean info_pending;
 } PhoshStatusIconPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (PhoshStatusIcon, phosh_status_icon, GTK_TYPE_BIN);
@@ -99,11 +109,37 @@ phosh_status_icon_finalize (GObject *gobject)
   PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (PHOSH_STATUS_ICON (gobject));
 
   g_clear_pointer (&priv->info, g_free);
+  g_clear_pointer (&priv->pending_icon_name, g_free);
 
   G_OBJECT_CLASS (phosh_status_icon_parent_class)->finalize (gobject);
 }
 
 
+static void
+on_display_off_changed (PhoshStatusIcon   *self,
+                        GParamSpec        *pspec,
+                        PhoshDisplayState *state)
+{
+  PhoshStatusIconPrivate *priv = phosh_status_icon_get_instance_private (self);
+
+  if (phosh_display_state_get_display_off (state))
+    return;
+
+  /* Catch up with what changed while the display was off */
+  if (priv->icon_pending) {
+    g_autofree char *icon_name = g_steal_pointer (&priv->pending_icon_name);
+
+    priv->icon_pending = FALSE;
+    phosh_status_icon_set_icon_name (self, icon_name);
+  }
+
+  if (priv->info_pending) {
+    priv->info_pending = FALSE;
+    g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_STATUS_ICON_PROP_INFO]);
+  }
+}
+
+
 static void
 phosh_status_icon_class_init (PhoshStatusIconClass *klass)
 {
@@ -166,6 +202,12 @@ phosh_status_icon_init (PhoshStatusIcon *self)
   }
 
   gtk_container_add (GTK_CONTAINER (self), box);
+
+  g_signal_connect_object (phosh_display_state_get_default (),
+                           "notify::display-off",
+                           G_CALLBACK (on_display_off_changed),
+                           self,
+                           G_CONNECT_SWAPPED);
 }
 
 
@@ -190,6 +232,14 @@ phosh_status_icon_set_icon_name (PhoshStatusIcon *self, const char *icon_name)
   if (!g_strcmp0 (old_icon_name, icon_name))
     return;
 
+  if (phosh_display_state_get_display_off (phosh_display_state_get_default ())) {
+    phosh_display_state_add_avoided_wakeups (phosh_display_state_get_default (), 1);
+    g_free (priv->pending_icon_name);
+    priv->pending_icon_name = g_strdup (icon_name);
+    priv->icon_pending = TRUE;
+    return;
+  }
+
   gtk_image_set_from_icon_name (GTK_IMAGE (priv->image),
 				icon_name,
 				phosh_status_icon_get_icon_size (self));
@@ -208,6 +258,9 @@ phosh_status_icon_get_icon_name (PhoshStatusIcon *self)
 
   priv = phosh_status_icon_get_instance_private (self);
 
+  if (priv->icon_pending)
+    return g_strdup (priv->pending_icon_name);
+
   g_object_get (priv->image, "icon-name", &icon_name, NULL);
 
   return icon_name;
@@ -310,6 +363,13 @@ phosh_status_icon_set_info (PhoshStatusIcon *self, const char *info)
   g_clear_pointer (&priv->info, g_free);
   priv->info = g_strdup (info);
 
+  /* Listeners only update labels so defer the notify */
+  if (phosh_display_state_get_display_off (phosh_display_state_get_default ())) {
+    phosh_display_state_add_avoided_wakeups (phosh_display_state_get_default (), 1);
+    priv->info_pending = TRUE;
+    return;
+  }
+
   g_object_notify_by_pspec (G_OBJECT (self), props[PHOSH_STATUS_ICON_PROP_INFO]);
 }
 
@@ -21,6 +21,9 @@
  * SECTION:toplevel-thumbnail
  * @short_description: Represents an image snapshot of PhoshToplevel obtained via phosh-private and wlr-screencopy Wayland protocols.
  * @Title: PhoshToplevelThumbnail
+ *
+ * If the image can't be captured #PhoshToplevelThumbnail::failed is
+ * emitted and the thumbnail never becomes ready.
  */
 
 enum {
@@ -30,6 +33,12 @@ enum {
 };
 static GParamSpec *props[PHOSH_TOPLEVEL_THUMBNAIL_PROP_LAST_PROP];
 
+enum {
+  FAILED,
+  N_SIGNALS
+};
+static guint signals[N_SIGNALS] = { 0 };
+
 struct _PhoshToplevelThumbnail {
   GObject parent;
   struct zwlr_screencopy_frame_v1 *handle;
@@ -122,12 +131,14 @@ screencopy_handle_buffer (void *data,
 
   if (!size) {
     g_warning ("Got screencopy_handle_buffer with no size!");
+    g_signal_emit (self, signals[FAILED], 0);
     return;
   }
 
   fd = create_shm_file (size);
   if (fd == -1) {
     g_warning ("Could not create shm file for thumbnail buffer! %s", g_strerror (errno));
+    g_signal_emit (self, signals[FAILED], 0);
     return;
   }
 
@@ -135,6 +146,7 @@ screencopy_handle_buffer (void *data,
   if (d == MAP_FAILED) {
     g_warning ("Could not mmap thumbnail buffer file! [fd: %d] %s", fd, g_strerror (errno));
     close (fd);
+    g_signal_emit (self, signals[FAILED], 0);
     return;
   }
 
@@ -174,6 +186,7 @@ screencopy_handle_failed (void *data,
                           struct zwlr_screencopy_frame_v1 *zwlr_screencopy_frame_v1)
 {
   g_warning ("screencopy failed! %p", data);
+  g_signal_emit (data, signals[FAILED], 0);
 }
 
 static void
@@ -326,6 +339,16 @@ phosh_toplevel_thumbnail_class_init (PhoshToplevelThumbnailClass *klass)
 
   g_object_class_install_properties (object_class, PHOSH_TOPLEVEL_THUMBNAIL_PROP_LAST_PROP, props);
 
+  /**
+   * PhoshToplevelThumbnail::failed:
+   * @self: The #PhoshToplevelThumbnail
+   *
+   * Emitted when capturing the image failed.
+   */
+  signals[FAILED] = g_signal_new ("failed",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST, 0, NULL, NULL,
+      NULL, G_TYPE_NONE, 0);
+
 }
 
 
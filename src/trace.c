@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-trace"
+
+#include "config.h"
+#include "trace.h"
+
+#ifdef HAVE_SYSPROF
+# include <sysprof-capture.h>
+#endif
+
+/**
+ * SECTION:trace
+ * @short_description: Lightweight phase instrumentation
+ * @Title: Tracing
+ *
+ * Records the begin and duration of phases like the construction
+ * of a subsystem or the time until it became ready. When built with
+ * sysprof support every phase is also emitted as a sysprof capture
+ * mark. Independent of that the last %PHOSH_TRACE_MAX_ENTRIES phases
+ * are kept in a ring buffer so they can be reported without any
+ * external tooling, see phosh_trace_format_report().
+ *
+ * All functions are thread safe.
+ */
+
+#define REPORT_BAR_WIDTH 40
+
+static GMutex          trace_lock;
+static PhoshTraceEntry entries[PHOSH_TRACE_MAX_ENTRIES];
+static guint           first_entry;
+static guint           num_entries;
+static gint64          start_time;
+
+
+static void
+record (const char *name, gint64 begin, gint64 duration, const char *format, va_list args)
+{
+  PhoshTraceEntry *entry;
+  char *description = NULL;
+
+  if (format)
+    description = g_strdup_vprintf (format, args);
+
+#ifdef HAVE_SYSPROF
+  sysprof_collector_mark (begin * 1000, duration * 1000, "phosh", name, description ?: "");
+#endif
+
+  g_mutex_lock (&trace_lock);
+  if (start_time == 0)
+    start_time = begin;
+
+  if (num_entries < PHOSH_TRACE_MAX_ENTRIES) {
+    entry = &entries[(first_entry + num_entries) % PHOSH_TRACE_MAX_ENTRIES];
+    num_entries++;
+  } else {
+    /* Buffer full, overwrite the oldest entry */
+    entry = &entries[first_entry];
+    first_entry = (first_entry + 1) % PHOSH_TRACE_MAX_ENTRIES;
+    g_free (entry->description);
+  }
+
+  entry->name = g_intern_string (name);
+  entry->description = description;
+  entry->begin = begin;
+  entry->duration = duration;
+  g_mutex_unlock (&trace_lock);
+}
+
+
+/**
+ * phosh_trace_init:
+ *
+ * Sets the reference time for reports to now. Call this as early as
+ * possible. If not called the first recorded phase is used as
+ * reference.
+ */
+void
+phosh_trace_init (void)
+{
+  g_mutex_lock (&trace_lock);
+  if (start_time == 0)
+    start_time = g_get_monotonic_time ();
+  g_mutex_unlock (&trace_lock);
+}
+
+
+/**
+ * phosh_trace_get_start_time:
+ *
+ * Returns: The monotonic reference time in µs or 0 if not yet known.
+ */
+gint64
+phosh_trace_get_start_time (void)
+{
+  gint64 ret;
+
+  g_mutex_lock (&trace_lock);
+  ret = start_time;
+  g_mutex_unlock (&trace_lock);
+
+  return ret;
+}
+
+
+/**
+ * phosh_trace_now:
+ *
+ * Returns: The current time to be passed to phosh_trace_mark() later on.
+ */
+gint64
+phosh_trace_now (void)
+{
+  return g_get_monotonic_time ();
+}
+
+
+/**
+ * phosh_trace_mark:
+ * @name: The phase's name
+ * @begin: When the phase began as returned by phosh_trace_now()
+ * @format: (nullable): printf-style format for the description
+ * @...: The parameters for @format
+ *
+ * Records a phase that started at @begin and ends now.
+ */
+void
+phosh_trace_mark (const char *name, gint64 begin, const char *format, ...)
+{
+  va_list args;
+
+  g_return_if_fail (name);
+
+  va_start (args, format);
+  record (name, begin, MAX (phosh_trace_now () - begin, 0), format, args);
+  va_end (args);
+}
+
+
+/**
+ * phosh_trace_event:
+ * @name: The event's name
+ * @format: (nullable): printf-style format for the description
+ * @...: The parameters for @format
+ *
+ * Records a single event without duration (e.g. a subsystem
+ * becoming ready).
+ */
+void
+phosh_trace_event (const char *name, const char *format, ...)
+{
+  va_list args;
+
+  g_return_if_fail (name);
+
+  va_start (args, format);
+  record (name, phosh_trace_now (), 0, format, args);
+  va_end (args);
+}
+
+
+/**
+ * phosh_trace_foreach:
+ * @func: (scope call): The function to invoke
+ * @user_data: The user data passed to @func
+ *
+ * Invokes @func for every recorded entry, oldest first. @func must
+ * not record new phases.
+ */
+void
+phosh_trace_foreach (PhoshTraceFunc func, gpointer user_data)
+{
+  g_return_if_fail (func);
+
+  g_mutex_lock (&trace_lock);
+  for (guint i = 0; i < num_entries; i++)
+    func (&entries[(first_entry + i) % PHOSH_TRACE_MAX_ENTRIES], user_data);
+  g_mutex_unlock (&trace_lock);
+}
+
+
+static int
+compare_begin (gconstpointer a, gconstpointer b)
+{
+  const PhoshTraceEntry *entry_a = a;
+  const PhoshTraceEntry *entry_b = b;
+
+  if (entry_a->begin == entry_b->begin)
+    return 0;
+
+  return entry_a->begin < entry_b->begin ? -1 : 1;
+}
+
+
+/**
+ * phosh_trace_format_report:
+ *
+ * Formats the recorded phases as a waterfall sorted by begin time.
+ *
+ * Returns: (transfer full): The report
+ */
+char *
+phosh_trace_format_report (void)
+{
+  g_autoptr (GArray) sorted = g_array_new (FALSE, FALSE, sizeof (PhoshTraceEntry));
+  GString *report = g_string_new (NULL);
+  gint64 start, end = 0;
+  double scale;
+
+  g_mutex_lock (&trace_lock);
+  start = start_time;
+  for (guint i = 0; i < num_entries; i++) {
+    PhoshTraceEntry entry = entries[(first_entry + i) % PHOSH_TRACE_MAX_ENTRIES];
+
+    /* Descriptions are only valid while locked */
+    entry.description = g_strdup (entry.description);
+    g_array_append_val (sorted, entry);
+  }
+  g_mutex_unlock (&trace_lock);
+
+  g_array_sort (sorted, compare_begin);
+  for (guint i = 0; i < sorted->len; i++) {
+    PhoshTraceEntry *entry = &g_array_index (sorted, PhoshTraceEntry, i);
+
+    end = MAX (end, entry->begin + entry->duration);
+  }
+  scale = end > start ? (double) REPORT_BAR_WIDTH / (end - start) : 0.0;
+
+  g_string_append_printf (report, "%9s %9s  %-*s  %s\n",
+                          "start/ms", "took/ms", REPORT_BAR_WIDTH + 2, "", "phase");
+  for (guint i = 0; i < sorted->len; i++) {
+    PhoshTraceEntry *entry = &g_array_index (sorted, PhoshTraceEntry, i);
+    int offset = (entry->begin - start) * scale;
+    int width = MAX (1, entry->duration * scale);
+
+    offset = CLAMP (offset, 0, REPORT_BAR_WIDTH - 1);
+    width = MIN (width, REPORT_BAR_WIDTH - offset);
+
+    g_string_append_printf (report, "%9.1f %9.1f  |", (entry->begin - start) / 1000.0,
+                            entry->duration / 1000.0);
+    for (int j = 0; j < REPORT_BAR_WIDTH; j++)
+      g_string_append_c (report, (j >= offset && j < offset + width) ?
+                         (entry->duration ? '#' : '|') : ' ');
+    g_string_append_printf (report, "|  %s%s%s\n", entry->name,
+                            entry->description ? ": " : "",
+                            entry->description ?: "");
+    g_free (entry->description);
+  }
+  g_string_append_printf (report, "Total: %.1fms\n", MAX (end - start, 0) / 1000.0);
+
+  return g_string_free (report, FALSE);
+}
+
+
+/**
+ * phosh_trace_clear:
+ *
+ * Drops all recorded entries and the reference time.
+ */
+void
+phosh_trace_clear (void)
+{
+  g_mutex_lock (&trace_lock);
+  for (guint i = 0; i < num_entries; i++)
+    g_clear_pointer (&entries[(first_entry + i) % PHOSH_TRACE_MAX_ENTRIES].description, g_free);
+  first_entry = 0;
+  num_entries = 0;
+  start_time = 0;
+  g_mutex_unlock (&trace_lock);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TRACE_MAX_ENTRIES 256
+
+/**
+ * PhoshTraceEntry:
+ * @name: The (interned) name of the traced phase
+ * @description: (nullable): Additional information
+ * @begin: Monotonic time in µs the phase started
+ * @duration: The phase's duration in µs, 0 for single events
+ *
+ * A recorded phase or event.
+ */
+typedef struct _PhoshTraceEntry {
+  const char *name;
+  char       *description;
+  gint64      begin;
+  gint64      duration;
+} PhoshTraceEntry;
+
+typedef void (*PhoshTraceFunc) (const PhoshTraceEntry *entry, gpointer user_data);
+
+void   phosh_trace_init           (void);
+gint64 phosh_trace_get_start_time (void);
+gint64 phosh_trace_now            (void);
+void   phosh_trace_mark           (const char     *name,
+                                   gint64          begin,
+                                   const char     *format,
+                                   ...) G_GNUC_PRINTF (3, 4);
+void   phosh_trace_event          (const char     *name,
+                                   const char     *format,
+                                   ...) G_GNUC_PRINTF (2, 3);
+void   phosh_trace_foreach        (PhoshTraceFunc  func,
+                                   gpointer        user_data);
+char  *phosh_trace_format_report  (void);
+void   phosh_trace_clear          (void);
+
+G_END_DECLS
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#define G_LOG_DOMAIN "phosh-value-writer"
+
+#include "config.h"
+
+#include "value-writer.h"
+
+/**
+ * SECTION:value-writer
+ * @short_description: Latest value wins writes to a slow target
+ * @Title: PhoshValueWriter
+ *
+ * Sliders and repeated key presses produce values much faster than
+ * e.g. PulseAudio or a D-Bus service can apply them. A
+ * #PhoshValueWriter keeps at most one write in flight. Values set
+ * while a write is in flight replace each other and only the latest
+ * one is written once the target acknowledged the previous write
+ * via phosh_value_writer_done().
+ *
+ * Since not every target reports completion reliably a timeout can
+ * be given after which a write is considered done anyway.
+ *
+ * While phosh_value_writer_is_busy() returns %TRUE the target's
+ * change notifications are echoes of our own writes and shouldn't
+ * be fed back into the slider.
+ */
+
+struct _PhoshValueWriter {
+  GObject              parent;
+
+  PhoshValueWriterFunc func;
+  gpointer             user_data;
+  guint                timeout;
+
+  gboolean             in_flight;
+  gboolean             has_pending;
+  double               pending;
+  guint                timeout_id;
+};
+G_DEFINE_TYPE (PhoshValueWriter, phosh_value_writer, G_TYPE_OBJECT)
+
+
+static gboolean
+on_timeout (PhoshValueWriter *self)
+{
+  g_debug ("Write not acknowledged in %ums", self->timeout);
+  self->timeout_id = 0;
+  phosh_value_writer_done (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+write_pending (PhoshValueWriter *self)
+{
+  self->has_pending = FALSE;
+  self->in_flight = TRUE;
+
+  g_clear_handle_id (&self->timeout_id, g_source_remove);
+  if (self->timeout) {
+    self->timeout_id = g_timeout_add (self->timeout, (GSourceFunc) on_timeout, self);
+    g_source_set_name_by_id (self->timeout_id, "[phosh] value writer");
+  }
+
+  /* Might call phosh_value_writer_done () right away */
+  self->func (self, self->pending, self->user_data);
+}
+
+
+static void
+phosh_value_writer_dispose (GObject *object)
+{
+  PhoshValueWriter *self = PHOSH_VALUE_WRITER (object);
+
+  g_clear_handle_id (&self->timeout_id, g_source_remove);
+  self->has_pending = FALSE;
+
+  G_OBJECT_CLASS (phosh_value_writer_parent_class)->dispose (object);
+}
+
+
+static void
+phosh_value_writer_class_init (PhoshValueWriterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = phosh_value_writer_dispose;
+}
+
+
+static void
+phosh_value_writer_init (PhoshValueWriter *self)
+{
+}
+
+/**
+ * phosh_value_writer_new:
+ * @func: The function that starts a write
+ * @user_data: Data passed to @func
+ * @timeout_ms: Time after which an unacknowledged write is
+ *   considered done or 0 to wait for phosh_value_writer_done()
+ *
+ * Returns: A new #PhoshValueWriter
+ */
+PhoshValueWriter *
+phosh_value_writer_new (PhoshValueWriterFunc func, gpointer user_data, guint timeout_ms)
+{
+  PhoshValueWriter *self;
+
+  g_return_val_if_fail (func, NULL);
+
+  self = g_object_new (PHOSH_TYPE_VALUE_WRITER, NULL);
+  self->func = func;
+  self->user_data = user_data;
+  self->timeout = timeout_ms;
+
+  return self;
+}
+
+/**
+ * phosh_value_writer_set:
+ * @self: The #PhoshValueWriter
+ * @value: The new value
+ *
+ * Write @value. If a write is in flight @value replaces any other
+ * value waiting and is written once the in flight write is done.
+ */
+void
+phosh_value_writer_set (PhoshValueWriter *self, double value)
+{
+  g_return_if_fail (PHOSH_IS_VALUE_WRITER (self));
+
+  self->pending = value;
+  self->has_pending = TRUE;
+
+  if (!self->in_flight)
+    write_pending (self);
+}
+
+/**
+ * phosh_value_writer_done:
+ * @self: The #PhoshValueWriter
+ *
+ * Marks the write in flight as done and starts writing the latest
+ * value that came in meanwhile (if any).
+ */
+void
+phosh_value_writer_done (PhoshValueWriter *self)
+{
+  g_return_if_fail (PHOSH_IS_VALUE_WRITER (self));
+
+  if (!self->in_flight)
+    return;
+
+  self->in_flight = FALSE;
+  g_clear_handle_id (&self->timeout_id, g_source_remove);
+
+  if (self->has_pending)
+    write_pending (self);
+}
+
+/**
+ * phosh_value_writer_flush:
+ * @self: The #PhoshValueWriter
+ *
+ * Make sure the latest value gets written. Use this e.g. when the user
+ * releases a slider so the final position isn't lost. If a write is
+ * in flight the value is written as soon as that one is done as the
+ * target would otherwise see two concurrent writes.
+ */
+void
+phosh_value_writer_flush (PhoshValueWriter *self)
+{
+  g_return_if_fail (PHOSH_IS_VALUE_WRITER (self));
+
+  if (!self->has_pending)
+    return;
+
+  if (self->in_flight) {
+    g_debug ("Write in flight, flushing once it's done");
+    return;
+  }
+
+  write_pending (self);
+}
+
+/**
+ * phosh_value_writer_is_busy:
+ * @self: The #PhoshValueWriter
+ *
+ * Returns: %TRUE if a write is in flight or waiting
+ */
+gboolean
+phosh_value_writer_is_busy (PhoshValueWriter *self)
+{
+  g_return_val_if_fail (PHOSH_IS_VALUE_WRITER (self), FALSE);
+
+  return self->in_flight || self->has_pending;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define PHOSH_TYPE_VALUE_WRITER (phosh_value_writer_get_type ())
+
+G_DECLARE_FINAL_TYPE (PhoshValueWriter, phosh_value_writer, PHOSH, VALUE_WRITER, GObject)
+
+/**
+ * PhoshValueWriterFunc:
+ * @writer: The #PhoshValueWriter
+ * @value: The value to write
+ * @user_data: The user data passed to phosh_value_writer_new()
+ *
+ * Starts writing @value to the target. Once the target acknowledged
+ * the write phosh_value_writer_done() must be invoked on @writer.
+ */
+typedef void (*PhoshValueWriterFunc) (PhoshValueWriter *writer,
+                                      double            value,
+                                      gpointer          user_data);
+
+PhoshValueWriter *phosh_value_writer_new     (PhoshValueWriterFunc  func,
+                                              gpointer              user_data,
+                                              guint                 timeout_ms);
+void              phosh_value_writer_set     (PhoshValueWriter     *self,
+                                              double                value);
+void              phosh_value_writer_done    (PhoshValueWriter     *self);
+void              phosh_value_writer_flush   (PhoshValueWriter     *self);
+gboolean          phosh_value_writer_is_busy (PhoshValueWriter     *self);
+
+G_END_DECLS
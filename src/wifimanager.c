@@ -17,6 +17,8 @@
 #include "wifimanager.h"
 #include "shell.h"
 #include "phosh-wayland.h"
+#include "nm-service.h"
+#include "signal-filter.h"
 
 #include <NetworkManager.h>
 
@@ -55,6 +57,9 @@ struct _PhoshWifiManager
   char               *ssid;
 
   NMClient           *nmclient;
+  GCancellable       *cancel;
+  /* Keeps the icon stable when the strength jitters */
+  PhoshSignalFilter  *strength_filter;
   /* The access point we're connected to */
   NMAccessPoint      *ap;
   /* The active connection (if it has a wifi device */
@@ -67,19 +72,24 @@ struct _PhoshWifiManager
 G_DEFINE_TYPE (PhoshWifiManager, phosh_wifi_manager, G_TYPE_OBJECT);
 
 
+#define STRENGTH_MIN_INTERVAL_MS 5000
+
 static const char *
-signal_strength_icon_name (guint strength)
+signal_level_icon_name (PhoshSignalLevel level)
 {
-  if (strength > 80)
+  switch (level) {
+  case PHOSH_SIGNAL_LEVEL_EXCELLENT:
     return "network-wireless-signal-excellent-symbolic";
-  else if (strength > 55)
+  case PHOSH_SIGNAL_LEVEL_GOOD:
     return "network-wireless-signal-good-symbolic";
-  else if (strength > 30)
+  case PHOSH_SIGNAL_LEVEL_OK:
     return "network-wireless-signal-ok-symbolic";
-  else if (strength > 5)
+  case PHOSH_SIGNAL_LEVEL_WEAK:
     return "network-wireless-signal-weak-symbolic";
-  else
+  case PHOSH_SIGNAL_LEVEL_NONE:
+  default:
     return "network-wireless-signal-none-symbolic";
+  }
 }
 
 
@@ -87,7 +97,7 @@ static const char *
 get_icon_name (PhoshWifiManager *self)
 {
   NMActiveConnectionState state;
-  guint8 strength;
+  PhoshSignalLevel level;
 
   if (!self->dev) {
     if (self->enabled && self->present) {
@@ -105,8 +115,8 @@ get_icon_name (PhoshWifiManager *self)
     if (!self->ap) {
       return "network-wireless-connected-symbolic";
     } else {
-      strength = phosh_wifi_manager_get_strength (self);
-      return signal_strength_icon_name (strength);
+      level = phosh_signal_filter_get_level (self->strength_filter);
+      return signal_level_icon_name (level);
     }
   case NM_ACTIVE_CONNECTION_STATE_UNKNOWN:
   case NM_ACTIVE_CONNECTION_STATE_DEACTIVATING:
@@ -206,7 +216,8 @@ on_nm_access_point_strength_changed (PhoshWifiManager *self, GParamSpec *pspec,
   strength = phosh_wifi_manager_get_strength (self);
   g_debug ("Strength changed: %d", strength);
 
-  update_state (self);
+  /* The icon is updated via the filter's level */
+  phosh_signal_filter_update (self->strength_filter, strength);
 }
 
 
@@ -244,7 +255,10 @@ on_nm_device_wifi_active_access_point_changed (PhoshWifiManager *self, GParamSpe
   if(self->ap) {
     g_signal_connect_swapped (self->ap, "notify::strength",
                               G_CALLBACK (on_nm_access_point_strength_changed), self);
+    /* Show the new access point's strength right away */
+    phosh_signal_filter_reset (self->strength_filter);
     on_nm_access_point_strength_changed (self, NULL, self->ap);
+    update_icon_name (self);
 
     ssid = nm_access_point_get_ssid (self->ap);
     self->ssid = nm_utils_ssid_to_utf8 (g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid));
@@ -556,16 +570,19 @@ on_nm_client_ready (GObject *obj, GAsyncResult *res, gpointer data)
 {
   g_autoptr(GError) err = NULL;
   PhoshWifiManager *self;
+  NMClient *nmclient;
 
-  g_return_if_fail (PHOSH_IS_WIFI_MANAGER (data));
-  self = PHOSH_WIFI_MANAGER (data);
-
-  self->nmclient = nm_client_new_finish (res, &err);
-  if (err) {
-    g_warning ("Failed to init NM: %s", err->message);
+  nmclient = phosh_nm_service_get_client_finish (PHOSH_NM_SERVICE (obj), res, &err);
+  if (!nmclient) {
+    if (!g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      g_warning ("Failed to get NM client: %s", err->message);
     return;
   }
 
+  g_return_if_fail (PHOSH_IS_WIFI_MANAGER (data));
+  self = PHOSH_WIFI_MANAGER (data);
+  self->nmclient = nmclient;
+
   g_return_if_fail (NM_IS_CLIENT (self->nmclient));
 
   setup_network_agent (self);
@@ -590,7 +607,18 @@ phosh_wifi_manager_constructed (GObject *object)
 {
   PhoshWifiManager *self = PHOSH_WIFI_MANAGER (object);
 
-  nm_client_new_async (NULL, on_nm_client_ready, self);
+  self->strength_filter = phosh_signal_filter_new (STRENGTH_MIN_INTERVAL_MS);
+  g_signal_connect_object (self->strength_filter,
+                           "notify::level",
+                           G_CALLBACK (update_icon_name),
+                           self,
+                           G_CONNECT_SWAPPED);
+
+  self->cancel = g_cancellable_new ();
+  phosh_nm_service_get_client_async (phosh_nm_service_get_default (),
+                                     self->cancel,
+                                     on_nm_client_ready,
+                                     self);
 
   G_OBJECT_CLASS (phosh_wifi_manager_parent_class)->constructed (object);
 }
@@ -601,6 +629,8 @@ phosh_wifi_manager_dispose (GObject *object)
 {
   PhoshWifiManager *self = PHOSH_WIFI_MANAGER(object);
 
+  g_cancellable_cancel (self->cancel);
+  g_clear_object (&self->cancel);
   g_clear_object (&self->network_agent);
   if (self->nmclient) {
     g_signal_handlers_disconnect_by_data (self->nmclient, self);
@@ -608,6 +638,7 @@ phosh_wifi_manager_dispose (GObject *object)
   }
 
   cleanup_device (self);
+  g_clear_object (&self->strength_filter);
 
   if (self->active) {
     g_signal_handlers_disconnect_by_data (self->active, self);
@@ -10,12 +10,170 @@
 #define G_LOG_DOMAIN "phosh-wwan-iface"
 
 #include "phosh-wwan-iface.h"
+#include "phosh-enums.h"
+
+/**
+ * SECTION:phosh-wwan-iface
+ * @short_description: Interface implemented by the WWAN backends
+ * @Title: PhoshWWan
+ *
+ * Backends don't notify about state changes themselves but call
+ * phosh_wwan_queue_update() whenever they might have changed. All
+ * updates until the next frame are coalesced, compared against the
+ * last published state and only then the changed properties get
+ * notified and #PhoshWWan::changed is emitted once with the mask of
+ * what changed. This keeps modem polls that don't change anything
+ * from reaching the UI.
+ *
+ * The signal quality is additionally passed through a
+ * #PhoshSignalFilter so indicators can use
+ * phosh_wwan_get_signal_level() and only redraw when the displayed
+ * bucket changes.
+ */
+
+#define SIGNAL_MIN_INTERVAL_MS 5000
+
+enum {
+  CHANGED,
+  N_SIGNALS
+};
+static guint signals[N_SIGNALS];
+
+/* The state last published to consumers */
+typedef struct {
+  guint       signal_quality;
+  const char *access_tec;
+  gboolean    unlocked;
+  gboolean    sim;
+  gboolean    present;
+  char       *operator;
+  PhoshSignalLevel signal_level;
+
+  PhoshSignalFilter *filter;
+  gboolean    updating;
+  guint       update_id;
+} PhoshWWanSnapshot;
+
+G_DEFINE_QUARK (phosh-wwan-snapshot, phosh_wwan_snapshot)
 
 G_DEFINE_INTERFACE (PhoshWWan, phosh_wwan, G_TYPE_OBJECT)
 
+
+static void
+snapshot_free (PhoshWWanSnapshot *snapshot)
+{
+  g_clear_handle_id (&snapshot->update_id, g_source_remove);
+  g_clear_object (&snapshot->filter);
+  g_free (snapshot->operator);
+  g_free (snapshot);
+}
+
+
+static PhoshWWanSnapshot *
+get_snapshot (PhoshWWan *self)
+{
+  GQuark quark = phosh_wwan_snapshot_quark ();
+  PhoshWWanSnapshot *snapshot = g_object_get_qdata (G_OBJECT (self), quark);
+
+  if (snapshot == NULL) {
+    snapshot = g_new0 (PhoshWWanSnapshot, 1);
+    snapshot->filter = phosh_signal_filter_new (SIGNAL_MIN_INTERVAL_MS);
+    /* Held back level changes arrive later on */
+    g_signal_connect_swapped (snapshot->filter, "notify::level",
+                              G_CALLBACK (phosh_wwan_queue_update), self);
+    g_object_set_qdata_full (G_OBJECT (self), quark, snapshot,
+                             (GDestroyNotify) snapshot_free);
+  }
+
+  return snapshot;
+}
+
+
+static gboolean
+on_update_idle (PhoshWWan *self)
+{
+  PhoshWWanSnapshot *snapshot = get_snapshot (self);
+  PhoshWWanChanged changed = PHOSH_WWAN_CHANGED_NONE;
+  guint signal_quality = phosh_wwan_get_signal_quality (self);
+  const char *access_tec = phosh_wwan_get_access_tec (self);
+  gboolean unlocked = phosh_wwan_is_unlocked (self);
+  gboolean sim = phosh_wwan_has_sim (self);
+  gboolean present = phosh_wwan_is_present (self);
+  const char *operator = phosh_wwan_get_operator (self);
+
+  snapshot->update_id = 0;
+  snapshot->updating = TRUE;
+
+  g_object_freeze_notify (G_OBJECT (self));
+  if (snapshot->signal_quality != signal_quality) {
+    snapshot->signal_quality = signal_quality;
+    changed |= PHOSH_WWAN_CHANGED_SIGNAL_QUALITY;
+    g_object_notify (G_OBJECT (self), "signal-quality");
+  }
+  if (present != snapshot->present)
+    phosh_signal_filter_reset (snapshot->filter);
+  phosh_signal_filter_update (snapshot->filter, signal_quality);
+  if (snapshot->signal_level != phosh_signal_filter_get_level (snapshot->filter)) {
+    snapshot->signal_level = phosh_signal_filter_get_level (snapshot->filter);
+    changed |= PHOSH_WWAN_CHANGED_SIGNAL_LEVEL;
+  }
+  if (g_strcmp0 (snapshot->access_tec, access_tec)) {
+    /* Backends use static strings */
+    snapshot->access_tec = access_tec;
+    changed |= PHOSH_WWAN_CHANGED_ACCESS_TEC;
+    g_object_notify (G_OBJECT (self), "access-tec");
+  }
+  if (snapshot->unlocked != unlocked) {
+    snapshot->unlocked = unlocked;
+    changed |= PHOSH_WWAN_CHANGED_UNLOCKED;
+    g_object_notify (G_OBJECT (self), "unlocked");
+  }
+  if (snapshot->sim != sim) {
+    snapshot->sim = sim;
+    changed |= PHOSH_WWAN_CHANGED_SIM;
+    g_object_notify (G_OBJECT (self), "sim");
+  }
+  if (snapshot->present != present) {
+    snapshot->present = present;
+    changed |= PHOSH_WWAN_CHANGED_PRESENT;
+    g_object_notify (G_OBJECT (self), "present");
+  }
+  if (g_strcmp0 (snapshot->operator, operator)) {
+    g_free (snapshot->operator);
+    snapshot->operator = g_strdup (operator);
+    changed |= PHOSH_WWAN_CHANGED_OPERATOR;
+    g_object_notify (G_OBJECT (self), "operator");
+  }
+  g_object_thaw_notify (G_OBJECT (self));
+  snapshot->updating = FALSE;
+
+  if (changed) {
+    g_debug ("Modem state changed: 0x%x", changed);
+    g_signal_emit (self, signals[CHANGED], 0, changed);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+
 void
 phosh_wwan_default_init (PhoshWWanInterface *iface)
 {
+  /**
+   * PhoshWWan::changed:
+   * @self: The #PhoshWWan
+   * @changed: The #PhoshWWanChanged mask of what changed
+   *
+   * Emitted once per frame at most when the modem state changed.
+   */
+  signals[CHANGED] = g_signal_new ("changed",
+                                   G_TYPE_FROM_INTERFACE (iface),
+                                   G_SIGNAL_RUN_LAST,
+                                   0, NULL, NULL, NULL,
+                                   G_TYPE_NONE,
+                                   1,
+                                   PHOSH_TYPE_WWAN_CHANGED);
+
   g_object_interface_install_property (
     iface,
     g_param_spec_int ("signal-quality",
@@ -142,3 +300,48 @@ phosh_wwan_get_operator (PhoshWWan *self)
   iface = PHOSH_WWAN_GET_IFACE (self);
   return iface->get_operator (self);
 }
+
+/**
+ * phosh_wwan_get_signal_level:
+ * @self: The #PhoshWWan
+ *
+ * Get the signal quality as a bucket suitable for an icon. Other
+ * than #PhoshWWan:signal-quality it only changes when the quality
+ * moved well past a bucket boundary and at most every few seconds.
+ *
+ * Returns: The filtered signal level
+ */
+PhoshSignalLevel
+phosh_wwan_get_signal_level (PhoshWWan *self)
+{
+  g_return_val_if_fail (PHOSH_IS_WWAN (self), PHOSH_SIGNAL_LEVEL_NONE);
+
+  return get_snapshot (self)->signal_level;
+}
+
+/**
+ * phosh_wwan_queue_update:
+ * @self: The #PhoshWWan
+ *
+ * To be called by implementations whenever the modem state might
+ * have changed. Consumers are notified before the next frame if
+ * anything actually differs from what they saw last.
+ */
+void
+phosh_wwan_queue_update (PhoshWWan *self)
+{
+  PhoshWWanSnapshot *snapshot;
+
+  g_return_if_fail (PHOSH_IS_WWAN (self));
+
+  snapshot = get_snapshot (self);
+  if (snapshot->update_id || snapshot->updating)
+    return;
+
+  /* Run before GDK_PRIORITY_REDRAW so the update makes it into the next frame */
+  snapshot->update_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE + 10,
+                                         (GSourceFunc) on_update_idle,
+                                         self,
+                                         NULL);
+  g_source_set_name_by_id (snapshot->update_id, "[phosh] wwan update");
+}
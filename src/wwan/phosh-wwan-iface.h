@@ -5,10 +5,36 @@
  */
 #pragma once
 
+#include "signal-filter.h"
+
 #include <glib-object.h>
 
 G_BEGIN_DECLS
 
+/**
+ * PhoshWWanChanged:
+ * @PHOSH_WWAN_CHANGED_NONE: Nothing changed
+ * @PHOSH_WWAN_CHANGED_SIGNAL_QUALITY: The signal quality changed
+ * @PHOSH_WWAN_CHANGED_ACCESS_TEC: The access technology changed
+ * @PHOSH_WWAN_CHANGED_UNLOCKED: The SIM's lock state changed
+ * @PHOSH_WWAN_CHANGED_SIM: The SIM was inserted or removed
+ * @PHOSH_WWAN_CHANGED_PRESENT: The modem appeared or went away
+ * @PHOSH_WWAN_CHANGED_OPERATOR: The operator name changed
+ * @PHOSH_WWAN_CHANGED_SIGNAL_LEVEL: The filtered signal level changed
+ *
+ * Which parts of the modem state changed, see #PhoshWWan::changed.
+ */
+typedef enum {
+  PHOSH_WWAN_CHANGED_NONE           = 0,
+  PHOSH_WWAN_CHANGED_SIGNAL_QUALITY = (1 << 0),
+  PHOSH_WWAN_CHANGED_ACCESS_TEC     = (1 << 1),
+  PHOSH_WWAN_CHANGED_UNLOCKED       = (1 << 2),
+  PHOSH_WWAN_CHANGED_SIM            = (1 << 3),
+  PHOSH_WWAN_CHANGED_PRESENT        = (1 << 4),
+  PHOSH_WWAN_CHANGED_OPERATOR       = (1 << 5),
+  PHOSH_WWAN_CHANGED_SIGNAL_LEVEL   = (1 << 6),
+} PhoshWWanChanged;
+
 #define PHOSH_TYPE_WWAN (phosh_wwan_get_type())
 G_DECLARE_INTERFACE (PhoshWWan, phosh_wwan, PHOSH, WWAN, GObject)
 
@@ -30,3 +56,7 @@ gboolean      phosh_wwan_is_unlocked        (PhoshWWan* self);
 gboolean      phosh_wwan_has_sim            (PhoshWWan* self);
 gboolean      phosh_wwan_is_present         (PhoshWWan* self);
 const char   *phosh_wwan_get_operator       (PhoshWWan *self);
+PhoshSignalLevel phosh_wwan_get_signal_level (PhoshWWan *self);
+void          phosh_wwan_queue_update       (PhoshWWan *self);
+
+G_END_DECLS
@@ -105,7 +105,7 @@ phosh_wwan_mm_update_signal_quality (PhoshWWanMM *self)
   v = phosh_mm_dbus_modem_get_signal_quality (self->proxy);
   if (v) {
     g_variant_get (v, "(ub)", &self->signal_quality, NULL);
-    g_object_notify (G_OBJECT (self), "signal-quality");
+    phosh_wwan_queue_update (PHOSH_WWAN (self));
   }
 }
 
@@ -153,7 +153,7 @@ phosh_wwan_mm_update_access_tec (PhoshWWanMM *self)
     self->proxy);
   self->access_tec = phosh_wwan_mm_user_friendly_access_tec (access_tec);
   g_debug ("Access tec is %s", self->access_tec);
-  g_object_notify (G_OBJECT (self), "access-tec");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -171,7 +171,7 @@ phosh_wwan_mm_update_operator (PhoshWWanMM *self)
     g_debug("Operator is '%s'", operator);
     g_free (self->operator);
     self->operator = g_strdup (operator);
-    g_object_notify (G_OBJECT (self), "operator");
+    phosh_wwan_queue_update (PHOSH_WWAN (self));
   }
 }
 
@@ -194,7 +194,7 @@ phosh_wwan_mm_update_lock_status (PhoshWWanMM *self)
                       (state != MM_MODEM_STATE_LOCKED &&
                        state != MM_MODEM_STATE_FAILED));
   g_debug ("SIM is %slocked: (%d %d)", self->unlocked ? "un" : "", state, unlock_required);
-  g_object_notify (G_OBJECT (self), "unlocked");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -209,7 +209,7 @@ phosh_wwan_mm_update_sim_status (PhoshWWanMM *self)
   g_debug ("SIM path %s", sim);
   self->sim = !!g_strcmp0 (sim, "/");
   g_debug ("SIM is %spresent", self->sim ? "" : "not ");
-  g_object_notify (G_OBJECT (self), "sim");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -221,7 +221,7 @@ phosh_wwan_mm_update_present (PhoshWWanMM *self, gboolean present)
   if (self->present != present) {
     g_debug ("Modem is %spresent", present ? "" : "not ");
     self->present = present;
-    g_object_notify (G_OBJECT (self), "present");
+    phosh_wwan_queue_update (PHOSH_WWAN (self));
   }
 }
 
@@ -292,6 +292,9 @@ phosh_wwan_mm_get_property (GObject    *object,
   case PHOSH_WWAN_MM_PROP_SIM:
     g_value_set_boolean (value, self->sim);
     break;
+  case PHOSH_WWAN_MM_PROP_PRESENT:
+    g_value_set_boolean (value, self->present);
+    break;
   case PHOSH_WWAN_MM_PROP_OPERATOR:
     g_value_set_string (value, self->operator);
     break;
@@ -321,19 +324,11 @@ phosh_wwan_mm_destroy_modem (PhoshWWanMM *self)
   phosh_wwan_mm_update_present (self, FALSE);
 
   self->signal_quality = 0;
-  g_object_notify (G_OBJECT (self), "signal-quality");
-
   self->access_tec = NULL;
-  g_object_notify (G_OBJECT (self), "access-tec");
-
   self->unlocked = FALSE;
-  g_object_notify (G_OBJECT (self), "unlocked");
-
   self->sim = FALSE;
-  g_object_notify (G_OBJECT (self), "sim");
-
   g_clear_pointer (&self->operator, g_free);
-  g_object_notify (G_OBJECT (self), "operator");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -69,7 +69,7 @@ phosh_wwan_ofono_update_signal_quality (PhoshWWanOfono *self, GVariant *v)
   g_return_if_fail (v);
 
   self->signal_quality = g_variant_get_byte (v);
-  g_object_notify (G_OBJECT (self), "signal-quality");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -106,7 +106,7 @@ phosh_wwan_ofono_update_access_tec (PhoshWWanOfono *self, GVariant *v)
   self->access_tec = phosh_wwan_ofono_user_friendly_access_tec (access_tec);
 
   g_debug ("Access tec is %s", self->access_tec);
-  g_object_notify (G_OBJECT (self), "access-tec");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -125,7 +125,7 @@ phosh_wwan_ofono_update_operator (PhoshWWanOfono *self, GVariant *v)
     self->operator = g_strdup (operator);
 
     g_debug("Operator is '%s'", self->operator);
-    g_object_notify (G_OBJECT (self), "operator");
+    phosh_wwan_queue_update (PHOSH_WWAN (self));
   }
 }
 
@@ -143,7 +143,7 @@ phosh_wwan_ofono_update_lock_status (PhoshWWanOfono *self, GVariant *v)
   self->locked = !!g_strcmp0 (pin_required, "none");
 
   g_debug ("SIM is %slocked: (%s)", self->locked ? "" : "un", pin_required);
-  g_object_notify (G_OBJECT (self), "unlocked");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -156,7 +156,7 @@ phosh_wwan_ofono_update_sim_status (PhoshWWanOfono *self, GVariant *v)
   self->sim = g_variant_get_boolean (v);
 
   g_debug ("SIM is %spresent", self->sim ? "" : "not ");
-  g_object_notify (G_OBJECT (self), "sim");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -168,7 +168,7 @@ phosh_wwan_ofono_update_present (PhoshWWanOfono *self, gboolean present)
   if (self->present != present) {
     g_debug ("Modem is %spresent", present ? "" : "not ");
     self->present = present;
-    g_object_notify (G_OBJECT (self), "present");
+    phosh_wwan_queue_update (PHOSH_WWAN (self));
   }
 }
 
@@ -259,6 +259,9 @@ phosh_wwan_ofono_get_property (GObject    *object,
   case PHOSH_WWAN_OFONO_PROP_SIM:
     g_value_set_boolean (value, self->sim);
     break;
+  case PHOSH_WWAN_OFONO_PROP_PRESENT:
+    g_value_set_boolean (value, self->present);
+    break;
   case PHOSH_WWAN_OFONO_PROP_OPERATOR:
     g_value_set_string (value, self->operator);
     break;
@@ -290,19 +293,11 @@ phosh_wwan_ofono_destroy_modem (PhoshWWanOfono *self)
   phosh_wwan_ofono_update_present (self, FALSE);
 
   self->signal_quality = 0;
-  g_object_notify (G_OBJECT (self), "signal-quality");
-
   self->access_tec = NULL;
-  g_object_notify (G_OBJECT (self), "access-tec");
-
   self->locked = TRUE;
-  g_object_notify (G_OBJECT (self), "unlocked");
-
   self->sim = FALSE;
-  g_object_notify (G_OBJECT (self), "sim");
-
   g_clear_pointer (&self->operator, g_free);
-  g_object_notify (G_OBJECT (self), "operator");
+  phosh_wwan_queue_update (PHOSH_WWAN (self));
 }
 
 
@@ -88,18 +88,21 @@ phosh_wwan_info_get_property (GObject *object,
 
 
 static const char *
-signal_quality_icon_name (guint quality)
+signal_level_icon_name (PhoshSignalLevel level)
 {
-  if (quality > 80)
+  switch (level) {
+  case PHOSH_SIGNAL_LEVEL_EXCELLENT:
     return "network-cellular-signal-excellent-symbolic";
-  else if (quality > 55)
+  case PHOSH_SIGNAL_LEVEL_GOOD:
     return "network-cellular-signal-good-symbolic";
-  else if (quality > 30)
+  case PHOSH_SIGNAL_LEVEL_OK:
     return "network-cellular-signal-ok-symbolic";
-  else if (quality > 5)
+  case PHOSH_SIGNAL_LEVEL_WEAK:
     return "network-cellular-signal-weak-symbolic";
-  else
+  case PHOSH_SIGNAL_LEVEL_NONE:
+  default:
     return "network-cellular-signal-none-symbolic";
+  }
 }
 
 
@@ -107,7 +110,7 @@ static void
 update_icon_data(PhoshWWanInfo *self, GParamSpec *psepc, PhoshWWan *wwan)
 {
   GtkWidget *access_tec_widget;
-  guint quality;
+  PhoshSignalLevel level;
   const char *icon_name = NULL;
   const char *access_tec;
   gboolean present;
@@ -138,8 +141,8 @@ update_icon_data(PhoshWWanInfo *self, GParamSpec *psepc, PhoshWWan *wwan)
   }
 
   /* Signal quality */
-  quality = phosh_wwan_get_signal_quality (self->wwan);
-  icon_name = signal_quality_icon_name (quality);
+  level = phosh_wwan_get_signal_level (self->wwan);
+  icon_name = signal_level_icon_name (level);
   phosh_status_icon_set_icon_name (PHOSH_STATUS_ICON (self), icon_name);
 
   if (!self->show_detail) {
@@ -173,6 +176,18 @@ update_info (PhoshWWanInfo *self)
   phosh_status_icon_set_info (PHOSH_STATUS_ICON (self), info);
 }
 
+static void
+on_wwan_changed (PhoshWWanInfo *self, PhoshWWanChanged changed, PhoshWWan *wwan)
+{
+  /* The raw signal quality doesn't matter, only the displayed level */
+  if (changed & ~(PHOSH_WWAN_CHANGED_OPERATOR | PHOSH_WWAN_CHANGED_SIGNAL_QUALITY))
+    update_icon_data (self, NULL, wwan);
+
+  if (changed & PHOSH_WWAN_CHANGED_OPERATOR)
+    update_info (self);
+}
+
+
 static gboolean
 on_idle (PhoshWWanInfo *self)
 {
@@ -186,27 +201,15 @@ static void
 phosh_wwan_info_constructed (GObject *object)
 {
   PhoshWWanInfo *self = PHOSH_WWAN_INFO (object);
-  GStrv signals = (char *[]) {"notify::signal-quality",
-                              "notify::access-tec",
-                              "notify::unlocked",
-                              "notify::sim",
-                              "notify::present",
-                              NULL,
-  };
 
   G_OBJECT_CLASS (phosh_wwan_info_parent_class)->constructed (object);
 
   self->wwan = g_object_ref (phosh_shell_get_wwan (phosh_shell_get_default ()));
 
-  for (int i = 0; i < g_strv_length(signals); i++) {
-    g_signal_connect_swapped (self->wwan, signals[i],
-                              G_CALLBACK (update_icon_data),
-                              self);
-  }
-
+  /* One coalesced update per frame instead of one per property */
   g_signal_connect_swapped (self->wwan,
-                            "notify::operator",
-                            G_CALLBACK (update_info),
+                            "changed",
+                            G_CALLBACK (on_wwan_changed),
                             self);
 
   g_idle_add ((GSourceFunc) on_idle, self);
@@ -38,8 +38,18 @@ phosh_shell_get_primary_monitor (PhoshShell *self)
   return NULL;
 }
 
+PhoshProxyRegistry *
+phosh_shell_get_proxy_registry (PhoshShell *self)
+{
+  return NULL;
+}
+
 PhoshToplevelManager*
 phosh_shell_get_toplevel_manager (PhoshShell *self)
 {
-  return g_object_new (PHOSH_TYPE_TOPLEVEL_MANAGER, NULL);
+  /* Shared so tests can emit signals on it */
+  if (toplevel_manager == NULL)
+    toplevel_manager = g_object_new (PHOSH_TYPE_TOPLEVEL_MANAGER, NULL);
+
+  return toplevel_manager;
 }
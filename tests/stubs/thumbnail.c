@@ -12,6 +12,7 @@
 
 enum {
   SIGNAL_READY,
+  SIGNAL_FAILED,
   N_SIGNALS
 };
 static guint signals[N_SIGNALS] = { 0 };
@@ -25,6 +26,11 @@ phosh_thumbnail_class_init (PhoshThumbnailClass *klass)
     "ready",
     G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST, 0, NULL, NULL,
     NULL, G_TYPE_NONE, 0);
+  /* Stands in for PhoshToplevelThumbnail::failed */
+  signals[SIGNAL_FAILED] = g_signal_new (
+    "failed",
+    G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST, 0, NULL, NULL,
+    NULL, G_TYPE_NONE, 0);
 }
 
 static void
@@ -14,15 +14,77 @@ enum {
 };
 static guint signals[N_SIGNALS] = { 0 };
 
+enum {
+  PROP_0,
+  PROP_HANDLE,
+  PROP_MAXIMIZED,
+  PROP_LAST_PROP,
+};
+static GParamSpec *props[PROP_LAST_PROP];
+
 struct _PhoshToplevel {
   GObject parent;
+  gpointer handle;
 };
 
 G_DEFINE_TYPE (PhoshToplevel, phosh_toplevel, G_TYPE_OBJECT);
 
+static void
+phosh_toplevel_set_property (GObject      *object,
+                             guint         property_id,
+                             const GValue *value,
+                             GParamSpec   *pspec)
+{
+  PhoshToplevel *self = PHOSH_TOPLEVEL (object);
+
+  switch (property_id) {
+  case PROP_HANDLE:
+    self->handle = g_value_get_pointer (value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+static void
+phosh_toplevel_get_property (GObject    *object,
+                             guint       property_id,
+                             GValue     *value,
+                             GParamSpec *pspec)
+{
+  PhoshToplevel *self = PHOSH_TOPLEVEL (object);
+
+  switch (property_id) {
+  case PROP_HANDLE:
+    g_value_set_pointer (value, self->handle);
+    break;
+  case PROP_MAXIMIZED:
+    g_value_set_boolean (value, FALSE);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
 static void
 phosh_toplevel_class_init (PhoshToplevelClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->set_property = phosh_toplevel_set_property;
+  object_class->get_property = phosh_toplevel_get_property;
+
+  props[PROP_HANDLE] =
+    g_param_spec_pointer ("handle", "handle", "The toplevel's handle",
+                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+  props[PROP_MAXIMIZED] =
+    g_param_spec_boolean ("maximized", "maximized", "Whether the toplevel is maximized",
+                          FALSE,
+                          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+  g_object_class_install_properties (object_class, PROP_LAST_PROP, props);
+
   signals[SIGNAL_CLOSED] = g_signal_new (
     "closed",
     G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST, 0, NULL, NULL,
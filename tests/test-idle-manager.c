@@ -120,6 +120,121 @@ test_phosh_idle_remove_watch(void)
 }
 
 
+static void
+test_phosh_idle_shared_watch(void)
+{
+  GError *err = NULL;
+  PhoshIdleDbusIdleMonitor *proxy;
+  PhoshIdleDbusObjectManagerClient *client;
+  GDBusObject *object;
+  guint id1, id2;
+  guint64 idletime;
+
+  if (!g_test_slow()) {
+    g_test_skip ("Skipping thorough test");
+    return;
+  }
+
+  client = PHOSH_IDLE_DBUS_OBJECT_MANAGER_CLIENT (
+    phosh_idle_dbus_object_manager_client_new_for_bus_sync(
+      G_BUS_TYPE_SESSION,
+      G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_NONE,
+      BUS_NAME,
+      PATH,
+      NULL,
+      &err));
+  g_assert (client);
+
+  object = g_dbus_object_manager_get_object (G_DBUS_OBJECT_MANAGER (client),
+                                             OBJECT_PATH);
+  g_assert (object);
+
+  proxy = phosh_idle_dbus_object_get_idle_monitor (PHOSH_IDLE_DBUS_OBJECT (object));
+  g_assert (proxy);
+
+  /* Watches with the same interval still get distinct ids */
+  g_assert (phosh_idle_dbus_idle_monitor_call_add_idle_watch_sync (
+              proxy, fire, &id1, NULL, NULL));
+  g_assert (phosh_idle_dbus_idle_monitor_call_add_idle_watch_sync (
+              proxy, fire, &id2, NULL, NULL));
+  g_assert (id1);
+  g_assert (id2);
+  g_assert_cmpint (id1, !=, id2);
+
+  g_assert (phosh_idle_dbus_idle_monitor_call_get_idletime_sync (
+              proxy, &idletime, NULL, NULL));
+
+  /* Removing one watch keeps the other one */
+  g_assert (phosh_idle_dbus_idle_monitor_call_remove_watch_sync (
+              proxy, id1, NULL, NULL));
+  watch_id = id2;
+  g_signal_connect_object (proxy, "watch-fired", G_CALLBACK (watch_fired_cb), NULL, 0);
+  loop = g_main_loop_new (NULL, FALSE);
+  g_main_loop_run (loop);
+  g_assert (phosh_idle_dbus_idle_monitor_call_remove_watch_sync (
+              proxy, id2, NULL, NULL));
+}
+
+
+static void
+test_phosh_idle_add_watch_while_idle(void)
+{
+  GError *err = NULL;
+  PhoshIdleDbusIdleMonitor *proxy;
+  PhoshIdleDbusObjectManagerClient *client;
+  GDBusObject *object;
+  guint id1;
+  int timeout_id;
+
+  if (!g_test_slow()) {
+    g_test_skip ("Skipping thorough test");
+    return;
+  }
+
+  client = PHOSH_IDLE_DBUS_OBJECT_MANAGER_CLIENT (
+    phosh_idle_dbus_object_manager_client_new_for_bus_sync(
+      G_BUS_TYPE_SESSION,
+      G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_NONE,
+      BUS_NAME,
+      PATH,
+      NULL,
+      &err));
+  g_assert (client);
+
+  object = g_dbus_object_manager_get_object (G_DBUS_OBJECT_MANAGER (client),
+                                             OBJECT_PATH);
+  g_assert (object);
+
+  proxy = phosh_idle_dbus_object_get_idle_monitor (PHOSH_IDLE_DBUS_OBJECT (object));
+  g_assert (proxy);
+
+  g_signal_connect_object (proxy, "watch-fired", G_CALLBACK (watch_fired_cb), NULL, 0);
+  loop = g_main_loop_new (NULL, FALSE);
+
+  /* Let the shared timer go idle */
+  g_assert (phosh_idle_dbus_idle_monitor_call_add_idle_watch_sync (
+              proxy, fire, &id1, NULL, NULL));
+  watch_id = id1;
+  timeout_id = g_timeout_add_seconds (fire * 2 / 1000, timeout_cb, NULL);
+  g_main_loop_run (loop);
+  g_source_remove (timeout_id);
+
+  /* A watch joining the idle timer fires without waiting for another
+     idle cycle */
+  g_assert (phosh_idle_dbus_idle_monitor_call_add_idle_watch_sync (
+              proxy, fire, &watch_id, NULL, NULL));
+  g_assert_cmpint (watch_id, !=, id1);
+  timeout_id = g_timeout_add (fire / 2, timeout_cb, NULL);
+  g_main_loop_run (loop);
+  g_source_remove (timeout_id);
+
+  g_assert (phosh_idle_dbus_idle_monitor_call_remove_watch_sync (
+              proxy, id1, NULL, NULL));
+  g_assert (phosh_idle_dbus_idle_monitor_call_remove_watch_sync (
+              proxy, watch_id, NULL, NULL));
+}
+
+
 int
 main (int   argc,
       char *argv[])
@@ -128,5 +243,7 @@ main (int   argc,
 
   g_test_add_func("/phosh/idle/idle", test_phosh_idle_add_watch);
   g_test_add_func("/phosh/idle/remove", test_phosh_idle_remove_watch);
+  g_test_add_func("/phosh/idle/shared", test_phosh_idle_shared_watch);
+  g_test_add_func("/phosh/idle/add-while-idle", test_phosh_idle_add_watch_while_idle);
   return g_test_run();
 }
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "image-loader.h"
+
+#include <glib/gstdio.h>
+
+/* Matches the loader's placeholder */
+#define IMAGE_LOADER_PLACEHOLDER "image-loading-symbolic"
+
+typedef struct {
+  GMainLoop *mainloop;
+  GdkPixbuf *pixbuf;
+  char      *dir;
+  char      *path;
+  char      *uri;
+} TestFixture;
+
+
+static void
+write_image (TestFixture *fixture, int width, int height)
+{
+  g_autoptr (GdkPixbuf) pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, width, height);
+  g_autoptr (GError) err = NULL;
+
+  gdk_pixbuf_fill (pixbuf, 0xff0000ff);
+  gdk_pixbuf_save (pixbuf, fixture->path, "png", &err, NULL);
+  g_assert_no_error (err);
+}
+
+
+/* Make the file's mtime differ regardless of the file system's
+ * timestamp granularity */
+static void
+bump_mtime (TestFixture *fixture)
+{
+  g_autoptr (GFile) file = g_file_new_for_path (fixture->path);
+  g_autoptr (GFileInfo) info = NULL;
+  g_autoptr (GError) err = NULL;
+  guint64 mtime;
+
+  info = g_file_query_info (file, G_FILE_ATTRIBUTE_TIME_MODIFIED, G_FILE_QUERY_INFO_NONE,
+                            NULL, &err);
+  g_assert_no_error (err);
+  mtime = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+
+  g_file_set_attribute_uint64 (file, G_FILE_ATTRIBUTE_TIME_MODIFIED, mtime + 1,
+                               G_FILE_QUERY_INFO_NONE, NULL, &err);
+  g_assert_no_error (err);
+}
+
+
+static void
+fixture_setup (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GError) err = NULL;
+
+  fixture->mainloop = g_main_loop_new (NULL, FALSE);
+  fixture->dir = g_dir_make_tmp ("phosh-image-loader-XXXXXX", &err);
+  g_assert_no_error (err);
+  fixture->path = g_build_filename (fixture->dir, "image.png", NULL);
+  fixture->uri = g_filename_to_uri (fixture->path, NULL, NULL);
+  write_image (fixture, 256, 128);
+}
+
+
+static void
+fixture_teardown (TestFixture *fixture, gconstpointer unused)
+{
+  g_unlink (fixture->path);
+  g_rmdir (fixture->dir);
+  g_clear_object (&fixture->pixbuf);
+  g_clear_pointer (&fixture->uri, g_free);
+  g_clear_pointer (&fixture->path, g_free);
+  g_clear_pointer (&fixture->dir, g_free);
+  g_clear_pointer (&fixture->mainloop, g_main_loop_unref);
+}
+
+
+static void
+on_loaded (GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  TestFixture *fixture = user_data;
+  g_autoptr (GError) err = NULL;
+
+  g_clear_object (&fixture->pixbuf);
+  fixture->pixbuf = phosh_image_loader_load_finish (PHOSH_IMAGE_LOADER (source), res, &err);
+  g_assert_no_error (err);
+  g_main_loop_quit (fixture->mainloop);
+}
+
+
+static void
+load (TestFixture *fixture, int size)
+{
+  phosh_image_loader_load_async (phosh_image_loader_get_default (),
+                                 fixture->uri, size, NULL, on_loaded, fixture);
+  g_main_loop_run (fixture->mainloop);
+}
+
+
+static void
+test_phosh_image_loader_load (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GdkPixbuf) cached = NULL;
+  GdkPixbuf *first;
+
+  g_assert_null (phosh_image_loader_lookup (phosh_image_loader_get_default (), fixture->uri, 32));
+
+  load (fixture, 32);
+  g_assert_true (GDK_IS_PIXBUF (fixture->pixbuf));
+  /* Downscaled keeping the aspect ratio */
+  g_assert_cmpint (gdk_pixbuf_get_width (fixture->pixbuf), ==, 32);
+  g_assert_cmpint (gdk_pixbuf_get_height (fixture->pixbuf), ==, 16);
+
+  cached = phosh_image_loader_lookup (phosh_image_loader_get_default (), fixture->uri, 32);
+  g_assert_true (cached == fixture->pixbuf);
+
+  /* Unchanged file is served from the cache */
+  first = g_object_ref (fixture->pixbuf);
+  load (fixture, 32);
+  g_assert_true (first == fixture->pixbuf);
+  g_object_unref (first);
+
+  /* Changed file gets reloaded */
+  write_image (fixture, 128, 128);
+  bump_mtime (fixture);
+  load (fixture, 32);
+  g_assert_cmpint (gdk_pixbuf_get_width (fixture->pixbuf), ==, 32);
+  g_assert_cmpint (gdk_pixbuf_get_height (fixture->pixbuf), ==, 32);
+}
+
+
+static void
+test_phosh_image_loader_data_uri (TestFixture *fixture, gconstpointer unused)
+{
+  g_autofree char *contents = NULL;
+  g_autofree char *encoded = NULL;
+  g_autofree char *data_uri = NULL;
+  g_autoptr (GdkPixbuf) cached = NULL;
+  g_autoptr (GError) err = NULL;
+  gsize len;
+
+  g_file_get_contents (fixture->path, &contents, &len, &err);
+  g_assert_no_error (err);
+  encoded = g_base64_encode ((guchar *)contents, len);
+  data_uri = g_strdup_printf ("data:image/png;base64,%s", encoded);
+
+  g_free (fixture->uri);
+  fixture->uri = g_strdup (data_uri);
+  load (fixture, 64);
+  g_assert_true (GDK_IS_PIXBUF (fixture->pixbuf));
+  g_assert_cmpint (gdk_pixbuf_get_width (fixture->pixbuf), ==, 64);
+  g_assert_cmpint (gdk_pixbuf_get_height (fixture->pixbuf), ==, 32);
+
+  cached = phosh_image_loader_lookup (phosh_image_loader_get_default (), data_uri, 64);
+  g_assert_true (cached == fixture->pixbuf);
+}
+
+
+static void
+test_phosh_image_loader_get_icon (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GIcon) themed = g_themed_icon_new ("does-not-matter");
+  g_autoptr (GFile) file = g_file_new_for_uri (fixture->uri);
+  g_autoptr (GIcon) file_icon = g_file_icon_new (file);
+  g_autoptr (GIcon) icon = NULL;
+  GtkWidget *image;
+  GIcon *shown = NULL;
+
+  image = g_object_ref_sink (gtk_image_new ());
+  gtk_image_set_pixel_size (GTK_IMAGE (image), 24);
+
+  icon = phosh_image_loader_get_icon (phosh_image_loader_get_default (), themed, GTK_IMAGE (image));
+  g_assert_true (icon == themed);
+  g_clear_object (&icon);
+
+  /* File icons get a placeholder and are loaded async */
+  icon = phosh_image_loader_get_icon (phosh_image_loader_get_default (), file_icon, GTK_IMAGE (image));
+  g_assert_true (G_IS_THEMED_ICON (icon));
+  g_object_set (image, "gicon", icon, NULL);
+
+  /* Wait until the placeholder got replaced, on errors that's the missing icon */
+  while (TRUE) {
+    gtk_image_get_gicon (GTK_IMAGE (image), &shown, NULL);
+    if (GDK_IS_PIXBUF (shown))
+      break;
+    if (G_IS_THEMED_ICON (shown) &&
+        g_strcmp0 (g_themed_icon_get_names (G_THEMED_ICON (shown))[0], IMAGE_LOADER_PLACEHOLDER))
+      break;
+    g_main_context_iteration (NULL, TRUE);
+  }
+  g_assert_true (GDK_IS_PIXBUF (shown));
+  g_assert_cmpint (gdk_pixbuf_get_width (GDK_PIXBUF (shown)), ==, 24);
+
+  g_object_unref (image);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add ("/phosh/image-loader/load",
+              TestFixture,
+              NULL,
+              fixture_setup,
+              test_phosh_image_loader_load,
+              fixture_teardown);
+  g_test_add ("/phosh/image-loader/data-uri",
+              TestFixture,
+              NULL,
+              fixture_setup,
+              test_phosh_image_loader_data_uri,
+              fixture_teardown);
+  g_test_add ("/phosh/image-loader/get-icon",
+              TestFixture,
+              NULL,
+              fixture_setup,
+              test_phosh_image_loader_get_icon,
+              fixture_teardown);
+
+  return g_test_run ();
+}
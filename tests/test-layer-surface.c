@@ -40,6 +40,32 @@ on_layer_surface_notify (PhoshLayerSurface *surface,
   (*count)++;
 }
 
+static void
+on_frame_done (void *data, struct wl_callback *callback, uint32_t time)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+  wl_callback_destroy (callback);
+}
+
+static const struct wl_callback_listener frame_listener = {
+  on_frame_done,
+};
+
+/* A frame callback only becomes active with the next commit */
+static void
+add_frame_callback (GtkWidget *surface, gboolean *done)
+{
+  struct wl_surface *wl_surface;
+  struct wl_callback *callback;
+
+  *done = FALSE;
+  wl_surface = gdk_wayland_window_get_wl_surface (gtk_widget_get_window (surface));
+  callback = wl_surface_frame (wl_surface);
+  wl_callback_add_listener (callback, &frame_listener, done);
+}
+
 static void
 test_layer_surface_new (Fixture *fixture, gconstpointer unused)
 {
@@ -175,6 +201,87 @@ test_layer_surface_set_kbd_interactivity (Fixture *fixture, gconstpointer unused
 }
 
 
+static void
+test_layer_surface_transaction (Fixture *fixture, gconstpointer unused)
+{
+  guint count = 0;
+  int margin, zone;
+  gboolean frame_done;
+  g_autofree char *namespace = g_strdup_printf ("phosh test %s", __func__);
+
+  GtkWidget *surface = g_object_new (PHOSH_TYPE_LAYER_SURFACE,
+                                     "layer-shell", phosh_wayland_get_zwlr_layer_shell_v1(fixture->state->wl),
+                                     "wl-output", fixture->state->output,
+                                     "height", 10,
+                                     "anchor", ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM,
+                                     "layer", ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY,
+                                     "kbd-interactivity", FALSE,
+                                     "exclusive-zone", -1,
+                                     "namespace", namespace,
+                                     NULL);
+
+  g_assert_true (PHOSH_IS_LAYER_SURFACE (surface));
+  gtk_widget_show (surface);
+
+  g_signal_connect (surface,
+                    "notify::margin-bottom",
+                    G_CALLBACK (on_layer_surface_notify),
+                    &count);
+
+  /* Nested transactions */
+  phosh_layer_surface_begin (PHOSH_LAYER_SURFACE (surface));
+  phosh_layer_surface_begin (PHOSH_LAYER_SURFACE (surface));
+  phosh_layer_surface_set_margins (PHOSH_LAYER_SURFACE (surface), 0, 0, -5, 0);
+  phosh_layer_surface_set_exclusive_zone (PHOSH_LAYER_SURFACE (surface), 15);
+  phosh_layer_surface_commit (PHOSH_LAYER_SURFACE (surface));
+  phosh_layer_surface_set_kbd_interactivity (PHOSH_LAYER_SURFACE (surface), TRUE);
+  phosh_layer_surface_commit (PHOSH_LAYER_SURFACE (surface));
+
+  g_object_get (surface, "margin-bottom", &margin, "exclusive-zone", &zone, NULL);
+  g_assert_cmpint (margin, ==, -5);
+  g_assert_cmpint (zone, ==, 15);
+  g_assert_cmpint (count, ==, 1);
+
+  /* Let all pending frames go out */
+  phosh_wayland_roundtrip (fixture->state->wl);
+  while (g_main_context_iteration (NULL, FALSE));
+  add_frame_callback (surface, &frame_done);
+
+  /* Empty transaction */
+  phosh_layer_surface_begin (PHOSH_LAYER_SURFACE (surface));
+  phosh_layer_surface_set_margins (PHOSH_LAYER_SURFACE (surface), 0, 0, -5, 0);
+  phosh_layer_surface_commit (PHOSH_LAYER_SURFACE (surface));
+  g_assert_cmpint (count, ==, 1);
+
+  /* …doesn't commit the surface */
+  phosh_wayland_roundtrip (fixture->state->wl);
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_false (frame_done);
+
+  /* A transaction that changes state does */
+  phosh_layer_surface_begin (PHOSH_LAYER_SURFACE (surface));
+  phosh_layer_surface_set_margins (PHOSH_LAYER_SURFACE (surface), 0, 0, -3, 0);
+  phosh_layer_surface_commit (PHOSH_LAYER_SURFACE (surface));
+  g_assert_cmpint (count, ==, 2);
+  while (!frame_done)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* State changes go out with the next frame when the content moved */
+  add_frame_callback (surface, &frame_done);
+  phosh_layer_surface_begin (PHOSH_LAYER_SURFACE (surface));
+  phosh_layer_surface_set_margins (PHOSH_LAYER_SURFACE (surface), 0, 0, 0, 0);
+  phosh_layer_surface_set_content_offset (PHOSH_LAYER_SURFACE (surface), 0, 5);
+  phosh_layer_surface_commit (PHOSH_LAYER_SURFACE (surface));
+  g_assert_cmpint (count, ==, 3);
+  while (!frame_done)
+    g_main_context_iteration (NULL, TRUE);
+  phosh_layer_surface_set_content_offset (PHOSH_LAYER_SURFACE (surface), 0, 0);
+
+  phosh_wayland_roundtrip (fixture->state->wl);
+  gtk_widget_destroy (surface);
+}
+
+
 int
 main (int   argc,
       char *argv[])
@@ -189,6 +296,8 @@ main (int   argc,
               compositor_setup, test_layer_surface_set_size, compositor_teardown);
   g_test_add ("/phosh/layer-surface/set_kbd_interactivity", Fixture, NULL,
               compositor_setup, test_layer_surface_set_kbd_interactivity, compositor_teardown);
+  g_test_add ("/phosh/layer-surface/transaction", Fixture, NULL,
+              compositor_setup, test_layer_surface_transaction, compositor_teardown);
 
   return g_test_run ();
 }
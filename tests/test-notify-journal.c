@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "notifications/notify-journal.h"
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib/gstdio.h>
+
+
+typedef struct {
+  GMainLoop *loop;
+  char      *dir;
+  char      *path;
+  GPtrArray *entries;
+  guint      next_id;
+} TestFixture;
+
+
+static void
+fixture_setup (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (GError) err = NULL;
+
+  fixture->loop = g_main_loop_new (NULL, FALSE);
+  fixture->dir = g_dir_make_tmp ("phosh-notify-journal-XXXXXX", &err);
+  g_assert_no_error (err);
+  fixture->path = g_build_filename (fixture->dir, "notifications.journal", NULL);
+}
+
+
+static void
+fixture_teardown (TestFixture *fixture, gconstpointer unused)
+{
+  g_unlink (fixture->path);
+  g_rmdir (fixture->dir);
+  g_clear_pointer (&fixture->entries, g_ptr_array_unref);
+  g_clear_pointer (&fixture->path, g_free);
+  g_clear_pointer (&fixture->dir, g_free);
+  g_clear_pointer (&fixture->loop, g_main_loop_unref);
+}
+
+
+static void
+on_loaded (GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  TestFixture *fixture = user_data;
+  g_autoptr (GError) err = NULL;
+
+  g_clear_pointer (&fixture->entries, g_ptr_array_unref);
+  fixture->entries = phosh_notify_journal_load_finish (PHOSH_NOTIFY_JOURNAL (source), res,
+                                                       &fixture->next_id, &err);
+  g_assert_no_error (err);
+  g_main_loop_quit (fixture->loop);
+}
+
+
+static PhoshNotifyJournal *
+load (TestFixture *fixture)
+{
+  PhoshNotifyJournal *journal = phosh_notify_journal_new (fixture->path);
+
+  phosh_notify_journal_load_async (journal, NULL, on_loaded, fixture);
+  g_main_loop_run (fixture->loop);
+
+  return journal;
+}
+
+
+static PhoshNotification *
+new_notification (guint id, const char *summary, GIcon *image)
+{
+  g_autoptr (GDateTime) now = g_date_time_new_now_local ();
+  GStrv actions = (char *[]) { "default", "Open", NULL };
+
+  return phosh_notification_new (id,
+                                 "Journal Test",
+                                 NULL,
+                                 summary,
+                                 "Body",
+                                 NULL,
+                                 image,
+                                 PHOSH_NOTIFICATION_URGENCY_NORMAL,
+                                 actions,
+                                 FALSE,
+                                 TRUE,
+                                 "im.received",
+                                 now);
+}
+
+
+static void
+test_phosh_notify_journal_restore (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshNotifyJournal) journal = NULL;
+  g_autoptr (PhoshNotification) noti1 = NULL;
+  g_autoptr (PhoshNotification) noti2 = NULL;
+  g_autoptr (PhoshNotification) noti3 = NULL;
+  g_autoptr (GdkPixbuf) image = NULL;
+  g_autoptr (GdkPixbuf) restored_pixbuf = NULL;
+  g_autoptr (GInputStream) stream = NULL;
+  g_autoptr (GError) err = NULL;
+  PhoshNotifyJournalEntry *entry;
+  GIcon *restored_image;
+
+  journal = load (fixture);
+  g_assert_cmpint (fixture->entries->len, ==, 0);
+  g_assert_cmpint (fixture->next_id, ==, 0);
+
+  image = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, 512, 256);
+  gdk_pixbuf_fill (image, 0x00ff00ff);
+
+  noti1 = new_notification (1, "First", NULL);
+  noti2 = new_notification (2, "Second", G_ICON (image));
+  noti3 = new_notification (3, "Third", NULL);
+  phosh_notify_journal_add (journal, "source-a", noti1, 2);
+  phosh_notify_journal_add (journal, "source-b", noti2, 3);
+  phosh_notify_journal_add (journal, "source-a", noti3, 4);
+  phosh_notify_journal_remove (journal, 1);
+  phosh_notify_journal_remove (journal, 3);
+  phosh_notification_set_summary (noti2, "Second, updated");
+  phosh_notify_journal_add (journal, "source-b", noti2, 4);
+  /* Flushes pending writes */
+  g_clear_object (&journal);
+
+  journal = load (fixture);
+  g_assert_cmpint (fixture->next_id, ==, 4);
+  g_assert_cmpint (fixture->entries->len, ==, 1);
+
+  entry = g_ptr_array_index (fixture->entries, 0);
+  g_assert_cmpstr (entry->source_id, ==, "source-b");
+  g_assert_cmpint (phosh_notification_get_id (entry->notification), ==, 2);
+  g_assert_cmpstr (phosh_notification_get_summary (entry->notification), ==, "Second, updated");
+  g_assert_cmpstr (phosh_notification_get_body (entry->notification), ==, "Body");
+  g_assert_cmpstr (phosh_notification_get_category (entry->notification), ==, "im.received");
+  g_assert_true (phosh_notification_get_resident (entry->notification));
+  g_assert_cmpstr (phosh_notification_get_actions (entry->notification)[1], ==, "Open");
+
+  /* Images are stored downscaled */
+  restored_image = phosh_notification_get_image (entry->notification);
+  g_assert_nonnull (restored_image);
+  g_assert_true (G_IS_LOADABLE_ICON (restored_image));
+  stream = g_loadable_icon_load (G_LOADABLE_ICON (restored_image), -1, NULL, NULL, &err);
+  g_assert_no_error (err);
+  restored_pixbuf = gdk_pixbuf_new_from_stream (stream, NULL, &err);
+  g_assert_no_error (err);
+  g_assert_cmpint (gdk_pixbuf_get_width (restored_pixbuf), ==, 64);
+  g_assert_cmpint (gdk_pixbuf_get_height (restored_pixbuf), ==, 32);
+
+  /* Removing everything keeps the next id */
+  phosh_notify_journal_remove (journal, 2);
+  g_clear_object (&journal);
+  journal = load (fixture);
+  g_assert_cmpint (fixture->entries->len, ==, 0);
+  g_assert_cmpint (fixture->next_id, ==, 4);
+}
+
+
+static void
+test_phosh_notify_journal_truncated (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshNotifyJournal) journal = NULL;
+  g_autoptr (PhoshNotification) noti = NULL;
+  g_autofree char *contents = NULL;
+  g_autoptr (GError) err = NULL;
+  gsize len;
+
+  journal = load (fixture);
+  noti = new_notification (7, "Seven", NULL);
+  phosh_notify_journal_add (journal, "source", noti, 8);
+  phosh_notify_journal_add (journal, "source", noti, 8);
+  g_clear_object (&journal);
+
+  /* Simulate a torn write of the last record */
+  g_file_get_contents (fixture->path, &contents, &len, &err);
+  g_assert_no_error (err);
+  g_file_set_contents (fixture->path, contents, len - 5, &err);
+  g_assert_no_error (err);
+
+  journal = load (fixture);
+  g_assert_cmpint (fixture->entries->len, ==, 1);
+  g_assert_cmpint (fixture->next_id, ==, 8);
+}
+
+
+static void
+test_phosh_notify_journal_private (TestFixture *fixture, gconstpointer unused)
+{
+  g_autoptr (PhoshNotifyJournal) journal = NULL;
+  g_autoptr (PhoshNotification) noti1 = NULL;
+  g_autoptr (PhoshNotification) noti2 = NULL;
+  g_autoptr (PhoshNotification) noti3 = NULL;
+  PhoshNotifyJournalEntry *entry;
+  GStatBuf buf;
+
+  journal = load (fixture);
+  noti1 = new_notification (1, "Kept", NULL);
+  noti2 = new_notification (2, "Transient", NULL);
+  phosh_notification_set_transient (noti2, TRUE);
+  noti3 = new_notification (3, "Sensitive", NULL);
+  phosh_notify_journal_add (journal, "source", noti1, 2);
+  phosh_notify_journal_add (journal, "source", noti2, 3);
+  phosh_notify_journal_add (journal, "source", noti3, 4);
+  /* An update making the notification sensitive drops the stored one */
+  phosh_notification_set_category (noti3, "x-phosh.sensitive");
+  phosh_notify_journal_add (journal, "source", noti3, 4);
+  g_clear_object (&journal);
+
+  g_assert_cmpint (g_stat (fixture->path, &buf), ==, 0);
+  g_assert_cmpint (buf.st_mode & 0777, ==, 0600);
+
+  journal = load (fixture);
+  g_assert_cmpint (fixture->entries->len, ==, 1);
+  entry = g_ptr_array_index (fixture->entries, 0);
+  g_assert_cmpstr (phosh_notification_get_summary (entry->notification), ==, "Kept");
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add ("/phosh/notify-journal/restore",
+              TestFixture,
+              NULL,
+              fixture_setup,
+              test_phosh_notify_journal_restore,
+              fixture_teardown);
+  g_test_add ("/phosh/notify-journal/private",
+              TestFixture,
+              NULL,
+              fixture_setup,
+              test_phosh_notify_journal_private,
+              fixture_teardown);
+  g_test_add ("/phosh/notify-journal/truncated",
+              TestFixture,
+              NULL,
+              fixture_setup,
+              test_phosh_notify_journal_truncated,
+              fixture_teardown);
+
+  return g_test_run ();
+}
@@ -6,7 +6,10 @@
  * Author: Guido Günther <agx@sigxcpu.org>
  */
 
+#include "activity.h"
 #include "overview.h"
+#include "shell.h"
+#include "toplevel-manager.h"
 
 #define HANDY_USE_UNSTABLE_API
 #include <handy.h>
@@ -20,6 +23,114 @@ test_phosh_overview_new(void)
 }
 
 
+static void
+find_carousel (GtkWidget *widget, gpointer data)
+{
+  GtkWidget **carousel = data;
+
+  if (*carousel)
+    return;
+
+  if (HDY_IS_CAROUSEL (widget))
+    *carousel = widget;
+  else if (GTK_IS_CONTAINER (widget))
+    gtk_container_forall (GTK_CONTAINER (widget), find_carousel, data);
+}
+
+
+static PhoshActivity *
+get_slot_activity (GtkWidget *slot)
+{
+  g_autoptr (GList) children = gtk_container_get_children (GTK_CONTAINER (slot));
+
+  if (children == NULL)
+    return NULL;
+
+  g_assert_true (PHOSH_IS_ACTIVITY (children->data));
+  return children->data;
+}
+
+
+static void
+drain (void)
+{
+  while (gtk_events_pending ())
+    gtk_main_iteration ();
+}
+
+
+static void
+test_phosh_overview_recycle (void)
+{
+  PhoshToplevelManager *manager = phosh_shell_get_toplevel_manager (NULL);
+  g_autoptr (GPtrArray) toplevels = g_ptr_array_new_with_free_func (g_object_unref);
+  g_autoptr (GHashTable) seen = g_hash_table_new (NULL, NULL);
+  g_autoptr (GList) slots = NULL;
+  GtkWidget *window, *overview, *carousel = NULL;
+  GList *l;
+  int i;
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_default_size (GTK_WINDOW (window), 360, 720);
+  overview = phosh_overview_new ();
+  gtk_container_add (GTK_CONTAINER (window), overview);
+
+  for (i = 0; i < 20; i++) {
+    PhoshToplevel *toplevel = phosh_toplevel_new_from_handle (NULL);
+
+    g_ptr_array_add (toplevels, toplevel);
+    g_signal_emit_by_name (manager, "toplevel-added", toplevel);
+  }
+
+  find_carousel (overview, &carousel);
+  g_assert_nonnull (carousel);
+  gtk_widget_show (carousel);
+  gtk_widget_show_all (window);
+  drain ();
+
+  /* Only the pages around the first one have activities */
+  g_assert_cmpint (hdy_carousel_get_n_pages (HDY_CAROUSEL (carousel)), ==, 20);
+  slots = gtk_container_get_children (GTK_CONTAINER (carousel));
+  for (l = slots, i = 0; l; l = l->next, i++) {
+    PhoshActivity *activity = get_slot_activity (l->data);
+
+    if (i <= 1) {
+      g_assert_nonnull (activity);
+      g_hash_table_add (seen, activity);
+    } else {
+      g_assert_null (activity);
+    }
+  }
+
+  /* Moving the carousel attaches the pages around the new position… */
+  hdy_carousel_scroll_to_full (HDY_CAROUSEL (carousel), g_list_nth_data (slots, 10), 0);
+  drain ();
+  g_assert_cmpfloat (hdy_carousel_get_position (HDY_CAROUSEL (carousel)), ==, 10.0);
+
+  for (l = slots, i = 0; l; l = l->next, i++) {
+    PhoshActivity *activity = get_slot_activity (l->data);
+
+    if (i >= 9 && i <= 11) {
+      g_assert_nonnull (activity);
+      g_assert_true (phosh_activity_get_app_id (activity) != NULL);
+    } else {
+      g_assert_null (activity);
+    }
+  }
+
+  /* …reusing the activities of pages that moved out of range */
+  for (l = slots, i = 0; l; l = l->next, i++) {
+    PhoshActivity *activity = get_slot_activity (l->data);
+
+    if (activity)
+      g_hash_table_remove (seen, activity);
+  }
+  g_assert_cmpint (g_hash_table_size (seen), ==, 0);
+
+  gtk_widget_destroy (window);
+}
+
+
 int
 main (int   argc,
       char *argv[])
@@ -28,5 +139,6 @@ main (int   argc,
   hdy_init ();
 
   g_test_add_func("/phosh/overview/new", test_phosh_overview_new);
+  g_test_add_func("/phosh/overview/recycle", test_phosh_overview_recycle);
   return g_test_run();
 }
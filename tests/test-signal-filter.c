@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "signal-filter.h"
+
+
+static void
+on_level_changed (PhoshSignalFilter *filter, GParamSpec *pspec, guint *count)
+{
+  (*count)++;
+}
+
+
+static void
+test_phosh_signal_filter_hysteresis (void)
+{
+  g_autoptr (PhoshSignalFilter) filter = phosh_signal_filter_new (0);
+  guint count = 0;
+
+  g_signal_connect (filter, "notify::level", G_CALLBACK (on_level_changed), &count);
+
+  /* The first value is taken as is */
+  phosh_signal_filter_update (filter, 31);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_OK);
+  g_assert_cmpint (count, ==, 1);
+
+  /* Jitter around the boundary doesn't change the level */
+  phosh_signal_filter_update (filter, 29);
+  phosh_signal_filter_update (filter, 26);
+  phosh_signal_filter_update (filter, 32);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_OK);
+  g_assert_cmpint (count, ==, 1);
+
+  /* Moving well past it does */
+  phosh_signal_filter_update (filter, 24);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_WEAK);
+  g_assert_cmpint (count, ==, 2);
+
+  phosh_signal_filter_update (filter, 33);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_WEAK);
+  phosh_signal_filter_update (filter, 95);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_EXCELLENT);
+  g_assert_cmpint (count, ==, 3);
+
+  /* After a reset values are taken as is again */
+  phosh_signal_filter_reset (filter);
+  phosh_signal_filter_update (filter, 78);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_GOOD);
+  g_assert_cmpint (count, ==, 4);
+}
+
+
+static gboolean
+on_timeout (gpointer data)
+{
+  g_main_loop_quit (data);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+test_phosh_signal_filter_rate_limit (void)
+{
+  g_autoptr (PhoshSignalFilter) filter = phosh_signal_filter_new (50);
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  guint count = 0;
+
+  g_signal_connect (filter, "notify::level", G_CALLBACK (on_level_changed), &count);
+
+  phosh_signal_filter_update (filter, 100);
+  g_assert_cmpint (count, ==, 1);
+
+  /* Held back... */
+  phosh_signal_filter_update (filter, 0);
+  phosh_signal_filter_update (filter, 40);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_EXCELLENT);
+  g_assert_cmpint (count, ==, 1);
+
+  /* ...until the interval is over, then the latest value wins */
+  g_timeout_add (200, on_timeout, loop);
+  g_main_loop_run (loop);
+  g_assert_cmpint (phosh_signal_filter_get_level (filter), ==, PHOSH_SIGNAL_LEVEL_OK);
+  g_assert_cmpint (count, ==, 2);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/signal-filter/hysteresis", test_phosh_signal_filter_hysteresis);
+  g_test_add_func ("/phosh/signal-filter/rate-limit", test_phosh_signal_filter_rate_limit);
+
+  return g_test_run ();
+}
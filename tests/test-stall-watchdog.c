@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "stall-watchdog.h"
+
+
+static gboolean
+on_stall (gpointer unused)
+{
+  /* Block the main loop well past the threshold */
+  g_usleep (300 * 1000);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static gboolean
+on_timeout (gpointer data)
+{
+  g_main_loop_quit (data);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+collect_record (const PhoshStallRecord *record, gpointer user_data)
+{
+  GArray *records = user_data;
+  PhoshStallRecord copy = *record;
+
+  g_array_append_val (records, copy);
+}
+
+
+static void
+test_phosh_stall_watchdog_record (void)
+{
+  g_autoptr (PhoshStallWatchdog) watchdog = phosh_stall_watchdog_new (50);
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  g_autoptr (GArray) records = g_array_new (FALSE, FALSE, sizeof (PhoshStallRecord));
+  PhoshStallRecord *record;
+  guint id;
+
+  g_assert_cmpint (phosh_stall_watchdog_get_threshold (watchdog), ==, 50);
+
+  id = g_timeout_add (100, on_stall, NULL);
+  g_source_set_name_by_id (id, "[phosh] test stall");
+  g_timeout_add (700, on_timeout, loop);
+  g_main_loop_run (loop);
+
+  /* Records only stay valid while nothing else is recorded */
+  phosh_stall_watchdog_foreach (watchdog, collect_record, records);
+  g_assert_cmpint (records->len, ==, 1);
+  record = &g_array_index (records, PhoshStallRecord, 0);
+  g_assert_cmpstr (record->source, ==, "[phosh] test stall");
+  g_assert_cmpint (record->duration, >=, 250 * 1000);
+
+  phosh_stall_watchdog_clear (watchdog);
+  g_array_set_size (records, 0);
+  phosh_stall_watchdog_foreach (watchdog, collect_record, records);
+  g_assert_cmpint (records->len, ==, 0);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/stall-watchdog/record", test_phosh_stall_watchdog_record);
+
+  return g_test_run ();
+}
@@ -6,6 +6,7 @@
  * Author: Guido Günther <agx@sigxcpu.org>
  */
 
+#include "display-state.h"
 #include "status-icon.h"
 
 static void
@@ -93,6 +94,55 @@ test_phosh_status_icon_extra_widget (void)
 }
 
 
+static void
+on_notify (GObject *object, GParamSpec *pspec, gpointer data)
+{
+  guint *count = data;
+
+  (*count)++;
+}
+
+
+static void
+test_phosh_status_icon_display_off (void)
+{
+  PhoshDisplayState *state = phosh_display_state_get_default ();
+  GtkWidget *widget;
+  g_autofree char *icon_name = NULL;
+  g_autoptr (GList) children = NULL;
+  GtkImage *image;
+  const char *shown = NULL;
+  guint wakeups, notified = 0;
+
+  widget = phosh_status_icon_new ();
+  phosh_status_icon_set_icon_name (PHOSH_STATUS_ICON (widget), "on-symbolic");
+  children = gtk_container_get_children (GTK_CONTAINER (gtk_bin_get_child (GTK_BIN (widget))));
+  image = GTK_IMAGE (children->data);
+  g_signal_connect (widget, "notify::info", G_CALLBACK (on_notify), &notified);
+
+  wakeups = phosh_display_state_get_avoided_wakeups (state);
+  phosh_display_state_set_display_off (state, TRUE);
+
+  /* Updates are deferred but the getters are current */
+  phosh_status_icon_set_icon_name (PHOSH_STATUS_ICON (widget), "off-symbolic");
+  phosh_status_icon_set_info (PHOSH_STATUS_ICON (widget), "info");
+  icon_name = phosh_status_icon_get_icon_name (PHOSH_STATUS_ICON (widget));
+  g_assert_cmpstr (icon_name, ==, "off-symbolic");
+  g_assert_cmpstr (phosh_status_icon_get_info (PHOSH_STATUS_ICON (widget)), ==, "info");
+  gtk_image_get_icon_name (image, &shown, NULL);
+  g_assert_cmpstr (shown, ==, "on-symbolic");
+  g_assert_cmpint (notified, ==, 0);
+  g_assert_cmpint (phosh_display_state_get_avoided_wakeups (state), ==, wakeups + 2);
+
+  /* One catch up refresh */
+  phosh_display_state_set_display_off (state, FALSE);
+  gtk_image_get_icon_name (image, &shown, NULL);
+  g_assert_cmpstr (shown, ==, "off-symbolic");
+  g_assert_cmpint (notified, ==, 1);
+
+  gtk_widget_destroy (widget);
+}
+
 
 int
 main (int   argc,
@@ -104,6 +154,7 @@ main (int   argc,
   g_test_add_func("/phosh/status-icon/icon-size", test_phosh_status_icon_icon_size);
   g_test_add_func("/phosh/status-icon/icon-name", test_phosh_status_icon_icon_name);
   g_test_add_func("/phosh/status-icon/extra-widget", test_phosh_status_icon_extra_widget);
+  g_test_add_func("/phosh/status-icon/display-off", test_phosh_status_icon_display_off);
 
   return g_test_run();
 }
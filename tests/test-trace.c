@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "trace.h"
+
+
+static void
+collect_names (const PhoshTraceEntry *entry, gpointer user_data)
+{
+  GPtrArray *names = user_data;
+
+  g_ptr_array_add (names, (gpointer) entry->name);
+}
+
+
+static void
+test_phosh_trace_record (void)
+{
+  g_autoptr (GPtrArray) names = g_ptr_array_new ();
+  g_autofree char *report = NULL;
+  gint64 begin;
+
+  phosh_trace_clear ();
+  phosh_trace_init ();
+  g_assert_cmpint (phosh_trace_get_start_time (), >, 0);
+
+  begin = phosh_trace_now ();
+  g_usleep (1000);
+  phosh_trace_mark ("phase", begin, "took %d", 1);
+  phosh_trace_event ("ready", NULL);
+
+  phosh_trace_foreach (collect_names, names);
+  g_assert_cmpint (names->len, ==, 2);
+  g_assert_cmpstr (g_ptr_array_index (names, 0), ==, "phase");
+  g_assert_cmpstr (g_ptr_array_index (names, 1), ==, "ready");
+
+  report = phosh_trace_format_report ();
+  g_assert_nonnull (strstr (report, "phase: took 1"));
+  g_assert_nonnull (strstr (report, "ready"));
+  g_assert_nonnull (strstr (report, "Total: "));
+
+  phosh_trace_clear ();
+  g_assert_cmpint (phosh_trace_get_start_time (), ==, 0);
+}
+
+
+static void
+test_phosh_trace_ring_buffer (void)
+{
+  g_autoptr (GPtrArray) names = g_ptr_array_new ();
+
+  phosh_trace_clear ();
+
+  phosh_trace_event ("oldest", NULL);
+  for (int i = 0; i < PHOSH_TRACE_MAX_ENTRIES - 1; i++)
+    phosh_trace_event ("filler", "%d", i);
+  phosh_trace_event ("newest", NULL);
+
+  /* Oldest entry got dropped */
+  phosh_trace_foreach (collect_names, names);
+  g_assert_cmpint (names->len, ==, PHOSH_TRACE_MAX_ENTRIES);
+  g_assert_cmpstr (g_ptr_array_index (names, 0), ==, "filler");
+  g_assert_cmpstr (g_ptr_array_index (names, names->len - 1), ==, "newest");
+
+  phosh_trace_clear ();
+}
+
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/trace/record", test_phosh_trace_record);
+  g_test_add_func ("/phosh/trace/ring-buffer", test_phosh_trace_ring_buffer);
+
+  return g_test_run ();
+}
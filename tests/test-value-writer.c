@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "value-writer.h"
+
+
+typedef struct {
+  GArray *written;
+} Fixture;
+
+
+static void
+write_value (PhoshValueWriter *writer, double value, gpointer data)
+{
+  Fixture *fixture = data;
+
+  g_array_append_val (fixture->written, value);
+}
+
+
+static void
+test_phosh_value_writer_latest_wins (void)
+{
+  Fixture fixture = { .written = g_array_new (FALSE, FALSE, sizeof (double)) };
+  g_autoptr (PhoshValueWriter) writer = phosh_value_writer_new (write_value, &fixture, 0);
+
+  g_assert_false (phosh_value_writer_is_busy (writer));
+
+  /* First value is written right away */
+  phosh_value_writer_set (writer, 1.0);
+  g_assert_cmpint (fixture.written->len, ==, 1);
+  g_assert_true (phosh_value_writer_is_busy (writer));
+
+  /* Others wait for the in flight write */
+  phosh_value_writer_set (writer, 2.0);
+  phosh_value_writer_set (writer, 3.0);
+  g_assert_cmpint (fixture.written->len, ==, 1);
+
+  /* Only the latest one gets written */
+  phosh_value_writer_done (writer);
+  g_assert_cmpint (fixture.written->len, ==, 2);
+  g_assert_cmpfloat (g_array_index (fixture.written, double, 1), ==, 3.0);
+
+  phosh_value_writer_done (writer);
+  g_assert_false (phosh_value_writer_is_busy (writer));
+  g_assert_cmpint (fixture.written->len, ==, 2);
+
+  g_array_free (fixture.written, TRUE);
+}
+
+
+static void
+test_phosh_value_writer_flush (void)
+{
+  Fixture fixture = { .written = g_array_new (FALSE, FALSE, sizeof (double)) };
+  g_autoptr (PhoshValueWriter) writer = phosh_value_writer_new (write_value, &fixture, 0);
+
+  phosh_value_writer_set (writer, 1.0);
+  phosh_value_writer_set (writer, 2.0);
+  g_assert_cmpint (fixture.written->len, ==, 1);
+
+  /* Never two writes in flight */
+  phosh_value_writer_flush (writer);
+  g_assert_cmpint (fixture.written->len, ==, 1);
+  g_assert_true (phosh_value_writer_is_busy (writer));
+
+  phosh_value_writer_done (writer);
+  g_assert_cmpint (fixture.written->len, ==, 2);
+  g_assert_cmpfloat (g_array_index (fixture.written, double, 1), ==, 2.0);
+
+  /* Nothing left to flush */
+  phosh_value_writer_done (writer);
+  phosh_value_writer_flush (writer);
+  g_assert_cmpint (fixture.written->len, ==, 2);
+  g_assert_false (phosh_value_writer_is_busy (writer));
+
+  g_array_free (fixture.written, TRUE);
+}
+
+
+static gboolean
+on_timeout (gpointer data)
+{
+  g_main_loop_quit (data);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+test_phosh_value_writer_timeout (void)
+{
+  Fixture fixture = { .written = g_array_new (FALSE, FALSE, sizeof (double)) };
+  g_autoptr (PhoshValueWriter) writer = phosh_value_writer_new (write_value, &fixture, 20);
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+  phosh_value_writer_set (writer, 1.0);
+  phosh_value_writer_set (writer, 2.0);
+  g_assert_cmpint (fixture.written->len, ==, 1);
+
+  /* Unacknowledged writes are considered done after the timeout */
+  g_timeout_add (200, on_timeout, loop);
+  g_main_loop_run (loop);
+  g_assert_cmpint (fixture.written->len, ==, 2);
+  g_assert_cmpfloat (g_array_index (fixture.written, double, 1), ==, 2.0);
+  g_assert_false (phosh_value_writer_is_busy (writer));
+
+  g_array_free (fixture.written, TRUE);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/value-writer/latest-wins", test_phosh_value_writer_latest_wins);
+  g_test_add_func ("/phosh/value-writer/flush", test_phosh_value_writer_flush);
+  g_test_add_func ("/phosh/value-writer/timeout", test_phosh_value_writer_timeout);
+
+  return g_test_run ();
+}
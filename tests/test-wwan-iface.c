@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "wwan/phosh-wwan-iface.h"
+#include "phosh-enums.h"
+
+/* A minimal modem whose state is set directly by the test */
+
+enum {
+  PROP_0,
+  PROP_SIGNAL_QUALITY,
+  PROP_ACCESS_TEC,
+  PROP_UNLOCKED,
+  PROP_SIM,
+  PROP_PRESENT,
+  PROP_OPERATOR,
+  PROP_LAST_PROP,
+};
+
+#define PHOSH_TYPE_TEST_WWAN (phosh_test_wwan_get_type ())
+G_DECLARE_FINAL_TYPE (PhoshTestWWan, phosh_test_wwan, PHOSH, TEST_WWAN, GObject)
+
+struct _PhoshTestWWan {
+  GObject     parent;
+
+  guint       signal_quality;
+  const char *access_tec;
+  gboolean    unlocked;
+  gboolean    sim;
+  gboolean    present;
+  char       *operator;
+};
+
+static void phosh_test_wwan_interface_init (PhoshWWanInterface *iface);
+G_DEFINE_TYPE_WITH_CODE (PhoshTestWWan, phosh_test_wwan, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (PHOSH_TYPE_WWAN,
+                                                phosh_test_wwan_interface_init))
+
+
+static void
+phosh_test_wwan_get_property (GObject    *object,
+                              guint       property_id,
+                              GValue     *value,
+                              GParamSpec *pspec)
+{
+  PhoshTestWWan *self = PHOSH_TEST_WWAN (object);
+
+  switch (property_id) {
+  case PROP_SIGNAL_QUALITY:
+    g_value_set_int (value, self->signal_quality);
+    break;
+  case PROP_ACCESS_TEC:
+    g_value_set_string (value, self->access_tec);
+    break;
+  case PROP_UNLOCKED:
+    g_value_set_boolean (value, self->unlocked);
+    break;
+  case PROP_SIM:
+    g_value_set_boolean (value, self->sim);
+    break;
+  case PROP_PRESENT:
+    g_value_set_boolean (value, self->present);
+    break;
+  case PROP_OPERATOR:
+    g_value_set_string (value, self->operator);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+    break;
+  }
+}
+
+
+static void
+phosh_test_wwan_finalize (GObject *object)
+{
+  PhoshTestWWan *self = PHOSH_TEST_WWAN (object);
+
+  g_free (self->operator);
+
+  G_OBJECT_CLASS (phosh_test_wwan_parent_class)->finalize (object);
+}
+
+
+static guint
+phosh_test_wwan_get_signal_quality (PhoshWWan *wwan)
+{
+  return PHOSH_TEST_WWAN (wwan)->signal_quality;
+}
+
+
+static const char *
+phosh_test_wwan_get_access_tec (PhoshWWan *wwan)
+{
+  return PHOSH_TEST_WWAN (wwan)->access_tec;
+}
+
+
+static gboolean
+phosh_test_wwan_is_unlocked (PhoshWWan *wwan)
+{
+  return PHOSH_TEST_WWAN (wwan)->unlocked;
+}
+
+
+static gboolean
+phosh_test_wwan_has_sim (PhoshWWan *wwan)
+{
+  return PHOSH_TEST_WWAN (wwan)->sim;
+}
+
+
+static gboolean
+phosh_test_wwan_is_present (PhoshWWan *wwan)
+{
+  return PHOSH_TEST_WWAN (wwan)->present;
+}
+
+
+static const char *
+phosh_test_wwan_get_operator (PhoshWWan *wwan)
+{
+  return PHOSH_TEST_WWAN (wwan)->operator;
+}
+
+
+static void
+phosh_test_wwan_interface_init (PhoshWWanInterface *iface)
+{
+  iface->get_signal_quality = phosh_test_wwan_get_signal_quality;
+  iface->get_access_tec = phosh_test_wwan_get_access_tec;
+  iface->is_unlocked = phosh_test_wwan_is_unlocked;
+  iface->has_sim = phosh_test_wwan_has_sim;
+  iface->is_present = phosh_test_wwan_is_present;
+  iface->get_operator = phosh_test_wwan_get_operator;
+}
+
+
+static void
+phosh_test_wwan_class_init (PhoshTestWWanClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->get_property = phosh_test_wwan_get_property;
+  object_class->finalize = phosh_test_wwan_finalize;
+
+  g_object_class_override_property (object_class, PROP_SIGNAL_QUALITY, "signal-quality");
+  g_object_class_override_property (object_class, PROP_ACCESS_TEC, "access-tec");
+  g_object_class_override_property (object_class, PROP_UNLOCKED, "unlocked");
+  g_object_class_override_property (object_class, PROP_SIM, "sim");
+  g_object_class_override_property (object_class, PROP_PRESENT, "present");
+  g_object_class_override_property (object_class, PROP_OPERATOR, "operator");
+}
+
+
+static void
+phosh_test_wwan_init (PhoshTestWWan *self)
+{
+}
+
+
+typedef struct {
+  guint            count;
+  PhoshWWanChanged changed;
+  guint            notifies;
+} ChangedData;
+
+
+static void
+on_changed (PhoshWWan *wwan, PhoshWWanChanged changed, ChangedData *data)
+{
+  data->count++;
+  data->changed = changed;
+}
+
+
+static void
+on_notify (PhoshWWan *wwan, GParamSpec *pspec, ChangedData *data)
+{
+  data->notifies++;
+}
+
+
+static void
+drain (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+
+static void
+test_phosh_wwan_iface_coalesce (void)
+{
+  g_autoptr (PhoshTestWWan) wwan = g_object_new (PHOSH_TYPE_TEST_WWAN, NULL);
+  ChangedData data = { 0 };
+
+  g_signal_connect (wwan, "changed", G_CALLBACK (on_changed), &data);
+  g_signal_connect (wwan, "notify", G_CALLBACK (on_notify), &data);
+
+  /* Nothing differs from the initial state */
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  drain ();
+  g_assert_cmpint (data.count, ==, 0);
+  g_assert_cmpint (data.notifies, ==, 0);
+
+  /* Several changes in one main loop iteration are published at once */
+  wwan->present = TRUE;
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  wwan->sim = TRUE;
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  wwan->signal_quality = 60;
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  wwan->operator = g_strdup ("Test Operator");
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  g_assert_cmpint (data.count, ==, 0);
+  drain ();
+
+  g_assert_cmpint (data.count, ==, 1);
+  g_assert_cmpint (data.changed, ==,
+                   PHOSH_WWAN_CHANGED_PRESENT |
+                   PHOSH_WWAN_CHANGED_SIM |
+                   PHOSH_WWAN_CHANGED_SIGNAL_QUALITY |
+                   PHOSH_WWAN_CHANGED_SIGNAL_LEVEL |
+                   PHOSH_WWAN_CHANGED_OPERATOR);
+  g_assert_cmpint (data.notifies, ==, 4);
+  g_assert_cmpint (phosh_wwan_get_signal_level (PHOSH_WWAN (wwan)), !=, PHOSH_SIGNAL_LEVEL_NONE);
+
+  /* Changes that are reverted before the update aren't published */
+  wwan->unlocked = TRUE;
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  wwan->unlocked = FALSE;
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  drain ();
+  g_assert_cmpint (data.count, ==, 1);
+
+  wwan->access_tec = "LTE";
+  phosh_wwan_queue_update (PHOSH_WWAN (wwan));
+  drain ();
+  g_assert_cmpint (data.count, ==, 2);
+  g_assert_cmpint (data.changed, ==, PHOSH_WWAN_CHANGED_ACCESS_TEC);
+}
+
+
+static void
+test_phosh_wwan_iface_flags_type (void)
+{
+  GFlagsClass *klass;
+  gpointer iface;
+  GSignalQuery query;
+
+  g_assert_true (G_TYPE_IS_FLAGS (PHOSH_TYPE_WWAN_CHANGED));
+  klass = g_type_class_ref (PHOSH_TYPE_WWAN_CHANGED);
+  g_assert_nonnull (g_flags_get_first_value (klass, PHOSH_WWAN_CHANGED_OPERATOR));
+  g_type_class_unref (klass);
+
+  iface = g_type_default_interface_ref (PHOSH_TYPE_WWAN);
+  g_signal_query (g_signal_lookup ("changed", PHOSH_TYPE_WWAN), &query);
+  g_assert_cmpint (query.n_params, ==, 1);
+  g_assert_true (query.param_types[0] == PHOSH_TYPE_WWAN_CHANGED);
+  g_type_default_interface_unref (iface);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/phosh/wwan-iface/coalesce", test_phosh_wwan_iface_coalesce);
+  g_test_add_func ("/phosh/wwan-iface/flags-type", test_phosh_wwan_iface_flags_type);
+
+  return g_test_run ();
+}
@@ -172,6 +172,9 @@ phosh_test_compositor_new (void)
   state->gdk_display = gdk_display_open (watch.socket);
   g_free (watch.socket);
   state->wl = phosh_wayland_get_default ();
+  /* Globals get bound asynchronously */
+  phosh_wayland_roundtrip (state->wl);
+  g_assert_true (phosh_wayland_is_ready (state->wl));
 
   /* Get us the first output just so it's simpler to use */
   outputs = phosh_wayland_get_wl_outputs (state->wl);
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2026 Purism SPC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * Benchmark the org.freedesktop.Notifications path of a standalone
+ * PhoshNotifyManager on a private session bus.
+ *
+ * Measures the latency from sending Notify until the notification
+ * shows up in the PhoshNotificationList (or, for replacements, until
+ * the existing notification got updated), the throughput and the peak
+ * RSS of the process.
+ */
+
+#include <notifications/notify-manager.h>
+
+#include <gio/gio.h>
+
+#include <sys/resource.h>
+
+#define NOTIFY_DBUS_NAME  "org.freedesktop.Notifications"
+#define NOTIFY_DBUS_PATH  "/org/freedesktop/Notifications"
+#define SUMMARY_PREFIX    "bench "
+
+typedef enum {
+  BENCH_KIND_PLAIN,
+  BENCH_KIND_IMAGE,
+  BENCH_KIND_REPLACE,
+  BENCH_KIND_ACTIONS,
+  BENCH_N_KINDS,
+} BenchKind;
+
+static const char *kind_names[BENCH_N_KINDS] = { "plain", "image", "replace", "actions" };
+
+static int count = 1000;
+static int in_flight_max = 16;
+static int weights[BENCH_N_KINDS] = { 4, 2, 2, 2 };
+static char *image_sizes_str = NULL;
+static guint seed = 42;
+
+static GOptionEntry entries[] = {
+  { "count", 'n', 0, G_OPTION_ARG_INT, &count, "Number of notifications to send", "N" },
+  { "in-flight", 'j', 0, G_OPTION_ARG_INT, &in_flight_max, "Maximum outstanding Notify calls", "N" },
+  { "plain", 0, 0, G_OPTION_ARG_INT, &weights[BENCH_KIND_PLAIN], "Weight of plain notifications", "W" },
+  { "image", 0, 0, G_OPTION_ARG_INT, &weights[BENCH_KIND_IMAGE], "Weight of notifications with image-data", "W" },
+  { "replace", 0, 0, G_OPTION_ARG_INT, &weights[BENCH_KIND_REPLACE], "Weight of notifications replacing an earlier one", "W" },
+  { "actions", 0, 0, G_OPTION_ARG_INT, &weights[BENCH_KIND_ACTIONS], "Weight of notifications with actions", "W" },
+  { "image-sizes", 0, 0, G_OPTION_ARG_STRING, &image_sizes_str, "Comma separated edge lengths of image-data (default: 48,256,1024)", "SIZES" },
+  { "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Seed for the notification mix", "SEED" },
+  { NULL }
+};
+
+
+typedef struct {
+  GMainLoop        *loop;
+  GDBusConnection  *client;
+  GRand            *rand;
+
+  GPtrArray        *images;          /* pre-built image-data variants */
+  GArray           *ids;             /* ids returned by Notify */
+  GHashTable       *pending;         /* seq -> start time (µs) */
+  GArray           *latencies[BENCH_N_KINDS];
+
+  int               sent;
+  int               completed;
+  int               in_flight;
+  gint64            start;
+  gint64            end;
+} NotifyBench;
+
+
+typedef struct {
+  BenchKind kind;
+  gint64    start;
+} PendingNotify;
+
+
+static GVariant *
+build_image_data (int size)
+{
+  int rowstride = size * 4;
+  gsize len = (gsize) rowstride * size;
+  g_autofree guchar *data = g_malloc (len);
+
+  for (gsize i = 0; i < len; i++)
+    data[i] = i & 0xff;
+
+  return g_variant_ref_sink (
+    g_variant_new ("(iiibii@ay)", size, size, rowstride, TRUE, 8, 4,
+                   g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, data, len, 1)));
+}
+
+
+static BenchKind
+pick_kind (NotifyBench *bench)
+{
+  int total = 0;
+  int r;
+
+  for (int i = 0; i < BENCH_N_KINDS; i++)
+    total += weights[i];
+
+  r = g_rand_int_range (bench->rand, 0, total);
+  for (int i = 0; i < BENCH_N_KINDS; i++) {
+    if (r < weights[i])
+      return i;
+    r -= weights[i];
+  }
+
+  g_assert_not_reached ();
+}
+
+
+static void
+record_arrival (NotifyBench *bench, PhoshNotification *notification)
+{
+  const char *summary = phosh_notification_get_summary (notification);
+  PendingNotify *pending;
+  double latency;
+  guint seq;
+
+  if (!g_str_has_prefix (summary, SUMMARY_PREFIX))
+    return;
+
+  seq = g_ascii_strtoull (summary + strlen (SUMMARY_PREFIX), NULL, 10);
+  pending = g_hash_table_lookup (bench->pending, GUINT_TO_POINTER (seq));
+  if (pending == NULL)
+    return;
+
+  latency = (g_get_monotonic_time () - pending->start) / 1000.0;
+  g_array_append_val (bench->latencies[pending->kind], latency);
+  g_hash_table_remove (bench->pending, GUINT_TO_POINTER (seq));
+}
+
+
+static void
+on_summary_changed (PhoshNotification *notification, GParamSpec *pspec, NotifyBench *bench)
+{
+  record_arrival (bench, notification);
+}
+
+
+static void
+on_new_notification (NotifyBench *bench, PhoshNotification *notification)
+{
+  record_arrival (bench, notification);
+  /* Replacements don't add to the list, they update the notification in place */
+  g_signal_connect (notification, "notify::summary", G_CALLBACK (on_summary_changed), bench);
+}
+
+
+static void send_more (NotifyBench *bench);
+
+
+static void
+on_notify_finished (GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  NotifyBench *bench = user_data;
+  g_autoptr (GVariant) ret = NULL;
+  g_autoptr (GError) err = NULL;
+  guint id;
+
+  ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), res, &err);
+  if (ret == NULL)
+    g_error ("Notify failed: %s", err->message);
+
+  g_variant_get (ret, "(u)", &id);
+  g_array_append_val (bench->ids, id);
+
+  bench->in_flight--;
+  bench->completed++;
+
+  if (bench->completed == count) {
+    bench->end = g_get_monotonic_time ();
+    g_main_loop_quit (bench->loop);
+    return;
+  }
+
+  send_more (bench);
+}
+
+
+static void
+send_one (NotifyBench *bench)
+{
+  g_auto (GVariantBuilder) hints = G_VARIANT_BUILDER_INIT (G_VARIANT_TYPE_VARDICT);
+  const char *const no_actions[] = { NULL };
+  const char *const actions[] = { "default", "Open", "reply", "Reply", "dismiss", "Dismiss", NULL };
+  const char *const *acts = no_actions;
+  g_autofree char *summary = NULL;
+  PendingNotify *pending;
+  guint replaces_id = 0;
+  BenchKind kind;
+  guint seq;
+
+  seq = bench->sent++;
+  kind = pick_kind (bench);
+
+  switch (kind) {
+  case BENCH_KIND_IMAGE:
+    g_variant_builder_add (&hints, "{sv}", "image-data",
+                           g_ptr_array_index (bench->images, seq % bench->images->len));
+    break;
+  case BENCH_KIND_REPLACE:
+    if (bench->ids->len)
+      replaces_id = g_array_index (bench->ids, guint, g_rand_int_range (bench->rand, 0, bench->ids->len));
+    else
+      kind = BENCH_KIND_PLAIN;
+    break;
+  case BENCH_KIND_ACTIONS:
+    acts = actions;
+    break;
+  case BENCH_KIND_PLAIN:
+  case BENCH_N_KINDS:
+  default:
+    break;
+  }
+  g_variant_builder_add (&hints, "{sv}", "desktop-entry", g_variant_new_string ("notify-bench"));
+
+  pending = g_new0 (PendingNotify, 1);
+  pending->kind = kind;
+  pending->start = g_get_monotonic_time ();
+  g_hash_table_insert (bench->pending, GUINT_TO_POINTER (seq), pending);
+
+  summary = g_strdup_printf (SUMMARY_PREFIX "%u", seq);
+  g_dbus_connection_call (bench->client,
+                          NOTIFY_DBUS_NAME,
+                          NOTIFY_DBUS_PATH,
+                          NOTIFY_DBUS_NAME,
+                          "Notify",
+                          g_variant_new ("(susss^as@a{sv}i)",
+                                         "notify-bench",
+                                         replaces_id,
+                                         "dialog-information",
+                                         summary,
+                                         "Lorem ipsum dolor sit amet, <b>consectetur</b> adipiscing elit",
+                                         acts,
+                                         g_variant_builder_end (&hints),
+                                         0),
+                          G_VARIANT_TYPE ("(u)"),
+                          G_DBUS_CALL_FLAGS_NONE,
+                          -1,
+                          NULL,
+                          on_notify_finished,
+                          bench);
+  bench->in_flight++;
+}
+
+
+static void
+send_more (NotifyBench *bench)
+{
+  while (bench->in_flight < in_flight_max && bench->sent < count)
+    send_one (bench);
+}
+
+
+static void
+on_name_appeared (GDBusConnection *connection,
+                  const char      *name,
+                  const char      *name_owner,
+                  gpointer         user_data)
+{
+  NotifyBench *bench = user_data;
+
+  if (bench->start)
+    return;
+
+  g_debug ("%s appeared, starting benchmark", name);
+  bench->start = g_get_monotonic_time ();
+  send_more (bench);
+}
+
+
+static int
+cmp_double (gconstpointer a, gconstpointer b)
+{
+  double da = *(const double *)a;
+  double db = *(const double *)b;
+
+  return (da > db) - (da < db);
+}
+
+
+static void
+print_latencies (const char *name, GArray *latencies)
+{
+  double p50, p99;
+
+  if (latencies->len == 0)
+    return;
+
+  g_array_sort (latencies, cmp_double);
+  p50 = g_array_index (latencies, double, (latencies->len - 1) * 50 / 100);
+  p99 = g_array_index (latencies, double, (latencies->len - 1) * 99 / 100);
+
+  g_print ("%-8s %8u %10.3f %10.3f\n", name, latencies->len, p50, p99);
+}
+
+
+int
+main (int argc, char **argv)
+{
+  g_autoptr (GOptionContext) opt_context = NULL;
+  g_autoptr (GError) err = NULL;
+  g_autoptr (GTestDBus) bus = NULL;
+  g_autoptr (GArray) all = NULL;
+  g_auto (GStrv) sizes = NULL;
+  g_autofree char *address = NULL;
+  PhoshNotifyManager *manager;
+  NotifyBench bench = { 0 };
+  struct rusage usage;
+  double elapsed;
+  guint watch_id;
+
+  opt_context = g_option_context_new ("- benchmark the notification server");
+  g_option_context_add_main_entries (opt_context, entries, NULL);
+  if (!g_option_context_parse (opt_context, &argc, &argv, &err)) {
+    g_warning ("%s", err->message);
+    return 1;
+  }
+
+  if (count <= 0 || in_flight_max <= 0 ||
+      weights[BENCH_KIND_PLAIN] + weights[BENCH_KIND_IMAGE] +
+      weights[BENCH_KIND_REPLACE] + weights[BENCH_KIND_ACTIONS] <= 0) {
+    g_warning ("Nothing to do");
+    return 1;
+  }
+
+  /* Keep the user's notification settings untouched */
+  g_setenv ("GSETTINGS_BACKEND", "memory", TRUE);
+
+  bus = g_test_dbus_new (G_TEST_DBUS_NONE);
+  g_test_dbus_up (bus);
+
+  bench.loop = g_main_loop_new (NULL, FALSE);
+  bench.rand = g_rand_new_with_seed (seed);
+  bench.ids = g_array_new (FALSE, FALSE, sizeof (guint));
+  bench.pending = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  for (int i = 0; i < BENCH_N_KINDS; i++)
+    bench.latencies[i] = g_array_new (FALSE, FALSE, sizeof (double));
+
+  bench.images = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_unref);
+  sizes = g_strsplit (image_sizes_str ?: "48,256,1024", ",", -1);
+  for (int i = 0; sizes[i]; i++) {
+    int size = g_ascii_strtoll (sizes[i], NULL, 10);
+
+    if (size > 0)
+      g_ptr_array_add (bench.images, build_image_data (size));
+  }
+  if (bench.images->len == 0)
+    g_ptr_array_add (bench.images, build_image_data (48));
+
+  /* Use a separate connection so messages really go through the bus */
+  address = g_dbus_address_get_for_bus_sync (G_BUS_TYPE_SESSION, NULL, &err);
+  if (address)
+    bench.client = g_dbus_connection_new_for_address_sync (
+      address,
+      G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+      G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+      NULL, NULL, &err);
+  if (bench.client == NULL)
+    g_error ("Failed to connect to session bus: %s", err->message);
+
+  manager = phosh_notify_manager_get_default ();
+  g_signal_connect_swapped (manager, "new-notification", G_CALLBACK (on_new_notification), &bench);
+
+  watch_id = g_bus_watch_name_on_connection (bench.client,
+                                             NOTIFY_DBUS_NAME,
+                                             G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                             on_name_appeared,
+                                             NULL,
+                                             &bench,
+                                             NULL);
+  g_main_loop_run (bench.loop);
+  g_bus_unwatch_name (watch_id);
+
+  /* Let the last list insertions come in */
+  while (g_hash_table_size (bench.pending) && g_main_context_iteration (NULL, FALSE))
+    ;
+
+  elapsed = (bench.end - bench.start) / (double) G_USEC_PER_SEC;
+  getrusage (RUSAGE_SELF, &usage);
+
+  g_print ("%-8s %8s %10s %10s\n", "kind", "count", "p50 (ms)", "p99 (ms)");
+  all = g_array_new (FALSE, FALSE, sizeof (double));
+  for (int i = 0; i < BENCH_N_KINDS; i++) {
+    print_latencies (kind_names[i], bench.latencies[i]);
+    g_array_append_vals (all, bench.latencies[i]->data, bench.latencies[i]->len);
+  }
+  print_latencies ("all", all);
+
+  g_print ("\n");
+  g_print ("notifications: %d in %.3f s, %.1f/s\n", count, elapsed, count / elapsed);
+  g_print ("unmatched:     %u\n", g_hash_table_size (bench.pending));
+  g_print ("peak RSS:      %ld KiB\n", usage.ru_maxrss);
+
+  g_object_unref (manager);
+  g_dbus_connection_close_sync (bench.client, NULL, NULL);
+  g_clear_object (&bench.client);
+  for (int i = 0; i < BENCH_N_KINDS; i++)
+    g_array_unref (bench.latencies[i]);
+  g_ptr_array_unref (bench.images);
+  g_hash_table_unref (bench.pending);
+  g_array_unref (bench.ids);
+  g_rand_free (bench.rand);
+  g_main_loop_unref (bench.loop);
+
+  g_test_dbus_down (bus);
+
+  return 0;
+}